@@ -238,11 +238,9 @@ void BlobBuilder::append(ExecutionContext& context, JSValue& value) {
       auto blob = static_cast<BlobInstance*>(JS_GetOpaque(value, Blob::kBlobClassID));
       if (blob == nullptr)
         return;
-      if (std::string(blob->m_name) == "Blob") {
-        std::vector<uint8_t> blobData = blob->_data;
-        _data.reserve(_data.size() + blobData.size());
-        _data.insert(_data.end(), blobData.begin(), blobData.end());
-      }
+      std::vector<uint8_t> blobData = blob->_data;
+      _data.reserve(_data.size() + blobData.size());
+      _data.insert(_data.end(), blobData.begin(), blobData.end());
     } else {
       size_t length;
       uint8_t* buffer = JS_GetArrayBuffer(context.ctx(), &length, value);
@@ -4,6 +4,9 @@
  */
 
 #include "dom_timer_coordinator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include "dart_methods.h"
 #include "timer.h"
 
@@ -13,38 +16,48 @@
 
 namespace kraken::binding::qjs {
 
-static void handleTimerCallback(DOMTimer* timer, const char* errmsg) {
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(timer->ctx()));
+// Timers nested deeper than this are clamped to kMinimumTimeout.
+// https://html.spec.whatwg.org/multipage/timers-and-user-prompts.html#timer-initialisation-steps
+static const int32_t kMaxTimerNestingLevel = 5;
+static const int32_t kMinimumTimeout = 4;
 
-  if (errmsg != nullptr) {
-    JSValue exception = JS_ThrowTypeError(timer->ctx(), "%s", errmsg);
-    context->handleException(&exception);
-    return;
-  }
-
-  // Trigger timer callbacks.
-  timer->fire();
-
-  // Executing pending async jobs.
-  context->drainPendingPromiseJobs();
+static double currentTime() {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
-static void handleTransientCallback(void* ptr, int32_t contextId, const char* errmsg) {
-  auto* timer = static_cast<DOMTimer*>(ptr);
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(timer->ctx()));
+static void handleWakeupCallback(void* ptr, int32_t contextId, const char* errmsg) {
+  auto* context = static_cast<ExecutionContext*>(ptr);
 
   if (!checkPage(contextId, context))
     return;
   if (!context->isValid())
     return;
 
-  handleTimerCallback(timer, errmsg);
+  if (errmsg != nullptr) {
+    JSValue exception = JS_ThrowTypeError(context->ctx(), "%s", errmsg);
+    context->handleException(&exception);
+    return;
+  }
+
+  EventLoopScheduler::TaskScope scope(context, TaskLane::normal);
+  context->timers()->fireDueTimers(context);
+}
 
-  context->timers()->removeTimeoutById(timer->timerId());
+bool DOMTimerCoordinator::firesAfter(const ScheduledTimer& left, const ScheduledTimer& right) {
+  if (left.deadline != right.deadline)
+    return left.deadline > right.deadline;
+  return left.sequence > right.sequence;
 }
 
-void DOMTimerCoordinator::installNewTimer(ExecutionContext* context, int32_t timerId, DOMTimer* timer) {
+int32_t DOMTimerCoordinator::installNewTimer(ExecutionContext* context, DOMTimer* timer, int32_t timeout) {
+  int32_t timerId = m_nextTimerId++;
+  timer->setTimerId(timerId);
+  timer->setNestingLevel(m_nestingLevel + 1);
+  timer->setTimeout(timeout);
   m_activeTimers[timerId] = timer;
+  schedule(timer);
+  armWakeup(context);
+  return timerId;
 }
 
 void* DOMTimerCoordinator::removeTimeoutById(int32_t timerId) {
@@ -56,6 +69,13 @@ void* DOMTimerCoordinator::removeTimeoutById(int32_t timerId) {
   m_abandonedTimers.emplace_back(timer);
 
   m_activeTimers.erase(timerId);
+
+  // Debounced timers are cleared long before their deadlines, drop them once they make up most of the heap.
+  if (m_timerHeap.size() > m_activeTimers.size() * 2 + 64) {
+    m_timerHeap.erase(std::remove_if(m_timerHeap.begin(), m_timerHeap.end(), [this](const ScheduledTimer& scheduled) { return m_activeTimers.count(scheduled.timerId) == 0; }),
+                      m_timerHeap.end());
+    std::make_heap(m_timerHeap.begin(), m_timerHeap.end(), firesAfter);
+  }
   return nullptr;
 }
 
@@ -65,6 +85,101 @@ DOMTimer* DOMTimerCoordinator::getTimerById(int32_t timerId) {
   return m_activeTimers[timerId];
 }
 
+void DOMTimerCoordinator::schedule(DOMTimer* timer) {
+  int32_t timeout = std::max(timer->timeout(), 0);
+  if (timer->nestingLevel() > kMaxTimerNestingLevel && timeout < kMinimumTimeout) {
+    timeout = kMinimumTimeout;
+  }
+
+  m_timerHeap.push_back({currentTime() + timeout, m_sequence++, timer->timerId()});
+  std::push_heap(m_timerHeap.begin(), m_timerHeap.end(), firesAfter);
+}
+
+void DOMTimerCoordinator::armWakeup(ExecutionContext* context) {
+  if (context->isFrozen())
+    return;
+
+  while (!m_timerHeap.empty() && m_activeTimers.count(m_timerHeap.front().timerId) == 0) {
+    std::pop_heap(m_timerHeap.begin(), m_timerHeap.end(), firesAfter);
+    m_timerHeap.pop_back();
+  }
+
+  if (m_timerHeap.empty()) {
+    if (m_wakeupId != -1) {
+      getDartMethod()->clearTimeout(context->getContextId(), m_wakeupId);
+      m_wakeupId = -1;
+    }
+    return;
+  }
+
+  double deadline = m_timerHeap.front().deadline;
+  if (m_wakeupId != -1) {
+    // The armed wakeup comes first, it arms the next one when it fires.
+    if (m_wakeupDeadline <= deadline)
+      return;
+    getDartMethod()->clearTimeout(context->getContextId(), m_wakeupId);
+  }
+
+  // Round up so the wakeup never comes before the deadline.
+  auto delay = static_cast<int32_t>(std::max(std::ceil(deadline - currentTime()), 0.0));
+  m_wakeupId = getDartMethod()->setTimeout(context, context->getContextId(), handleWakeupCallback, delay);
+  m_wakeupDeadline = deadline;
+}
+
+void DOMTimerCoordinator::fireDueTimers(ExecutionContext* context) {
+  m_wakeupId = -1;
+  double now = currentTime();
+  // Timers scheduled by the callbacks below wait for the next wakeup, even when their deadlines are already reached.
+  uint64_t sequenceLimit = m_sequence;
+
+  while (!m_timerHeap.empty()) {
+    ScheduledTimer scheduled = m_timerHeap.front();
+    if (scheduled.deadline > now || scheduled.sequence >= sequenceLimit)
+      break;
+    // The timers left are due at once, the next wakeup comes right after dart handled its pending work.
+    if (context->scheduler()->shouldYield())
+      break;
+    std::pop_heap(m_timerHeap.begin(), m_timerHeap.end(), firesAfter);
+    m_timerHeap.pop_back();
+
+    DOMTimer* timer = getTimerById(scheduled.timerId);
+    if (timer == nullptr)
+      continue;
+
+    // Trigger timer callbacks.
+    m_nestingLevel = timer->nestingLevel();
+    timer->fire();
+    m_nestingLevel = 0;
+
+    // Executing pending async jobs, each timer is a task of its own.
+    context->drainPendingPromiseJobs();
+
+    // The callback may have cleared its own timer.
+    if (getTimerById(scheduled.timerId) != timer)
+      continue;
+
+    if (timer->isInterval()) {
+      timer->setNestingLevel(timer->nestingLevel() + 1);
+      schedule(timer);
+    } else {
+      removeTimeoutById(scheduled.timerId);
+    }
+  }
+
+  armWakeup(context);
+}
+
+void DOMTimerCoordinator::freeze(ExecutionContext* context) {
+  if (m_wakeupId == -1)
+    return;
+  getDartMethod()->clearTimeout(context->getContextId(), m_wakeupId);
+  m_wakeupId = -1;
+}
+
+void DOMTimerCoordinator::resume(ExecutionContext* context) {
+  armWakeup(context);
+}
+
 void DOMTimerCoordinator::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
   for (auto& timer : m_activeTimers) {
     JS_MarkValue(rt, timer.second->toQuickJS(), mark_func);
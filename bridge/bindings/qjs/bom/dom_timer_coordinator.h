@@ -20,21 +20,54 @@ class DOMTimer;
 // the ones returned to web authors from setTimeout or setInterval. It
 // also tracks recursive creation or iterative scheduling of timers,
 // which is used as a signal for throttling repetitive timers.
+//
+// Deadlines of all timers are kept in one min-heap, and dart is only asked
+// to wake up the page once, at the earliest deadline. Every due timer is
+// fired by that single wakeup.
 class DOMTimerCoordinator {
  public:
   // Creates and installs a new timer. Returns the assigned ID.
-  void installNewTimer(ExecutionContext* context, int32_t timerId, DOMTimer* timer);
+  int32_t installNewTimer(ExecutionContext* context, DOMTimer* timer, int32_t timeout);
 
   // Removes and disposes the timer with the specified ID, if any. This may
   // destroy the timer.
   void* removeTimeoutById(int32_t timerId);
   DOMTimer* getTimerById(int32_t timerId);
 
+  // Fire the timers which are due in order of their deadlines, and arm the
+  // wakeup for the next one.
+  void fireDueTimers(ExecutionContext* context);
+
+  // Frozen pages have no wakeup armed, timers past their deadlines fire at the first wakeup after resuming.
+  void freeze(ExecutionContext* context);
+  void resume(ExecutionContext* context);
+
   void trace(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func);
 
  private:
+  struct ScheduledTimer {
+    double deadline;
+    // Timers with the same deadline fire in the order they were scheduled.
+    uint64_t sequence;
+    int32_t timerId;
+  };
+
+  static bool firesAfter(const ScheduledTimer& left, const ScheduledTimer& right);
+  // Push the next deadline of timer to the heap, the wakeup is armed by callers.
+  void schedule(DOMTimer* timer);
+  void armWakeup(ExecutionContext* context);
+
   std::unordered_map<int, DOMTimer*> m_activeTimers;
   std::vector<DOMTimer*> m_abandonedTimers;
+  // Cleared timers are dropped when they reach the top, or when they outnumber the active ones.
+  std::vector<ScheduledTimer> m_timerHeap;
+  uint64_t m_sequence{0};
+  int32_t m_nextTimerId{1};
+  // Nesting level of the timer being fired, 0 outside of timer callbacks.
+  // https://html.spec.whatwg.org/multipage/timers-and-user-prompts.html#timer-nesting-level
+  int32_t m_nestingLevel{0};
+  int32_t m_wakeupId{-1};
+  double m_wakeupDeadline{0};
 };
 
 }  // namespace kraken::binding::qjs
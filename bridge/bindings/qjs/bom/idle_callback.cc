@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "idle_callback.h"
+#include <algorithm>
+#include <chrono>
+#include "bindings/qjs/qjs_patch.h"
+#include "dart_methods.h"
+
+#if UNIT_TEST
+#include "kraken_test_env.h"
+#endif
+
+namespace kraken::binding::qjs {
+
+JSClassID IdleCallback::classId{0};
+
+IdleCallback::IdleCallback(JSValue callback) : m_callback(callback) {}
+
+double IdleCallback::currentTime() {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// https://w3c.github.io/requestidlecallback/#dom-idledeadline-timeremaining
+static JSValue timeRemaining(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic, JSValue* func_data) {
+  double deadline;
+  JS_ToFloat64(ctx, &deadline, func_data[0]);
+  return JS_NewFloat64(ctx, std::max(deadline - IdleCallback::currentTime(), 0.0));
+}
+
+void IdleCallback::invoke(double deadline, bool didTimeout) {
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(m_ctx));
+  if (!JS_IsFunction(m_ctx, m_callback))
+    return;
+
+  // This callback is taken from the controller before it is invoked, keep it alive until the call returns.
+  JSValue self = JS_DupValue(m_ctx, jsObject);
+
+  JSValue deadlineValue = JS_NewFloat64(m_ctx, deadline);
+  JSValue idleDeadline = JS_NewObject(m_ctx);
+  JS_SetPropertyStr(m_ctx, idleDeadline, "timeRemaining", JS_NewCFunctionData(m_ctx, timeRemaining, 0, 0, 1, &deadlineValue));
+  JS_SetPropertyStr(m_ctx, idleDeadline, "didTimeout", JS_NewBool(m_ctx, didTimeout));
+
+  // 'callback' might be destroyed when calling itself (if it frees the handler), so must take extra care.
+  JS_DupValue(m_ctx, m_callback);
+  JSValue returnValue = JS_Call(m_ctx, m_callback, JS_UNDEFINED, 1, &idleDeadline);
+  JS_FreeValue(m_ctx, m_callback);
+  JS_FreeValue(m_ctx, idleDeadline);
+
+  if (JS_IsException(returnValue)) {
+    context->handleException(&returnValue);
+  }
+
+  JS_FreeValue(m_ctx, returnValue);
+  JS_FreeValue(m_ctx, self);
+}
+
+void IdleCallback::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const {
+  JS_MarkValue(rt, m_callback, mark_func);
+}
+
+void IdleCallback::dispose() const {
+  JS_FreeValueRT(m_runtime, m_callback);
+}
+
+static JSValue requestIdleCallback(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'requestIdleCallback': 1 argument required, but only 0 present.");
+  }
+
+  auto context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+  JSValue callbackValue = argv[0];
+
+  if (!JS_IsObject(callbackValue) || !JS_IsFunction(ctx, callbackValue)) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'requestIdleCallback': parameter 1 (callback) must be a function.");
+  }
+
+  int32_t timeout = 0;
+  if (argc > 1 && JS_IsObject(argv[1])) {
+    JSValue timeoutValue = JS_GetPropertyStr(ctx, argv[1], "timeout");
+    if (JS_IsNumber(timeoutValue)) {
+      JS_ToInt32(ctx, &timeout, timeoutValue);
+    } else if (!JS_IsUndefined(timeoutValue)) {
+      JS_FreeValue(ctx, timeoutValue);
+      return JS_ThrowTypeError(ctx, "Failed to execute 'requestIdleCallback': member timeout only can be a number or undefined.");
+    }
+    JS_FreeValue(ctx, timeoutValue);
+  }
+
+#if FLUTTER_BACKEND
+  if (getDartMethod()->requestIdlePeriod == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'requestIdleCallback': dart method (requestIdlePeriod) is not registered.");
+  }
+#endif
+
+  auto* idleCallback = makeGarbageCollected<IdleCallback>(JS_DupValue(ctx, callbackValue))->initialize(context->ctx(), &IdleCallback::classId);
+  int32_t callbackId = context->idleTasks()->registerCallback(context, idleCallback, timeout);
+
+  return JS_NewUint32(ctx, callbackId);
+}
+
+static JSValue cancelIdleCallback(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc <= 0) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'cancelIdleCallback': 1 argument required, but only 0 present.");
+  }
+
+  auto context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+
+  JSValue callbackIdValue = argv[0];
+  if (!JS_IsNumber(callbackIdValue)) {
+    return JS_NULL;
+  }
+
+  int32_t id;
+  JS_ToInt32(ctx, &id, callbackIdValue);
+
+  context->idleTasks()->cancelCallback(context, id);
+  return JS_NULL;
+}
+
+void bindIdleCallback(ExecutionContext* context) {
+  QJS_GLOBAL_BINDING_FUNCTION(context, requestIdleCallback, "requestIdleCallback", 2);
+  QJS_GLOBAL_BINDING_FUNCTION(context, cancelIdleCallback, "cancelIdleCallback", 1);
+}
+
+}  // namespace kraken::binding::qjs
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_IDLE_CALLBACK_H
+#define KRAKENBRIDGE_IDLE_CALLBACK_H
+
+#include "bindings/qjs/executing_context.h"
+#include "bindings/qjs/garbage_collected.h"
+#include "scripted_idle_task_controller.h"
+
+namespace kraken::binding::qjs {
+
+class IdleCallback : public GarbageCollected<IdleCallback> {
+ public:
+  static JSClassID classId;
+  explicit IdleCallback(JSValue callback);
+
+  // Call the callback with an IdleDeadline, |deadline| is in the same time base as currentTime().
+  void invoke(double deadline, bool didTimeout);
+
+  FORCE_INLINE int32_t timeoutTimerId() const { return m_timeoutTimerId; }
+  FORCE_INLINE void setTimeoutTimerId(int32_t timerId) { m_timeoutTimerId = timerId; }
+
+  [[nodiscard]] FORCE_INLINE const char* getHumanReadableName() const override { return "IdleCallback"; }
+
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const override;
+  void dispose() const override;
+
+  // Milliseconds of a monotonic clock, the base of idle deadlines.
+  static double currentTime();
+
+ private:
+  JSValue m_callback{JS_NULL};
+  // The timer of the `timeout` option, -1 when there is none.
+  int32_t m_timeoutTimerId{-1};
+};
+
+void bindIdleCallback(ExecutionContext* context);
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_IDLE_CALLBACK_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "kraken_bridge.h"
+#include "kraken_test_env.h"
+#include "page.h"
+
+TEST(IdleCallback, runWhileTimeRemains) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "a false true micro b c d");
+  };
+
+  // The second idle period runs the callback left by an exhausted deadline before the new ones.
+  std::string code = R"(
+let logs = [];
+requestIdleCallback((deadline) => {
+  logs.push('a', deadline.didTimeout, deadline.timeRemaining() > 0);
+  requestIdleCallback(() => {
+    logs.push('d');
+    console.log(logs.join(' '));
+  });
+  Promise.resolve().then(() => logs.push('micro'));
+});
+let cancelled = requestIdleCallback(() => logs.push('cancelled'));
+requestIdleCallback((deadline) => {
+  logs.push('b');
+  while (deadline.timeRemaining() > 0) {}
+});
+requestIdleCallback(() => logs.push('c'));
+cancelIdleCallback(cancelled);
+)";
+
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(bridge->getContext());
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(IdleCallback, runTimedOutCallbacks) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "timeout true 0 idle false");
+  };
+
+  // Animation frames keep the page busy for 20ms, no idle period comes before the timeout.
+  std::string code = R"(
+let logs = [];
+requestIdleCallback((deadline) => logs.push('timeout', deadline.didTimeout, deadline.timeRemaining()), { timeout: 5 });
+requestIdleCallback((deadline) => {
+  logs.push('idle', deadline.didTimeout);
+  console.log(logs.join(' '));
+}, { timeout: 100 });
+let start = Date.now();
+function frame() {
+  if (Date.now() - start < 20) requestAnimationFrame(frame);
+}
+requestAnimationFrame(frame);
+)";
+
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(bridge->getContext());
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
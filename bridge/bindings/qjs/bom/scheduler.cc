@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "scheduler.h"
+#include <chrono>
+#include <cstring>
+#include "bindings/qjs/executing_context.h"
+#include "bindings/qjs/qjs_patch.h"
+#include "dart_methods.h"
+#include "timer.h"
+
+#if UNIT_TEST
+#include "kraken_test_env.h"
+#endif
+
+namespace kraken::binding::qjs {
+
+// Time a turn may spend on posted tasks before yielding to dart.
+static const double kTurnBudget = 5;
+
+// The scheduler whose entry into JS is measured, the interrupt handler is shared by all pages of the runtime.
+static EventLoopScheduler* s_measuredScheduler{nullptr};
+
+static double currentTime() {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+JSClassID PostedTask::classId{0};
+
+PostedTask::PostedTask(JSValue callback, JSValue resolve, JSValue reject) : m_callback(callback), m_resolve(resolve), m_reject(reject) {}
+
+void PostedTask::run() {
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(m_ctx));
+  // This task is taken from the scheduler before it runs, keep it alive until the promise is settled.
+  JSValue self = JS_DupValue(m_ctx, jsObject);
+
+  // 'callback' might be destroyed when calling itself (if it frees the handler), so must take extra care.
+  JS_DupValue(m_ctx, m_callback);
+  JSValue returnValue = JS_Call(m_ctx, m_callback, JS_UNDEFINED, 0, nullptr);
+  JS_FreeValue(m_ctx, m_callback);
+
+  JSValue settled;
+  if (JS_IsException(returnValue)) {
+    JSValue error = JS_GetException(m_ctx);
+    settled = JS_Call(m_ctx, m_reject, JS_UNDEFINED, 1, &error);
+    JS_FreeValue(m_ctx, error);
+  } else {
+    settled = JS_Call(m_ctx, m_resolve, JS_UNDEFINED, 1, &returnValue);
+  }
+
+  context->handleException(&settled);
+  JS_FreeValue(m_ctx, settled);
+  JS_FreeValue(m_ctx, returnValue);
+  JS_FreeValue(m_ctx, self);
+}
+
+void PostedTask::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const {
+  JS_MarkValue(rt, m_callback, mark_func);
+  JS_MarkValue(rt, m_resolve, mark_func);
+  JS_MarkValue(rt, m_reject, mark_func);
+}
+
+void PostedTask::dispose() const {
+  JS_FreeValueRT(m_runtime, m_callback);
+  JS_FreeValueRT(m_runtime, m_resolve);
+  JS_FreeValueRT(m_runtime, m_reject);
+}
+
+EventLoopScheduler::ScriptScope::ScriptScope(ExecutionContext* context) : m_context(context) {
+  m_context->scheduler()->enterScript();
+}
+
+EventLoopScheduler::ScriptScope::~ScriptScope() {
+  m_context->scheduler()->leaveScript();
+}
+
+EventLoopScheduler::TaskScope::TaskScope(ExecutionContext* context, TaskLane lane) : m_scriptScope(context), m_context(context) {
+  m_context->scheduler()->enterTurn(lane);
+}
+
+EventLoopScheduler::TaskScope::~TaskScope() {
+  m_context->scheduler()->leaveTurn(m_context);
+}
+
+void EventLoopScheduler::setScriptBudget(double budget) {
+  m_scriptBudget = budget > 0 ? budget : 0;
+}
+
+void EventLoopScheduler::enterScript() {
+  if (m_scriptDepth++ > 0 || m_scriptBudget == 0)
+    return;
+  m_scriptDeadline = currentTime() + m_scriptBudget;
+  m_outerScheduler = s_measuredScheduler;
+  s_measuredScheduler = this;
+}
+
+void EventLoopScheduler::leaveScript() {
+  if (--m_scriptDepth > 0 || s_measuredScheduler != this)
+    return;
+  m_scriptDeadline = 0;
+  s_measuredScheduler = m_outerScheduler;
+  m_outerScheduler = nullptr;
+}
+
+bool EventLoopScheduler::exceedScriptDeadline() {
+  if (m_scriptDeadline == 0)
+    return false;
+  double now = currentTime();
+  if (now < m_scriptDeadline)
+    return false;
+  // Only the script running now is interrupted. The rest of the entry, such as the microtasks it queued, gets a new
+  // budget, and is interrupted as well when it runs past it.
+  m_scriptDeadline = m_scriptBudget > 0 ? now + m_scriptBudget : 0;
+  m_interruptedScriptCount++;
+  return true;
+}
+
+int EventLoopScheduler::handleInterrupt(JSRuntime* rt, void* opaque) {
+  // QuickJS polls this every few thousand instructions, returning true throws an uncatchable "interrupted" error.
+  // Pages without a budget are never measured, the poll only finds no scheduler.
+  return s_measuredScheduler != nullptr && s_measuredScheduler->exceedScriptDeadline();
+}
+
+void EventLoopScheduler::enterTurn(TaskLane lane) {
+  if (m_turnDepth++ > 0)
+    return;
+  m_turnLane = lane;
+  m_turnStart = currentTime();
+}
+
+void EventLoopScheduler::leaveTurn(ExecutionContext* context) {
+  if (m_turnDepth > 1) {
+    m_turnDepth--;
+    return;
+  }
+
+  // The depth is kept while the posted tasks run, turns entered by them join this one.
+  if (context->isValid()) {
+    context->drainPendingPromiseJobs();
+    // Posted tasks of frozen pages wait for the turn of resuming.
+    if (!context->isFrozen()) {
+      runQueuedTasks(context);
+    }
+  }
+  m_turnDepth--;
+
+  if (context->isValid() && hasQueuedTasks()) {
+    armContinuation(context);
+  }
+}
+
+bool EventLoopScheduler::shouldYield() const {
+  return m_turnDepth > 0 && currentTime() - m_turnStart >= kTurnBudget;
+}
+
+void EventLoopScheduler::postTask(ExecutionContext* context, TaskLane lane, PostedTask* task, int32_t delay) {
+  if (delay > 0) {
+    int32_t delayedTaskId = m_nextDelayedTaskId++;
+    m_delayedTasks[delayedTaskId] = {lane, task};
+    JSValue delayedTaskIdValue = JS_NewInt32(context->ctx(), delayedTaskId);
+    JSValue handler = JS_NewCFunctionData(context->ctx(), handleDelayedTask, 0, 0, 1, &delayedTaskIdValue);
+    auto* timer = makeGarbageCollected<DOMTimer>(handler, false)->initialize(context->ctx(), &DOMTimer::classId);
+    context->timers()->installNewTimer(context, timer, delay);
+    return;
+  }
+
+  enqueue(context, lane, task);
+}
+
+JSValue EventLoopScheduler::handleDelayedTask(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic, JSValue* func_data) {
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+  EventLoopScheduler* scheduler = context->scheduler();
+  int32_t delayedTaskId;
+  JS_ToInt32(ctx, &delayedTaskId, func_data[0]);
+
+  if (scheduler->m_delayedTasks.count(delayedTaskId) == 0)
+    return JS_NULL;
+  auto delayed = scheduler->m_delayedTasks[delayedTaskId];
+  scheduler->m_delayedTasks.erase(delayedTaskId);
+  scheduler->enqueue(context, delayed.first, delayed.second);
+  return JS_NULL;
+}
+
+void EventLoopScheduler::enqueue(ExecutionContext* context, TaskLane lane, PostedTask* task) {
+  m_lanes[static_cast<size_t>(lane)].emplace_back(task);
+  // Tasks posted within a turn run when it ends.
+  if (m_turnDepth == 0) {
+    armContinuation(context);
+  }
+}
+
+void EventLoopScheduler::runQueuedTasks(ExecutionContext* context) {
+  for (size_t i = 0; i < m_lanes.size();) {
+    std::deque<PostedTask*>& queue = m_lanes[i];
+    if (queue.empty()) {
+      i++;
+      continue;
+    }
+
+    // Input turns hand the other lanes over to a continuation, which keeps dart input dispatching short.
+    auto lane = static_cast<TaskLane>(i);
+    if (lane != TaskLane::input && (m_turnLane == TaskLane::input || shouldYield()))
+      return;
+
+    PostedTask* task = queue.front();
+    queue.pop_front();
+    // Push this task to abandoned list to mark this task is deprecated.
+    m_abandonedTasks.emplace_back(task);
+    task->run();
+    context->drainPendingPromiseJobs();
+
+    // Tasks of higher lanes posted by this one go first.
+    i = 0;
+  }
+}
+
+bool EventLoopScheduler::hasQueuedTasks() const {
+  for (auto& queue : m_lanes) {
+    if (!queue.empty())
+      return true;
+  }
+  return false;
+}
+
+void EventLoopScheduler::armContinuation(ExecutionContext* context) {
+  if (m_continuationId != -1 || context->isFrozen())
+    return;
+  m_continuationId = getDartMethod()->setTimeout(context, context->getContextId(), handleContinuationCallback, 0);
+}
+
+void EventLoopScheduler::handleContinuationCallback(void* ptr, int32_t contextId, const char* errmsg) {
+  auto* context = static_cast<ExecutionContext*>(ptr);
+
+  if (!checkPage(contextId, context))
+    return;
+  if (!context->isValid())
+    return;
+
+  context->scheduler()->m_continuationId = -1;
+
+  if (errmsg != nullptr) {
+    JSValue exception = JS_ThrowTypeError(context->ctx(), "%s", errmsg);
+    context->handleException(&exception);
+    return;
+  }
+
+  if (context->isFrozen())
+    return;
+
+  // Queued tasks run when this turn ends.
+  TaskScope scope(context, TaskLane::normal);
+}
+
+void EventLoopScheduler::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  for (auto& queue : m_lanes) {
+    for (auto& task : queue) {
+      JS_MarkValue(rt, task->toQuickJS(), mark_func);
+    }
+  }
+  for (auto& delayed : m_delayedTasks) {
+    JS_MarkValue(rt, delayed.second.second->toQuickJS(), mark_func);
+  }
+
+  // Recycle all abandoned tasks.
+  if (!m_abandonedTasks.empty()) {
+    for (auto& task : m_abandonedTasks) {
+      JS_MarkValue(rt, task->toQuickJS(), mark_func);
+    }
+    // All abandoned tasks should be freed at the sweep stage.
+    m_abandonedTasks.clear();
+  }
+}
+
+static bool parseTaskPriority(JSContext* ctx, JSValue priorityValue, TaskLane* lane) {
+  const char* priority = JS_ToCString(ctx, priorityValue);
+  bool valid = true;
+  if (strcmp(priority, "user-blocking") == 0) {
+    *lane = TaskLane::input;
+  } else if (strcmp(priority, "user-visible") == 0) {
+    *lane = TaskLane::normal;
+  } else if (strcmp(priority, "background") == 0) {
+    *lane = TaskLane::idle;
+  } else {
+    valid = false;
+  }
+  JS_FreeCString(ctx, priority);
+  return valid;
+}
+
+// https://wicg.github.io/scheduling-apis/#dom-scheduler-posttask
+static JSValue postTask(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  if (argc < 1) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'postTask' on 'Scheduler': 1 argument required, but only 0 present.");
+  }
+
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+  JSValue callbackValue = argv[0];
+  if (!JS_IsObject(callbackValue) || !JS_IsFunction(ctx, callbackValue)) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'postTask' on 'Scheduler': parameter 1 (callback) must be a function.");
+  }
+
+  TaskLane lane = TaskLane::normal;
+  int32_t delay = 0;
+  if (argc > 1 && JS_IsObject(argv[1])) {
+    JSValue priorityValue = JS_GetPropertyStr(ctx, argv[1], "priority");
+    bool validPriority = JS_IsUndefined(priorityValue) || (JS_IsString(priorityValue) && parseTaskPriority(ctx, priorityValue, &lane));
+    JS_FreeValue(ctx, priorityValue);
+    if (!validPriority) {
+      return JS_ThrowTypeError(ctx, "Failed to execute 'postTask' on 'Scheduler': priority must be one of 'user-blocking', 'user-visible' and 'background'.");
+    }
+
+    JSValue delayValue = JS_GetPropertyStr(ctx, argv[1], "delay");
+    if (JS_IsNumber(delayValue)) {
+      JS_ToInt32(ctx, &delay, delayValue);
+    }
+    JS_FreeValue(ctx, delayValue);
+  }
+
+  JSValue resolvingFunctions[2];
+  JSValue promise = JS_NewPromiseCapability(ctx, resolvingFunctions);
+  auto* task = makeGarbageCollected<PostedTask>(JS_DupValue(ctx, callbackValue), resolvingFunctions[0], resolvingFunctions[1])->initialize(ctx, &PostedTask::classId);
+  context->scheduler()->postTask(context, lane, task, delay);
+
+  return promise;
+}
+
+void bindScheduler(ExecutionContext* context) {
+  JSContext* ctx = context->ctx();
+  JSValue scheduler = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, scheduler, "postTask", JS_NewCFunction(ctx, postTask, "postTask", 2));
+  context->defineGlobalProperty("scheduler", scheduler);
+}
+
+}  // namespace kraken::binding::qjs
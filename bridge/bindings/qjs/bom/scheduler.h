@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_BINDINGS_QJS_BOM_SCHEDULER_H_
+#define KRAKENBRIDGE_BINDINGS_QJS_BOM_SCHEDULER_H_
+
+#include <quickjs/quickjs.h>
+#include <array>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include "bindings/qjs/garbage_collected.h"
+
+namespace kraken::binding::qjs {
+
+class ExecutionContext;
+
+// Lanes of work entering JS, in order of priority.
+enum class TaskLane : uint8_t { input, animation, normal, idle };
+
+// A task of scheduler.postTask, settles the promise returned to JS with the result of its callback.
+class PostedTask : public GarbageCollected<PostedTask> {
+ public:
+  static JSClassID classId;
+  PostedTask(JSValue callback, JSValue resolve, JSValue reject);
+
+  void run();
+
+  [[nodiscard]] FORCE_INLINE const char* getHumanReadableName() const override { return "PostedTask"; }
+
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const override;
+  void dispose() const override;
+
+ private:
+  JSValue m_callback{JS_NULL};
+  JSValue m_resolve{JS_NULL};
+  JSValue m_reject{JS_NULL};
+};
+
+// Coordinates the work entering JS of a given page.
+//
+// Every entry point from dart, such as events, timers, animation frames and
+// module callbacks, runs as a turn of its lane. The outermost turn performs
+// the microtask checkpoint, then runs the tasks posted by scheduler.postTask
+// in order of their lanes while the turn budget lasts. Tasks left once the
+// budget is spent wait for a dart wakeup, so the next input event is never
+// queued behind them. Input tasks never yield.
+//
+// Pages with a script time budget have their outermost entry into JS measured
+// against it, scripts running past the budget are interrupted with an
+// uncatchable error so one page never hangs the JS thread shared by all pages.
+class EventLoopScheduler {
+ public:
+  // Measures the script time of the outermost entry into JS of the page for the lifetime of the scope.
+  class ScriptScope {
+   public:
+    explicit ScriptScope(ExecutionContext* context);
+    ~ScriptScope();
+
+   private:
+    ExecutionContext* m_context;
+  };
+
+  // Marks a turn of |lane| for the lifetime of the scope, nested scopes join the outermost turn.
+  class TaskScope {
+   public:
+    TaskScope(ExecutionContext* context, TaskLane lane);
+    ~TaskScope();
+
+   private:
+    // Posted tasks run by the turn are measured too.
+    ScriptScope m_scriptScope;
+    ExecutionContext* m_context;
+  };
+
+  // Queue a task, |delay| in milliseconds is waited on a native timer first.
+  void postTask(ExecutionContext* context, TaskLane lane, PostedTask* task, int32_t delay);
+  // Whether the budget of the current turn is spent, long running loops check this to yield to dart.
+  bool shouldYield() const;
+  // Time in milliseconds scripts of an entry into JS may run before they are interrupted, 0 to disable.
+  void setScriptBudget(double budget);
+  [[nodiscard]] FORCE_INLINE uint32_t interruptedScriptCount() const { return m_interruptedScriptCount; }
+  // Interrupt handler of the runtime shared by all pages.
+  static int handleInterrupt(JSRuntime* rt, void* opaque);
+
+  void trace(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func);
+
+ private:
+  void enterScript();
+  void leaveScript();
+  bool exceedScriptDeadline();
+  void enterTurn(TaskLane lane);
+  void leaveTurn(ExecutionContext* context);
+  void enqueue(ExecutionContext* context, TaskLane lane, PostedTask* task);
+  void runQueuedTasks(ExecutionContext* context);
+  void armContinuation(ExecutionContext* context);
+  bool hasQueuedTasks() const;
+  static JSValue handleDelayedTask(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic, JSValue* func_data);
+  static void handleContinuationCallback(void* ptr, int32_t contextId, const char* errmsg);
+
+  std::array<std::deque<PostedTask*>, 4> m_lanes;
+  // Tasks waiting for their delay, keyed by the ID their timer posts them with.
+  std::unordered_map<int32_t, std::pair<TaskLane, PostedTask*>> m_delayedTasks;
+  int32_t m_nextDelayedTaskId{1};
+  std::vector<PostedTask*> m_abandonedTasks;
+  int32_t m_turnDepth{0};
+  TaskLane m_turnLane{TaskLane::normal};
+  double m_turnStart{0};
+  int32_t m_continuationId{-1};
+  double m_scriptBudget{0};
+  int32_t m_scriptDepth{0};
+  // Deadline of the outermost entry into JS, 0 when it is not measured.
+  double m_scriptDeadline{0};
+  // The measured scheduler of the entry this one is nested in, pages may enter each other on the JS thread.
+  EventLoopScheduler* m_outerScheduler{nullptr};
+  uint32_t m_interruptedScriptCount{0};
+};
+
+void bindScheduler(ExecutionContext* context);
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_BINDINGS_QJS_BOM_SCHEDULER_H_
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "bindings/qjs/dom/element.h"
+#include "gtest/gtest.h"
+#include "kraken_bridge.h"
+#include "kraken_test_env.h"
+#include "page.h"
+
+TEST(Scheduler, postTaskInOrderOfPriority) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "blocking visible 42 failed background TypeError");
+  };
+
+  std::string code = R"(
+let logs = [];
+scheduler.postTask(() => logs.push('background'), { priority: 'background' });
+scheduler.postTask(() => {
+  logs.push('visible');
+  return 42;
+}).then((value) => logs.push(value));
+scheduler.postTask(() => logs.push('blocking'), { priority: 'user-blocking' });
+scheduler.postTask(() => {
+  throw new Error('failed');
+}).catch((error) => logs.push(error.message));
+scheduler.postTask(() => {
+  try {
+    scheduler.postTask(() => {}, { priority: 'urgent' });
+  } catch (error) {
+    logs.push(error.name);
+  }
+  console.log(logs.join(' '));
+}, { priority: 'background', delay: 5 });
+)";
+
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(bridge->getContext());
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Scheduler, yieldWhenTurnBudgetIsSpent) {
+  bool static errorCalled = false;
+  static std::vector<std::string> logs;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+
+  std::string code = R"(
+let logs = [];
+scheduler.postTask(() => {
+  logs.push('a');
+  let start = Date.now();
+  while (Date.now() - start < 6) {}
+  scheduler.postTask(() => logs.push('blocking'), { priority: 'user-blocking' });
+});
+scheduler.postTask(() => logs.push('b'));
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  // Input tasks still run after the budget is spent, the others wait for the continuation.
+  { EventLoopScheduler::TaskScope scope(context, TaskLane::normal); }
+  std::string check = "console.log(logs.join(' '));";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  TEST_runLoop(context);
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logs.size(), 2);
+  EXPECT_STREQ(logs[0].c_str(), "a blocking");
+  EXPECT_STREQ(logs[1].c_str(), "a blocking b");
+}
+
+TEST(Scheduler, inputTurnDefersLowerLanes) {
+  bool static errorCalled = false;
+  static std::vector<std::string> logs;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+
+  std::string code = R"(
+let logs = [];
+var target = document.createElement('div');
+target.addEventListener('click', () => {
+  scheduler.postTask(() => logs.push('visible'));
+  scheduler.postTask(() => logs.push('blocking'), { priority: 'user-blocking' });
+  Promise.resolve().then(() => logs.push('micro'));
+  logs.push('click');
+});
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  JSValue target = JS_GetPropertyStr(context->ctx(), context->global(), "target");
+  TEST_dispatchEvent(context->getContextId(), static_cast<EventTargetInstance*>(JS_GetOpaque(target, Element::classId())), "click");
+  JS_FreeValue(context->ctx(), target);
+
+  std::string check = "console.log(logs.join(' '));";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+  TEST_runLoop(context);
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logs.size(), 2);
+  EXPECT_STREQ(logs[0].c_str(), "click micro blocking");
+  EXPECT_STREQ(logs[1].c_str(), "click micro blocking visible");
+}
+
+TEST(Scheduler, interruptScriptsOverBudget) {
+  static std::vector<std::string> errors;
+  static std::vector<std::string> logs;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { errors.emplace_back(errmsg); });
+  auto context = bridge->getContext();
+  bridge->setScriptTimeBudget(20);
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+
+  std::string code = R"(
+setTimeout(function spin() {
+  try {
+    while (true) {}
+  } catch (error) {
+    console.log('caught');
+  }
+});
+setTimeout(() => console.log('next'), 1);
+while (true) {}
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(context);
+
+  // The error can not be caught by the script, the page keeps running.
+  EXPECT_EQ(bridge->interruptedScriptCount(), 2);
+  EXPECT_NE(errors.front().find("InternalError: interrupted\n    at <eval>"), std::string::npos);
+  EXPECT_NE(errors.back().find("InternalError: interrupted\n    at spin"), std::string::npos);
+  EXPECT_EQ(logs.size(), 1);
+  EXPECT_STREQ(logs[0].c_str(), "next");
+}
+
+TEST(Scheduler, interruptMicrotasksOfInterruptedScript) {
+  static std::vector<std::string> logs;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { KRAKEN_LOG(VERBOSE) << errmsg; });
+  auto context = bridge->getContext();
+  bridge->setScriptTimeBudget(20);
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+
+  std::string code = R"(
+setTimeout(() => {
+  Promise.resolve().then(() => {
+    while (true) {}
+  });
+  while (true) {}
+});
+setTimeout(() => console.log('next'), 1);
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(context);
+
+  // The microtask runs in the same entry as the interrupted timer, it is measured against a budget of its own.
+  EXPECT_EQ(bridge->interruptedScriptCount(), 2);
+  EXPECT_EQ(logs.size(), 1);
+  EXPECT_STREQ(logs[0].c_str(), "next");
+}
+
+TEST(Scheduler, interruptContinuousListenersFlushedByInput) {
+  using namespace kraken::binding::qjs;
+
+  static std::vector<std::string> logs;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { KRAKEN_LOG(VERBOSE) << errmsg; });
+  auto context = bridge->getContext();
+  bridge->setScriptTimeBudget(20);
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+
+  std::string code = R"(
+var div = document.createElement('div');
+document.body.appendChild(div);
+div.addEventListener('touchmove', () => {
+  while (true) {}
+});
+div.addEventListener('click', () => console.log('click'));
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  JSValue divValue = JS_GetPropertyStr(context->ctx(), context->global(), "div");
+  auto* div = static_cast<EventTargetInstance*>(JS_GetOpaque(divValue, Element::classId()));
+  TEST_dispatchEvent(context->getContextId(), div, "touchmove");
+  // Pending touchmove listeners run in the turn of the click, under its budget.
+  TEST_dispatchEvent(context->getContextId(), div, "click");
+  JS_FreeValue(context->ctx(), divValue);
+
+  EXPECT_EQ(bridge->interruptedScriptCount(), 1);
+  EXPECT_EQ(logs.size(), 1);
+  EXPECT_STREQ(logs[0].c_str(), "click");
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "scripted_idle_task_controller.h"
+#include "dart_methods.h"
+#include "idle_callback.h"
+#include "timer.h"
+
+#if UNIT_TEST
+#include "kraken_test_env.h"
+#endif
+
+namespace kraken::binding::qjs {
+
+static void handleIdlePeriodCallback(void* ptr, int32_t contextId, double timeRemaining, const char* errmsg) {
+  auto* context = static_cast<ExecutionContext*>(ptr);
+
+  if (!checkPage(contextId, context))
+    return;
+  if (!context->isValid())
+    return;
+
+  if (errmsg != nullptr) {
+    JSValue exception = JS_ThrowTypeError(context->ctx(), "%s", errmsg);
+    context->handleException(&exception);
+    return;
+  }
+
+  EventLoopScheduler::TaskScope scope(context, TaskLane::idle);
+  context->idleTasks()->runIdlePeriod(context, timeRemaining);
+}
+
+static JSValue handleIdleCallbackTimeout(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv, int magic, JSValue* func_data) {
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+  int32_t callbackId;
+  JS_ToInt32(ctx, &callbackId, func_data[0]);
+  context->idleTasks()->runTimedOutCallback(context, callbackId);
+  return JS_NULL;
+}
+
+int32_t ScriptedIdleTaskController::registerCallback(ExecutionContext* context, IdleCallback* callback, int32_t timeout) {
+  int32_t callbackId = m_nextCallbackId++;
+  m_idleCallbacks[callbackId] = callback;
+  m_pendingCallbackIds.emplace_back(callbackId);
+
+  if (timeout > 0) {
+    // The timeout is a timer of its own, it runs the callback from the timer task when no idle period came in time.
+    JSValue callbackIdValue = JS_NewInt32(context->ctx(), callbackId);
+    JSValue handler = JS_NewCFunctionData(context->ctx(), handleIdleCallbackTimeout, 0, 0, 1, &callbackIdValue);
+    auto* timer = makeGarbageCollected<DOMTimer>(handler, false)->initialize(context->ctx(), &DOMTimer::classId);
+    callback->setTimeoutTimerId(context->timers()->installNewTimer(context, timer, timeout));
+  }
+
+  scheduleIdlePeriod(context);
+  return callbackId;
+}
+
+void ScriptedIdleTaskController::cancelCallback(ExecutionContext* context, int32_t callbackId) {
+  // The requested idle period is kept, it runs nothing when every callback is cancelled.
+  takeCallback(context, callbackId);
+}
+
+IdleCallback* ScriptedIdleTaskController::takeCallback(ExecutionContext* context, int32_t callbackId) {
+  if (m_idleCallbacks.count(callbackId) == 0)
+    return nullptr;
+  IdleCallback* callback = m_idleCallbacks[callbackId];
+  m_idleCallbacks.erase(callbackId);
+
+  if (callback->timeoutTimerId() != -1) {
+    context->timers()->removeTimeoutById(callback->timeoutTimerId());
+    callback->setTimeoutTimerId(-1);
+  }
+
+  // Push this callback to abandoned list to mark this callback is deprecated.
+  m_abandonedCallbacks.emplace_back(callback);
+  return callback;
+}
+
+void ScriptedIdleTaskController::runIdlePeriod(ExecutionContext* context, double timeRemaining) {
+  m_isIdlePeriodRequested = false;
+
+  if (context->isFrozen())
+    return;
+
+  // The page is not idle while its UI commands are waiting for the next frame.
+  if (context->uiCommandBuffer()->size() > 0) {
+    scheduleIdlePeriod(context);
+    return;
+  }
+
+  double deadline = IdleCallback::currentTime() + timeRemaining;
+
+  // Callbacks registered by the callbacks below wait for the next idle period.
+  std::vector<int32_t> callbackIds;
+  callbackIds.swap(m_pendingCallbackIds);
+
+  size_t i = 0;
+  for (; i < callbackIds.size(); i++) {
+    if (IdleCallback::currentTime() >= deadline)
+      break;
+
+    IdleCallback* callback = takeCallback(context, callbackIds[i]);
+    if (callback == nullptr)
+      continue;
+
+    callback->invoke(deadline, false);
+
+    // Executing pending async jobs, each idle callback is a task of its own.
+    context->drainPendingPromiseJobs();
+  }
+
+  // Callbacks left by an exhausted deadline keep their turn ahead of the new ones.
+  m_pendingCallbackIds.insert(m_pendingCallbackIds.begin(), callbackIds.begin() + i, callbackIds.end());
+
+  if (!m_idleCallbacks.empty()) {
+    scheduleIdlePeriod(context);
+  }
+}
+
+void ScriptedIdleTaskController::runTimedOutCallback(ExecutionContext* context, int32_t callbackId) {
+  IdleCallback* callback = takeCallback(context, callbackId);
+  if (callback == nullptr)
+    return;
+
+  // A timed out callback has no idle time left.
+  // https://w3c.github.io/requestidlecallback/#invoke-idle-callback-timeout-algorithm
+  callback->invoke(IdleCallback::currentTime(), true);
+}
+
+void ScriptedIdleTaskController::resume(ExecutionContext* context) {
+  if (!m_idleCallbacks.empty()) {
+    scheduleIdlePeriod(context);
+  }
+}
+
+void ScriptedIdleTaskController::scheduleIdlePeriod(ExecutionContext* context) {
+  if (m_isIdlePeriodRequested || context->isFrozen())
+    return;
+
+  getDartMethod()->requestIdlePeriod(context, context->getContextId(), handleIdlePeriodCallback);
+  m_isIdlePeriodRequested = true;
+}
+
+void ScriptedIdleTaskController::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  for (auto& callback : m_idleCallbacks) {
+    JS_MarkValue(rt, callback.second->toQuickJS(), mark_func);
+  }
+
+  // Recycle all abandoned callbacks.
+  if (!m_abandonedCallbacks.empty()) {
+    for (auto& callback : m_abandonedCallbacks) {
+      JS_MarkValue(rt, callback->toQuickJS(), mark_func);
+    }
+    // All abandoned callbacks should be freed at the sweep stage.
+    m_abandonedCallbacks.clear();
+  }
+}
+
+}  // namespace kraken::binding::qjs
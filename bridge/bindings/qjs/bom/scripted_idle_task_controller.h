@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_BINDINGS_QJS_BOM_SCRIPTED_IDLE_TASK_CONTROLLER_H_
+#define KRAKENBRIDGE_BINDINGS_QJS_BOM_SCRIPTED_IDLE_TASK_CONTROLLER_H_
+
+#include <quickjs/quickjs.h>
+#include <unordered_map>
+#include <vector>
+
+namespace kraken::binding::qjs {
+
+class ExecutionContext;
+class IdleCallback;
+
+// Maintains the idle callbacks of requestIdleCallback for a given page.
+//
+// Dart starts an idle period after a frame is drawn, the UI commands of the
+// page are flushed by then, and reports how much of the frame budget is left.
+// Callbacks run in the order they were registered until that budget runs out,
+// the ones left wait for the next idle period.
+// https://w3c.github.io/requestidlecallback/#start-an-idle-period-algorithm
+class ScriptedIdleTaskController {
+ public:
+  // Registers a callback and asks dart for an idle period. Returns the assigned ID.
+  int32_t registerCallback(ExecutionContext* context, IdleCallback* callback, int32_t timeout);
+  void cancelCallback(ExecutionContext* context, int32_t callbackId);
+
+  // Run the callbacks registered before this idle period while time remains.
+  void runIdlePeriod(ExecutionContext* context, double timeRemaining);
+  // Run the callback whose timeout is reached before any idle period could run it.
+  void runTimedOutCallback(ExecutionContext* context, int32_t callbackId);
+  // Frozen pages have no idle periods, the one for the callbacks left is requested when the page resumes.
+  void resume(ExecutionContext* context);
+
+  void trace(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func);
+
+ private:
+  void scheduleIdlePeriod(ExecutionContext* context);
+  // Remove the callback before it runs, together with its timeout timer.
+  IdleCallback* takeCallback(ExecutionContext* context, int32_t callbackId);
+
+  std::unordered_map<int32_t, IdleCallback*> m_idleCallbacks;
+  // IDs in the order of registration, cancelled ones are skipped when their turn comes.
+  std::vector<int32_t> m_pendingCallbackIds;
+  std::vector<IdleCallback*> m_abandonedCallbacks;
+  int32_t m_nextCallbackId{1};
+  bool m_isIdlePeriodRequested{false};
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_BINDINGS_QJS_BOM_SCRIPTED_IDLE_TASK_CONTROLLER_H_
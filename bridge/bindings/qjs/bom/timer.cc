@@ -14,7 +14,7 @@
 
 namespace kraken::binding::qjs {
 
-DOMTimer::DOMTimer(JSValue callback) : m_callback(callback) {}
+DOMTimer::DOMTimer(JSValue callback, bool isInterval) : m_callback(callback), m_isInterval(isInterval) {}
 
 JSClassID DOMTimer::classId{0};
 
@@ -51,51 +51,6 @@ void DOMTimer::setTimerId(int32_t timerId) {
   m_timerId = timerId;
 }
 
-static void handleTimerCallback(DOMTimer* timer, const char* errmsg) {
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(timer->ctx()));
-
-  if (errmsg != nullptr) {
-    JSValue exception = JS_ThrowTypeError(timer->ctx(), "%s", errmsg);
-    context->handleException(&exception);
-    return;
-  }
-
-  if (context->timers()->getTimerById(timer->timerId()) == nullptr)
-    return;
-
-  // Trigger timer callbacks.
-  timer->fire();
-
-  // Executing pending async jobs.
-  context->drainPendingPromiseJobs();
-}
-
-static void handleTransientCallback(void* ptr, int32_t contextId, const char* errmsg) {
-  auto* timer = static_cast<DOMTimer*>(ptr);
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(timer->ctx()));
-
-  if (!checkPage(contextId, context))
-    return;
-  if (!context->isValid())
-    return;
-
-  handleTimerCallback(timer, errmsg);
-
-  context->timers()->removeTimeoutById(timer->timerId());
-}
-
-static void handlePersistentCallback(void* ptr, int32_t contextId, const char* errmsg) {
-  auto* timer = static_cast<DOMTimer*>(ptr);
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(timer->ctx()));
-
-  if (!checkPage(contextId, context))
-    return;
-  if (!context->isValid())
-    return;
-
-  handleTimerCallback(timer, errmsg);
-}
-
 static JSValue setTimeout(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
   if (argc < 1) {
     return JS_ThrowTypeError(ctx, "Failed to execute 'setTimeout': 1 argument required, but only 0 present.");
@@ -130,19 +85,10 @@ static JSValue setTimeout(JSContext* ctx, JSValueConst this_val, int argc, JSVal
 #endif
 
   // Create a timer object to keep track timer callback.
-  auto* timer = makeGarbageCollected<DOMTimer>(JS_DupValue(ctx, callbackValue))->initialize(context->ctx(), &DOMTimer::classId);
-
-  auto timerId = getDartMethod()->setTimeout(timer, context->getContextId(), handleTransientCallback, timeout);
+  auto* timer = makeGarbageCollected<DOMTimer>(JS_DupValue(ctx, callbackValue), false)->initialize(context->ctx(), &DOMTimer::classId);
 
-  // Register timerId.
-  timer->setTimerId(timerId);
-
-  context->timers()->installNewTimer(context, timerId, timer);
-
-  // `-1` represents ffi error occurred.
-  if (timerId == -1) {
-    return JS_ThrowTypeError(ctx, "Failed to execute 'setTimeout': dart method (setTimeout) execute failed");
-  }
+  // Timers are scheduled natively, dart is only asked to wake up the page at the earliest deadline.
+  int32_t timerId = context->timers()->installNewTimer(context, timer, timeout);
 
   return JS_NewUint32(ctx, timerId);
 }
@@ -174,22 +120,16 @@ static JSValue setInterval(JSContext* ctx, JSValueConst this_val, int argc, JSVa
     return JS_ThrowTypeError(ctx, "Failed to execute 'setTimeout': parameter 2 (timeout) only can be a number or undefined.");
   }
 
-  if (getDartMethod()->setInterval == nullptr) {
-    return JS_ThrowTypeError(ctx, "Failed to execute 'setInterval': dart method (setInterval) is not registered.");
+#if FLUTTER_BACKEND
+  if (getDartMethod()->setTimeout == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'setInterval': dart method (setTimeout) is not registered.");
   }
+#endif
 
   // Create a timer object to keep track timer callback.
-  auto* timer = makeGarbageCollected<DOMTimer>(JS_DupValue(ctx, callbackValue))->initialize(context->ctx(), &DOMTimer::classId);
-
-  uint32_t timerId = getDartMethod()->setInterval(timer, context->getContextId(), handlePersistentCallback, timeout);
-
-  // Register timerId.
-  timer->setTimerId(timerId);
-  context->timers()->installNewTimer(context, timerId, timer);
+  auto* timer = makeGarbageCollected<DOMTimer>(JS_DupValue(ctx, callbackValue), true)->initialize(context->ctx(), &DOMTimer::classId);
 
-  if (timerId == -1) {
-    return JS_ThrowTypeError(ctx, "Failed to execute 'setInterval': dart method (setInterval) got unexpected error.");
-  }
+  int32_t timerId = context->timers()->installNewTimer(context, timer, timeout);
 
   return JS_NewUint32(ctx, timerId);
 }
@@ -209,12 +149,7 @@ static JSValue clearTimeout(JSContext* ctx, JSValueConst this_val, int argc, JSV
   int32_t id;
   JS_ToInt32(ctx, &id, timeIdValue);
 
-  if (getDartMethod()->clearTimeout == nullptr) {
-    return JS_ThrowTypeError(ctx, "Failed to execute 'clearTimeout': dart method (clearTimeout) is not registered.");
-  }
-
-  getDartMethod()->clearTimeout(context->getContextId(), id);
-
+  // The dart wakeup is kept, it finds no due timer and arms the next one.
   context->timers()->removeTimeoutById(id);
   return JS_NULL;
 }
@@ -15,13 +15,18 @@ namespace kraken::binding::qjs {
 class DOMTimer : public GarbageCollected<DOMTimer> {
  public:
   static JSClassID classId;
-  DOMTimer(JSValue callback);
+  DOMTimer(JSValue callback, bool isInterval);
 
   // Trigger timer callback.
   void fire();
 
   int32_t timerId();
   void setTimerId(int32_t timerId);
+  FORCE_INLINE int32_t timeout() const { return m_timeout; }
+  FORCE_INLINE void setTimeout(int32_t timeout) { m_timeout = timeout; }
+  FORCE_INLINE int32_t nestingLevel() const { return m_nestingLevel; }
+  FORCE_INLINE void setNestingLevel(int32_t nestingLevel) { m_nestingLevel = nestingLevel; }
+  FORCE_INLINE bool isInterval() const { return m_isInterval; }
 
   [[nodiscard]] FORCE_INLINE const char* getHumanReadableName() const override { return "DOMTimer"; }
 
@@ -30,7 +35,9 @@ class DOMTimer : public GarbageCollected<DOMTimer> {
 
  private:
   int32_t m_timerId{-1};
-  int32_t m_isInterval{false};
+  int32_t m_timeout{0};
+  int32_t m_nestingLevel{0};
+  bool m_isInterval{false};
   JSValue m_callback;
 };
 
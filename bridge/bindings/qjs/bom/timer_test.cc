@@ -66,3 +66,66 @@ clearTimeout(timer);
   TEST_runLoop(bridge->getContext());
   disposePage(0);
 }
+
+TEST(Timer, fireInOrderOfDeadline) {
+  bool static logCalled = false;
+  auto bridge = TEST_init();
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "b promise c a interval interval d");
+  };
+
+  std::string code = R"(
+let logs = [];
+setTimeout(() => logs.push('a'), 10);
+setTimeout(() => {
+  logs.push('b');
+  Promise.resolve().then(() => logs.push('promise'));
+});
+setTimeout(() => logs.push('c'));
+let cleared = setTimeout(() => logs.push('cleared'), 5);
+clearTimeout(cleared);
+let count = 0;
+let interval = setInterval(() => {
+  logs.push('interval');
+  if (++count == 2) clearInterval(interval);
+}, 15);
+setTimeout(() => {
+  logs.push('d');
+  console.log(logs.join(' '));
+}, 40);
+)";
+
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(bridge->getContext());
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Timer, clampNestedTimers) {
+  bool static logCalled = false;
+  auto bridge = TEST_init();
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "true");
+  };
+
+  // Timers nested deeper than 5 levels wait for at least 4ms.
+  std::string code = R"(
+let start = performance.now();
+let level = 0;
+function nest() {
+  if (++level < 10) {
+    setTimeout(nest, 0);
+  } else {
+    console.log(performance.now() - start >= 4 * 4);
+  }
+}
+setTimeout(nest, 0);
+)";
+
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(bridge->getContext());
+  EXPECT_EQ(logCalled, true);
+}
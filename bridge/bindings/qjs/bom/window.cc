@@ -110,12 +110,6 @@ JSValue Window::requestAnimationFrame(JSContext* ctx, JSValue this_val, int argc
 
   // Flutter backend implements check
 #if FLUTTER_BACKEND
-  if (getDartMethod()->flushUICommand == nullptr) {
-    return JS_ThrowTypeError(ctx, "Failed to execute '__kraken_flush_ui_command__': dart method (flushUICommand) is not registered.");
-  }
-  // Flush all pending ui messages.
-  getDartMethod()->flushUICommand();
-
   if (getDartMethod()->requestAnimationFrame == nullptr) {
     return JS_ThrowTypeError(ctx, "Failed to execute 'requestAnimationFrame': dart method (requestAnimationFrame) is not registered.");
   }
@@ -125,13 +119,6 @@ JSValue Window::requestAnimationFrame(JSContext* ctx, JSValue this_val, int argc
 
   int32_t requestId = window->document()->requestAnimationFrame(frameCallback);
 
-  // `-1` represents some error occurred.
-  if (requestId == -1) {
-    return JS_ThrowTypeError(ctx,
-                             "Failed to execute 'requestAnimationFrame': dart method (requestAnimationFrame) executed "
-                             "with unexpected error.");
-  }
-
   return JS_NewUint32(ctx, requestId);
 }
 
@@ -216,17 +203,16 @@ IMPL_PROPERTY_GETTER(Window, onerror)(JSContext* ctx, JSValue this_val, int argc
 }
 IMPL_PROPERTY_SETTER(Window, onerror)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* window = static_cast<WindowInstance*>(JS_GetOpaque(this_val, 1));
-  JSValue eventString = JS_NewString(ctx, "onerror");
-  JSString* p = JS_VALUE_GET_STRING(eventString);
+  JSAtom eventType = JS_NewAtom(ctx, "error");
   JSValue onerrorHandler = argv[0];
-  window->setAttributesEventHandler(p, onerrorHandler);
+  window->setAttributesEventHandler(eventType, onerrorHandler);
 
   if (!JS_IsNull(window->onerror)) {
     JS_FreeValue(ctx, window->onerror);
   }
 
   window->onerror = JS_DupValue(ctx, onerrorHandler);
-  JS_FreeValue(ctx, eventString);
+  JS_FreeAtom(ctx, eventType);
   return JS_NULL;
 }
 
@@ -236,7 +222,7 @@ IMPL_PROPERTY_GETTER(Window, self)(JSContext* ctx, JSValue this_val, int argc, J
 
 WindowInstance::WindowInstance(Window* window) : EventTargetInstance(window, Window::kWindowClassId, "window", WINDOW_TARGET_ID) {
   if (getDartMethod()->initWindow != nullptr) {
-    getDartMethod()->initWindow(context()->getContextId(), nativeEventTarget);
+    getDartMethod()->initWindow(context()->getContextId(), &nativeEventTarget);
   }
   m_context->m_window = this;
 }
@@ -58,6 +58,40 @@ cancelAnimationFrame(id);
   TEST_runLoop(bridge->getContext());
 }
 
+TEST(Window, runAnimationFrameCallbacksTogether) {
+  bool static logCalled = false;
+  auto bridge = TEST_init();
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "a micro b d true");
+  };
+
+  std::string code = R"(
+let logs = [];
+let timestamps = [];
+requestAnimationFrame((timestamp) => {
+  logs.push('a');
+  timestamps.push(timestamp);
+  cancelAnimationFrame(c);
+  requestAnimationFrame(() => {
+    logs.push('d');
+    console.log(logs.join(' '), timestamps[0] === timestamps[1]);
+  });
+  Promise.resolve().then(() => logs.push('micro'));
+});
+requestAnimationFrame((timestamp) => {
+  logs.push('b');
+  timestamps.push(timestamp);
+});
+let c = requestAnimationFrame(() => logs.push('c'));
+)";
+
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  TEST_runLoop(bridge->getContext());
+  EXPECT_EQ(logCalled, true);
+}
+
 TEST(Window, postMessage) {
   {
     auto bridge = TEST_init();
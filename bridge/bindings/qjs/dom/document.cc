@@ -67,6 +67,10 @@ JSClassID Document::kDocumentClassID{0};
 Document::Document(ExecutionContext* context) : Node(context, "Document") {
   std::call_once(kDocumentInitOnceFlag, []() { JS_NewClassID(&kDocumentClassID); });
   JS_SetPrototype(m_ctx, m_prototypeObject, Node::instance(m_context)->prototype());
+  m_elementConstructor = Element::instance(m_context);
+  for (int tag = 0; tag < GUMBO_TAG_UNKNOWN; tag++) {
+    m_gumboTagByAtom[JS_NewAtom(m_ctx, gumbo_normalized_tagname(static_cast<GumboTag>(tag)))] = static_cast<GumboTag>(tag);
+  }
   if (!document_registered) {
     defineElement("img", ImageElement::instance(m_context));
     defineElement("a", AnchorElement::instance(m_context));
@@ -128,6 +132,12 @@ Document::Document(ExecutionContext* context) : Node(context, "Document") {
   }
 }
 
+Document::~Document() {
+  for (auto& entry : m_gumboTagByAtom) {
+    JS_FreeAtomRT(ExecutionContext::runtime(), entry.first);
+  }
+}
+
 JSClassID Document::classId() {
   return kDocumentClassID;
 }
@@ -175,13 +185,11 @@ JSValue Document::createElement(JSContext* ctx, JSValue this_val, int argc, JSVa
     return JS_ThrowTypeError(ctx, "Failed to createElement: tagName should be a string.");
   }
 
-  auto document = static_cast<DocumentInstance*>(JS_GetOpaque(this_val, Document::classId()));
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
-  std::string tagName = jsValueToStdString(ctx, tagNameValue);
-  JSValue constructor = static_cast<Document*>(document->prototype())->getElementConstructor(document->m_context, tagName);
-
-  JSValue element = JS_CallConstructor(ctx, constructor, argc, argv);
-  return element;
+  auto* document = static_cast<DocumentInstance*>(JS_GetOpaque(this_val, Document::classId()));
+  JSAtom tagNameAtom = JS_ValueToAtom(ctx, tagNameValue);
+  ElementInstance* element = static_cast<Document*>(document->prototype())->createElementInstance(tagNameAtom);
+  JS_FreeAtom(ctx, tagNameAtom);
+  return element->jsObject;
 }
 
 JSValue Document::createTextNode(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
@@ -306,18 +314,83 @@ JSValue Document::getElementsByClassName(JSContext* ctx, JSValue this_val, int a
 
 void Document::defineElement(const std::string& tagName, Element* constructor) {
   elementConstructorMap[tagName] = constructor;
-}
-
-JSValue Document::getElementConstructor(ExecutionContext* context, const std::string& tagName) {
-  if (elementConstructorMap.count(tagName) > 0)
-    return elementConstructorMap[tagName]->jsObject;
-  return Element::instance(context)->jsObject;
+  GumboTag tag = gumbo_tag_enum(tagName.c_str());
+  if (tag != GUMBO_TAG_UNKNOWN) {
+    m_elementConstructorByGumboTag[tag] = constructor;
+  }
 }
 
 bool Document::isCustomElement(const std::string& tagName) {
   return elementConstructorMap.count(tagName) > 0;
 }
 
+ElementInstance* Document::createElementByTagAtom(ExecutionContext* context, JSAtom tagName) {
+  return Document::instance(context)->createElementInstance(tagName);
+}
+
+ElementInstance* Document::createElementByGumboTag(ExecutionContext* context, GumboTag tag) {
+  return Document::instance(context)->createElementInstance(tag);
+}
+
+ElementInstance* Document::createElementByTagName(ExecutionContext* context, const std::string& tagName) {
+  return Document::instance(context)->createElementInstance(tagName);
+}
+
+ElementInstance* Document::createElementInstance(JSAtom tagName) {
+  auto it = m_gumboTagByAtom.find(tagName);
+  if (it != m_gumboTagByAtom.end()) {
+    return createElementInstance(it->second);
+  }
+
+  const char* cTagName = JS_AtomToCString(m_ctx, tagName);
+  std::string name = cTagName;
+  JS_FreeCString(m_ctx, cTagName);
+  return createElementInstance(name);
+}
+
+ElementInstance* Document::createElementInstance(GumboTag tag) {
+  Element* constructor = m_elementConstructorByGumboTag[tag];
+  if (constructor != nullptr) {
+    return createElementInstance(constructor);
+  }
+
+  if (m_elementPool != nullptr) {
+    ElementInstance* recycled = m_elementPool->take(tag);
+    if (recycled != nullptr)
+      return recycled;
+  }
+
+  auto* element = new ElementInstance(m_elementConstructor, gumbo_normalized_tagname(tag), true);
+  if (m_elementPool != nullptr) {
+    element->setNodeFlag(NodeInstance::NodeFlag::IsRecyclable);
+  }
+  return element;
+}
+
+void Document::setElementRecyclingCapacity(uint32_t capacity) {
+  if (capacity == 0) {
+    m_elementPool = nullptr;
+  } else if (m_elementPool == nullptr) {
+    m_elementPool = std::make_unique<ElementPool>(capacity);
+  } else {
+    m_elementPool->setCapacity(capacity);
+  }
+}
+
+ElementInstance* Document::createElementInstance(const std::string& tagName) {
+  auto it = elementConstructorMap.find(tagName);
+  if (it != elementConstructorMap.end()) {
+    return createElementInstance(it->second);
+  }
+  return new ElementInstance(m_elementConstructor, tagName, true);
+}
+
+ElementInstance* Document::createElementInstance(Element* constructor) {
+  // Registered elements construct their own instance with a fixed tag name, call it directly instead of JS_CallConstructor.
+  JSValue instance = constructor->instanceConstructor(m_ctx, constructor->jsObject, constructor->jsObject, 0, nullptr);
+  return static_cast<ElementInstance*>(JS_GetOpaque(instance, Element::classId()));
+}
+
 IMPL_PROPERTY_GETTER(Document, location)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* document = static_cast<DocumentInstance*>(JS_GetOpaque(this_val, Document::classId()));
   return JS_GetPropertyStr(ctx, document->m_context->global(), "location");
@@ -528,13 +601,16 @@ void DocumentCookie::setCookie(std::string& cookieStr) {
 DocumentInstance::DocumentInstance(Document* document) : NodeInstance(document, NodeType::DOCUMENT_NODE, Document::classId(), "document") {
   m_context->m_document = this;
   m_document = this;
+  setNodeFlag(NodeFlag::IsConnected);
   m_cookie = std::make_unique<DocumentCookie>();
+  // Document has a reserved id, give back the one allocated by NodeInstance.
+  m_context->eventTargetIds()->free(m_eventTargetId);
   m_eventTargetId = DOCUMENT_TARGET_ID;
 
   m_scriptAnimationController = makeGarbageCollected<ScriptAnimationController>()->initialize(m_ctx, &ScriptAnimationController::classId);
 
 #if FLUTTER_BACKEND
-  getDartMethod()->initDocument(m_context->getContextId(), nativeEventTarget);
+  getDartMethod()->initDocument(m_context->getContextId(), &nativeEventTarget);
 #endif
 }
 
@@ -546,6 +622,12 @@ DocumentInstance::~DocumentInstance() {
     // Note: someone may be curious why there are no JS_FreeValueRT() call in this finalize callbacks.
     // m_elementMapById's value are all elements, which are JavaScript objects. Will be freed by GC at marking phase.
   }
+  for (JSValue observer : m_pendingMutationObservers) {
+    JS_FreeValueRT(m_context->runtime(), observer);
+  }
+  for (JSValue observer : m_pendingIntersectionObservers) {
+    JS_FreeValueRT(m_context->runtime(), observer);
+  }
 }
 void DocumentInstance::removeElementById(JSAtom id, ElementInstance* element) {
   if (m_elementMapById.count(id) > 0) {
@@ -594,8 +676,18 @@ void DocumentInstance::cancelAnimationFrame(uint32_t callbackId) {
   m_scriptAnimationController->cancelFrameCallback(callbackId);
 }
 
+EventCoalescer* DocumentInstance::ensureEventCoalescer() {
+  if (m_eventCoalescer == nullptr) {
+    m_eventCoalescer = std::make_unique<EventCoalescer>(this);
+  }
+  return m_eventCoalescer.get();
+}
+
 void DocumentInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
   NodeInstance::trace(rt, val, mark_func);
+  if (m_eventCoalescer != nullptr) {
+    m_eventCoalescer->trace(rt, val, mark_func);
+  }
   // Trace scriptAnimationController
   if (m_scriptAnimationController != nullptr) {
     JS_MarkValue(rt, m_scriptAnimationController->toQuickJS(), mark_func);
@@ -606,6 +698,12 @@ void DocumentInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func)
       JS_MarkValue(rt, value->jsObject, mark_func);
     }
   }
+  for (JSValue observer : m_pendingMutationObservers) {
+    JS_MarkValue(rt, observer, mark_func);
+  }
+  for (JSValue observer : m_pendingIntersectionObservers) {
+    JS_MarkValue(rt, observer, mark_func);
+  }
 }
 
 }  // namespace kraken::binding::qjs
@@ -6,10 +6,14 @@
 #ifndef KRAKENBRIDGE_DOCUMENT_H
 #define KRAKENBRIDGE_DOCUMENT_H
 
+#include <array>
 #include "element.h"
+#include "element_pool.h"
+#include "event_coalescer.h"
 #include "frame_request_callback_collection.h"
 #include "node.h"
 #include "script_animation_controller.h"
+#include "third_party/gumbo-parser/src/gumbo.h"
 
 namespace kraken::binding::qjs {
 
@@ -25,6 +29,7 @@ class Document : public Node {
 
   Document() = delete;
   Document(ExecutionContext* context);
+  ~Document() override;
 
   static JSClassID classId();
 
@@ -41,9 +46,17 @@ class Document : public Node {
   static JSValue getElementsByTagName(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
   static JSValue getElementsByClassName(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
-  JSValue getElementConstructor(ExecutionContext* context, const std::string& tagName);
   bool isCustomElement(const std::string& tagName);
 
+  // Create elements natively from a precomputed tag table, without re-entering JavaScript constructors.
+  static ElementInstance* createElementByTagAtom(ExecutionContext* context, JSAtom tagName);
+  static ElementInstance* createElementByGumboTag(ExecutionContext* context, GumboTag tag);
+  static ElementInstance* createElementByTagName(ExecutionContext* context, const std::string& tagName);
+
+  // Opt-in reuse of finalized generic elements, keep at most capacity elements for each tag, 0 to disable.
+  void setElementRecyclingCapacity(uint32_t capacity);
+  inline ElementPool* elementPool() const { return m_elementPool.get(); }
+
  private:
   DEFINE_PROTOTYPE_READONLY_PROPERTY(nodeName);
   DEFINE_PROTOTYPE_READONLY_PROPERTY(all);
@@ -65,12 +78,21 @@ class Document : public Node {
   DEFINE_PROTOTYPE_FUNCTION(getElementsByClassName, 1);
 
   void defineElement(const std::string& tagName, Element* constructor);
+  ElementInstance* createElementInstance(JSAtom tagName);
+  ElementInstance* createElementInstance(GumboTag tag);
+  ElementInstance* createElementInstance(const std::string& tagName);
+  ElementInstance* createElementInstance(Element* constructor);
 
   friend DocumentInstance;
 
   bool event_registered{false};
   bool document_registered{false};
   std::unordered_map<std::string, Element*> elementConstructorMap;
+  Element* m_elementConstructor{nullptr};
+  // Tag atoms of all known HTML tags, and element constructors indexed by gumbo tag (nullptr for plain Element).
+  std::unordered_map<JSAtom, GumboTag> m_gumboTagByAtom;
+  std::unique_ptr<ElementPool> m_elementPool;
+  std::array<Element*, GUMBO_TAG_LAST> m_elementConstructorByGumboTag{};
 };
 
 class DocumentCookie {
@@ -94,6 +116,11 @@ class DocumentInstance : public NodeInstance {
   void cancelAnimationFrame(uint32_t callbackId);
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
 
+  // Null until a continuous event arrives from dart.
+  FORCE_INLINE EventCoalescer* eventCoalescer() const { return m_eventCoalescer.get(); }
+  FORCE_INLINE ScriptAnimationController* scriptAnimationController() const { return m_scriptAnimationController; }
+  EventCoalescer* ensureEventCoalescer();
+
  private:
   void removeElementById(JSAtom id, ElementInstance* element);
   void addElementById(JSAtom id, ElementInstance* element);
@@ -103,10 +130,17 @@ class DocumentInstance : public NodeInstance {
   std::unique_ptr<DocumentCookie> m_cookie;
 
   ScriptAnimationController* m_scriptAnimationController;
+  std::unique_ptr<EventCoalescer> m_eventCoalescer;
+  // MutationObservers with records to deliver at the next microtask checkpoint.
+  std::vector<JSValue> m_pendingMutationObservers;
+  // IntersectionObservers with entries to deliver at the next frame.
+  std::vector<JSValue> m_pendingIntersectionObservers;
 
   friend Document;
   friend ElementInstance;
   friend ExecutionContext;
+  friend MutationObserverInstance;
+  friend IntersectionObserverInstance;
 };
 
 }  // namespace kraken::binding::qjs
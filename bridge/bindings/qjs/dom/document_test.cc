@@ -75,3 +75,128 @@ TEST(Document, createElementShouldWorkWithMultipleContext) {
 
   delete bridge1;
 }
+
+TEST(Document, createElementByRegisteredTagName) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "true true true false DIV my-element true true link my-element 2");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let a = document.createElement('a');"
+      "let img = document.createElement('img');"
+      "let upperDiv = document.createElement('DIV');"
+      "let custom = document.createElement('my-element');"
+      "let container = document.createElement('div');"
+      "container.innerHTML = '<a href=\"#\" title=\"link\"></a><my-element data-count=\"2\"></my-element>';"
+      "let parsedBody = container.lastChild;"
+      "let parsedAnchor = parsedBody.firstChild;"
+      "let parsedCustom = parsedBody.lastChild;"
+      "console.log(a instanceof HTMLAnchorElement, img instanceof HTMLImageElement, upperDiv instanceof Element, "
+      "upperDiv instanceof HTMLAnchorElement, upperDiv.tagName, custom.tagName.toLowerCase(), "
+      "parsedAnchor instanceof HTMLAnchorElement, parsedCustom instanceof Element, "
+      "parsedAnchor.getAttribute('title'), parsedCustom.tagName.toLowerCase(), parsedCustom.getAttribute('data-count'));";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Document, getElementByIdFollowsConnectedSubtrees) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "false true true true false true true false true");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code = R"(
+let list = document.createElement('div');
+let item = document.createElement('div');
+let img = document.createElement('img');
+img.setAttribute('id', 'avatar');
+item.appendChild(img);
+list.appendChild(item);
+let detached = document.getElementById('avatar') === img;
+
+document.body.appendChild(list);
+let attached = document.getElementById('avatar') === img && img.isConnected;
+
+img.setAttribute('id', 'photo');
+let renamed = document.getElementById('photo') === img && document.getElementById('avatar') === null;
+
+let other = document.createElement('div');
+document.body.appendChild(other);
+other.appendChild(item);
+let moved = document.getElementById('photo') === img && img.isConnected;
+
+list.remove();
+other.remove();
+let removed = document.getElementById('photo') === null;
+
+console.log(detached, attached, renamed, moved, img.isConnected, removed, document.body.isConnected, list.isConnected, document.isConnected);
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Document, moveSubtreesKeepsIdsAndConnectedState) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "true true true true true true");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code = R"(
+let first = document.createElement('div');
+let second = document.createElement('div');
+document.body.appendChild(first);
+document.body.appendChild(second);
+
+let item = document.createElement('div');
+let label = document.createElement('span');
+label.setAttribute('id', 'label');
+item.appendChild(label);
+first.appendChild(item);
+
+// Moving between connected parents keeps the subtree connected and registered.
+second.appendChild(item);
+let moved = label.isConnected && document.getElementById('label') === label;
+second.insertBefore(document.createElement('p'), item);
+second.replaceChild(document.createElement('p'), second.firstChild);
+let kept = label.isConnected && document.getElementById('label') === label;
+
+// Moving into a detached tree disconnects it.
+let detached = document.createElement('div');
+detached.appendChild(item);
+let disconnected = !label.isConnected && document.getElementById('label') === null;
+
+// Subtrees whose ids are gone are attached without registering anything.
+label.removeAttribute('id');
+document.body.appendChild(detached);
+let plain = document.getElementById('label') === null;
+
+label.setAttribute('id', 'label');
+let registered = label.isConnected && document.getElementById('label') === label;
+document.body.removeChild(detached);
+let removed = document.getElementById('label') === null && !item.isConnected;
+console.log(moved, kept, disconnected, plain, registered, removed);
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
@@ -6,9 +6,13 @@
 #include "element.h"
 #include "bindings/qjs/bom/blob.h"
 #include "bindings/qjs/html_parser.h"
+#include "bindings/qjs/html_serializer.h"
 #include "dart_methods.h"
 #include "document.h"
 #include "elements/template_element.h"
+#include "intersection_observer.h"
+#include "mutation_observer.h"
+#include "resize_observer.h"
 #include "text_node.h"
 
 #if UNIT_TEST
@@ -26,22 +30,12 @@ void bindElement(ExecutionContext* context) {
   context->defineGlobalProperty("HTMLElement", JS_DupValue(context->ctx(), constructor->jsObject));
 }
 
-bool isJavaScriptExtensionElementInstance(ExecutionContext* context, JSValue instance) {
-  if (JS_IsInstanceOf(context->ctx(), instance, Element::instance(context)->jsObject)) {
-    auto* elementInstance = static_cast<ElementInstance*>(JS_GetOpaque(instance, Element::classId()));
-    std::string tagName = elementInstance->getRegisteredTagName();
+static bool isJavaScriptExtensionElementTagName(const std::string& tagName) {
+  // Special case for kraken official plugins.
+  if (tagName == "video" || tagName == "iframe")
+    return true;
 
-    // Special case for kraken official plugins.
-    if (tagName == "video" || tagName == "iframe")
-      return true;
-
-    for (char i : tagName) {
-      if (i == '-')
-        return true;
-    }
-  }
-
-  return false;
+  return tagName.find('-') != std::string::npos;
 }
 
 JSClassID Element::kElementClassId{0};
@@ -108,25 +102,13 @@ void ElementAttributes::copyWith(ElementAttributes* attributes) {
   for (auto& attr : attributes->m_attributes) {
     m_attributes[attr.first] = JS_DupValue(m_ctx, attr.second);
   }
+  *m_className = *attributes->m_className;
 }
 
 std::shared_ptr<SpaceSplitString> ElementAttributes::className() {
   return m_className;
 }
 
-std::string ElementAttributes::toString() {
-  std::string s;
-
-  for (auto& attr : m_attributes) {
-    s += attr.first + "=";
-    const char* pstr = JS_ToCString(m_ctx, attr.second);
-    s += "\"" + std::string(pstr) + "\"";
-    JS_FreeCString(m_ctx, pstr);
-  }
-
-  return s;
-}
-
 void ElementAttributes::dispose() const {
   for (auto& attr : m_attributes) {
     JS_FreeValueRT(m_runtime, attr.second);
@@ -152,7 +134,7 @@ JSValue Element::instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue t
 
   auto* Document = Document::instance(context);
   if (Document->isCustomElement(name)) {
-    return JS_CallConstructor(ctx, Document->getElementConstructor(context, name), argc, argv);
+    return Document::createElementByTagName(context, name)->jsObject;
   }
 
   auto* element = new ElementInstance(this, name, true);
@@ -177,7 +159,7 @@ JSValue Element::hasAttribute(JSContext* ctx, JSValue this_val, int argc, JSValu
   }
 
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
-  auto* attributes = element->m_attributes;
+  auto* attributes = element->attributes();
 
   const char* cname = JS_ToCString(ctx, nameValue);
   std::string name = std::string(cname);
@@ -194,40 +176,22 @@ JSValue Element::setAttribute(JSContext* ctx, JSValue this_val, int argc, JSValu
   }
 
   JSValue nameValue = argv[0];
-  JSValue attributeValue = JS_ToString(ctx, argv[1]);
 
   if (!JS_IsString(nameValue)) {
     return JS_ThrowTypeError(ctx, "Failed to execute 'setAttribute' on 'Element': name attribute is not valid.");
   }
 
+  JSValue attributeValue = JS_ToString(ctx, argv[1]);
+  if (JS_IsException(attributeValue))
+    return attributeValue;
+
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
   std::string name = jsValueToStdString(ctx, nameValue);
   std::transform(name.begin(), name.end(), name.begin(), ::tolower);
 
-  auto* attributes = element->m_attributes;
-
-  if (attributes->hasAttribute(name)) {
-    JSValue oldAttribute = attributes->getAttribute(name);
-    JSValue exception = attributes->setAttribute(name, attributeValue);
-    if (JS_IsException(exception))
-      return exception;
-    element->_didModifyAttribute(name, oldAttribute, attributeValue);
-    JS_FreeValue(ctx, oldAttribute);
-  } else {
-    JSValue exception = attributes->setAttribute(name, attributeValue);
-    if (JS_IsException(exception))
-      return exception;
-    element->_didModifyAttribute(name, JS_NULL, attributeValue);
-  }
-
-  std::unique_ptr<NativeString> args_01 = stringToNativeString(name);
-  std::unique_ptr<NativeString> args_02 = jsValueToNativeString(ctx, attributeValue);
-
-  element->m_context->uiCommandBuffer()->addCommand(element->m_eventTargetId, UICommand::setProperty, *args_01, *args_02, nullptr);
-
+  JSValue result = element->internalSetAttribute(name, attributeValue);
   JS_FreeValue(ctx, attributeValue);
-
-  return JS_NULL;
+  return result;
 }
 
 JSValue Element::getAttribute(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
@@ -244,7 +208,7 @@ JSValue Element::getAttribute(JSContext* ctx, JSValue this_val, int argc, JSValu
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
   std::string name = jsValueToStdString(ctx, nameValue);
 
-  auto* attributes = element->m_attributes;
+  auto* attributes = element->attributes();
 
   if (attributes->hasAttribute(name)) {
     return attributes->getAttribute(name);
@@ -266,11 +230,11 @@ JSValue Element::removeAttribute(JSContext* ctx, JSValue this_val, int argc, JSV
 
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
   std::string name = jsValueToStdString(ctx, nameValue);
-  auto* attributes = element->m_attributes;
+  auto* attributes = element->attributes();
 
   if (attributes->hasAttribute(name)) {
     JSValue targetValue = attributes->getAttribute(name);
-    element->m_attributes->removeAttribute(name);
+    element->attributes()->removeAttribute(name);
     element->_didModifyAttribute(name, targetValue, JS_NULL);
     JS_FreeValue(ctx, targetValue);
 
@@ -402,15 +366,17 @@ IMPL_PROPERTY_GETTER(Element, tagName)(JSContext* ctx, JSValue this_val, int arg
 
 IMPL_PROPERTY_GETTER(Element, className)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
-  return element->m_attributes->getAttribute("class");
+  return element->attributes()->getAttribute("class");
 }
 IMPL_PROPERTY_SETTER(Element, className)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
-  element->m_attributes->setAttribute("class", argv[0]);
-  std::unique_ptr<NativeString> args_01 = stringToNativeString("class");
-  std::unique_ptr<NativeString> args_02 = jsValueToNativeString(ctx, argv[0]);
-  element->m_context->uiCommandBuffer()->addCommand(element->m_eventTargetId, UICommand::setProperty, *args_01, *args_02, nullptr);
-  return JS_NULL;
+  std::string name = "class";
+  JSValue value = JS_ToString(ctx, argv[0]);
+  if (JS_IsException(value))
+    return value;
+  JSValue result = element->internalSetAttribute(name, value);
+  JS_FreeValue(ctx, value);
+  return result;
 }
 
 enum class ViewModuleProperty { offsetTop, offsetLeft, offsetWidth, offsetHeight, clientWidth, clientHeight, clientTop, clientLeft, scrollTop, scrollLeft, scrollHeight, scrollWidth };
@@ -545,6 +511,12 @@ IMPL_PROPERTY_GETTER(Element, lastElementChild)(JSContext* ctx, JSValue this_val
   return JS_NULL;
 }
 
+IMPL_PROPERTY_GETTER(Element, style)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
+  element->ensureStyle();
+  return JS_DupValue(ctx, element->m_style);
+}
+
 IMPL_PROPERTY_GETTER(Element, children)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
   JSValue array = JS_NewArray(ctx);
@@ -569,12 +541,12 @@ IMPL_PROPERTY_GETTER(Element, children)(JSContext* ctx, JSValue this_val, int ar
 
 IMPL_PROPERTY_GETTER(Element, attributes)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
-  return JS_DupValue(ctx, element->m_attributes->toQuickJS());
+  return JS_DupValue(ctx, element->m_attributes);
 }
 
 IMPL_PROPERTY_GETTER(Element, innerHTML)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
-  return JS_NewString(ctx, element->innerHTML().c_str());
+  return HTMLSerializer::innerHTML(element);
 }
 IMPL_PROPERTY_SETTER(Element, innerHTML)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
@@ -593,7 +565,7 @@ IMPL_PROPERTY_SETTER(Element, innerHTML)(JSContext* ctx, JSValue this_val, int a
 
 IMPL_PROPERTY_GETTER(Element, outerHTML)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* element = static_cast<ElementInstance*>(JS_GetOpaque(this_val, Element::classId()));
-  return JS_NewString(ctx, element->outerHTML().c_str());
+  return HTMLSerializer::outerHTML(element);
 }
 IMPL_PROPERTY_SETTER(Element, outerHTML)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   return JS_NULL;
@@ -603,33 +575,29 @@ JSClassID ElementInstance::classID() {
   return Element::classId();
 }
 
-ElementInstance::~ElementInstance() {}
-
-JSValue ElementInstance::internalGetTextContent() {
-  JSValue array = JS_NewArray(m_ctx);
-  JSValue pushMethod = JS_GetPropertyStr(m_ctx, array, "push");
-
-  int32_t len = arrayGetLength(m_ctx, childNodes);
+ElementInstance::~ElementInstance() {
+  // JSContext may already been freed when instances are collected by the last GC of context.
+  JS_FreeValueRT(ExecutionContext::runtime(), m_attributes);
+  JS_FreeValueRT(ExecutionContext::runtime(), m_style);
+  clearIntersectionObserverRegistrations();
+  clearResizeObserverRegistrations();
+}
 
-  for (int i = 0; i < len; i++) {
-    JSValue n = JS_GetPropertyUint32(m_ctx, childNodes, i);
-    auto* node = static_cast<NodeInstance*>(JS_GetOpaque(n, Node::classId(n)));
-    JSValue nodeText = node->internalGetTextContent();
-    JS_Call(m_ctx, pushMethod, array, 1, &nodeText);
-    JS_FreeValue(m_ctx, nodeText);
-    JS_FreeValue(m_ctx, n);
+void ElementInstance::clearIntersectionObserverRegistrations() {
+  // Only observed elements have registrations in the side table of the context.
+  if (hasNodeFlag(NodeFlag::IsIntersectionObserved)) {
+    IntersectionObserverInstance::clearRegistrations(this);
   }
+}
 
-  JSValue joinMethod = JS_GetPropertyStr(m_ctx, array, "join");
-  JSValue emptyString = JS_NewString(m_ctx, "");
-  JSValue joinArgs[] = {emptyString};
-  JSValue returnValue = JS_Call(m_ctx, joinMethod, array, 1, joinArgs);
+void ElementInstance::clearResizeObserverRegistrations() {
+  if (hasNodeFlag(NodeFlag::IsResizeObserved)) {
+    ResizeObserverInstance::clearRegistrations(this);
+  }
+}
 
-  JS_FreeValue(m_ctx, array);
-  JS_FreeValue(m_ctx, pushMethod);
-  JS_FreeValue(m_ctx, joinMethod);
-  JS_FreeValue(m_ctx, emptyString);
-  return returnValue;
+JSValue ElementInstance::internalGetTextContent() {
+  return HTMLSerializer::textContent(this);
 }
 
 void ElementInstance::internalSetTextContent(JSValue content) {
@@ -642,7 +610,7 @@ void ElementInstance::internalSetTextContent(JSValue content) {
 }
 
 std::shared_ptr<SpaceSplitString> ElementInstance::classNames() {
-  return m_attributes->className();
+  return attributes()->className();
 }
 
 std::string SpaceSplitString::m_delimiter{" "};
@@ -705,77 +673,10 @@ std::string ElementInstance::getRegisteredTagName() {
   return m_tagName;
 }
 
-std::string ElementInstance::outerHTML() {
-  std::string s = "<" + getRegisteredTagName();
-
-  // Read attributes
-  std::string attributes = m_attributes->toString();
-  // Read style
-  std::string style = m_style->toString();
-
-  if (!attributes.empty()) {
-    s += " " + attributes;
-  }
-  if (!style.empty()) {
-    s += " style=\"" + style;
-  }
-
-  s += ">";
-
-  std::string childHTML = innerHTML();
-  s += childHTML;
-  s += "</" + getRegisteredTagName() + ">";
-
-  return s;
-}
-
-std::string ElementInstance::innerHTML() {
-  std::string s;
-
-  // If Element is TemplateElement, the innerHTML content is the content of documentFragment.
-  NodeInstance* parent = this;
-  if (hasNodeFlag(NodeInstance::NodeFlag::IsTemplateElement)) {
-    parent = static_cast<TemplateElementInstance*>(this)->content();
-  }
-
-  // Children toString
-  int32_t childLen = arrayGetLength(m_ctx, parent->childNodes);
-
-  if (childLen == 0)
-    return s;
-
-  for (int i = 0; i < childLen; i++) {
-    JSValue c = JS_GetPropertyUint32(m_ctx, parent->childNodes, i);
-    auto* node = static_cast<NodeInstance*>(JS_GetOpaque(c, Node::classId(c)));
-    if (node->nodeType == NodeType::ELEMENT_NODE) {
-      s += reinterpret_cast<ElementInstance*>(node)->outerHTML();
-    } else if (node->nodeType == NodeType::TEXT_NODE) {
-      s += reinterpret_cast<TextNodeInstance*>(node)->toString();
-    }
-
-    JS_FreeValue(m_ctx, c);
-  }
-  return s;
-}
-
-void ElementInstance::_notifyNodeRemoved(NodeInstance* insertionNode) {
-  if (insertionNode->isConnected()) {
-    traverseNode(this, [](NodeInstance* node) {
-      auto* Element = Element::instance(node->m_context);
-      if (node->prototype() == Element) {
-        auto element = reinterpret_cast<ElementInstance*>(node);
-        element->_notifyChildRemoved();
-      }
-
-      return false;
-    });
-  }
-}
-
 void ElementInstance::_notifyChildRemoved() {
   std::string prop = "id";
-  if (m_attributes->hasAttribute(prop)) {
-    JSValue idValue = m_attributes->getAttribute(prop);
+  if (attributes()->hasAttribute(prop)) {
+    JSValue idValue = attributes()->getAttribute(prop);
     JSAtom id = JS_ValueToAtom(m_ctx, idValue);
     document()->removeElementById(id, this);
     JS_FreeValue(m_ctx, idValue);
@@ -783,24 +684,10 @@ void ElementInstance::_notifyChildRemoved() {
   }
 }
 
-void ElementInstance::_notifyNodeInsert(NodeInstance* insertNode) {
-  if (insertNode->isConnected()) {
-    traverseNode(this, [](NodeInstance* node) {
-      auto* Element = Element::instance(node->m_context);
-      if (node->prototype() == Element) {
-        auto element = reinterpret_cast<ElementInstance*>(node);
-        element->_notifyChildInsert();
-      }
-
-      return false;
-    });
-  }
-}
-
 void ElementInstance::_notifyChildInsert() {
   std::string prop = "id";
-  if (m_attributes->hasAttribute(prop)) {
-    JSValue idValue = m_attributes->getAttribute(prop);
+  if (attributes()->hasAttribute(prop)) {
+    JSValue idValue = attributes()->getAttribute(prop);
     JSAtom id = JS_ValueToAtom(m_ctx, idValue);
     document()->addElementById(id, this);
     JS_FreeValue(m_ctx, idValue);
@@ -810,11 +697,25 @@ void ElementInstance::_notifyChildInsert() {
 
 void ElementInstance::_didModifyAttribute(std::string& name, JSValue oldId, JSValue newId) {
   if (name == "id") {
+    if (JS_IsNull(newId)) {
+      removeNodeFlag(NodeFlag::HasIdAttribute);
+    } else {
+      setNodeFlag(NodeFlag::HasIdAttribute);
+      markSubtreeHasIdAttribute();
+    }
     _beforeUpdateId(oldId, newId);
   }
+
+  if (UNLIKELY(m_context->hasMutationObservers())) {
+    MutationObserverInstance::queueAttributeRecord(this, name, oldId);
+  }
 }
 
 void ElementInstance::_beforeUpdateId(JSValue oldIdValue, JSValue newIdValue) {
+  // Elements are registered to the id map when connected, and unregistered when disconnected.
+  if (!isConnected())
+    return;
+
   JSAtom oldId = JS_ValueToAtom(m_ctx, oldIdValue);
   JSAtom newId = JS_ValueToAtom(m_ctx, newIdValue);
 
@@ -837,31 +738,110 @@ void ElementInstance::_beforeUpdateId(JSValue oldIdValue, JSValue newIdValue) {
 }
 
 void ElementInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
-  if (m_attributes != nullptr) {
-    JS_MarkValue(rt, m_attributes->toQuickJS(), mark_func);
+  JS_MarkValue(rt, m_attributes, mark_func);
+  JS_MarkValue(rt, m_style, mark_func);
+  if (hasNodeFlag(NodeFlag::IsIntersectionObserved)) {
+    IntersectionObserverInstance::traceRegistrations(this, rt, mark_func);
+  }
+  if (hasNodeFlag(NodeFlag::IsResizeObserved)) {
+    ResizeObserverInstance::traceRegistrations(this, rt, mark_func);
   }
   NodeInstance::trace(rt, val, mark_func);
 }
 
 ElementInstance::ElementInstance(Element* element, std::string tagName, bool shouldAddUICommand)
     : m_tagName(tagName), NodeInstance(element, NodeType::ELEMENT_NODE, Element::classId(), exoticMethods, "Element") {
-  m_attributes = makeGarbageCollected<ElementAttributes>()->initialize(m_ctx, &ElementAttributes::classId);
-  JSValue arguments[] = {jsObject};
-  JSValue style = JS_CallConstructor(m_ctx, CSSStyleDeclaration::instance(m_context)->jsObject, 1, arguments);
-  m_style = static_cast<StyleDeclarationInstance*>(JS_GetOpaque(style, CSSStyleDeclaration::kCSSStyleDeclarationClassId));
-
-  JS_DefinePropertyValueStr(m_ctx, jsObject, "style", m_style->jsObject, JS_PROP_C_W_E);
+  m_attributes = makeGarbageCollected<ElementAttributes>()->initialize(m_ctx, &ElementAttributes::classId)->toQuickJS();
+  m_isJavaScriptExtensionElement = isJavaScriptExtensionElementTagName(tagName);
 
   if (shouldAddUICommand) {
     std::unique_ptr<NativeString> args_01 = stringToNativeString(tagName);
-    element->m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::createElement, *args_01, nativeEventTarget);
+    element->m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::createElement, *args_01, &nativeEventTarget);
   }
 }
 
+bool ElementInstance::recycle() {
+  // All instances are deleted as usual when the context is disposing.
+  if (!hasNodeFlag(NodeFlag::IsRecyclable) || !m_context->isValid())
+    return false;
+
+  ElementPool* pool = static_cast<Document*>(document()->prototype())->elementPool();
+  return pool != nullptr && pool->recycle(this);
+}
+
+void ElementInstance::resetForRecycle() {
+  // The jsObject is being finalized, values below may be released by the same GC cycle.
+  JSRuntime* runtime = ExecutionContext::runtime();
+  JS_FreeValueRT(runtime, childNodes);
+  JS_FreeValueRT(runtime, parentNode);
+  JS_FreeValueRT(runtime, m_attributes);
+  JS_FreeValueRT(runtime, m_style);
+  clearMutationObserverRegistrations();
+  clearIntersectionObserverRegistrations();
+  clearResizeObserverRegistrations();
+  childNodes = JS_NULL;
+  parentNode = JS_NULL;
+  m_attributes = JS_NULL;
+  m_style = JS_NULL;
+  jsObject = JS_NULL;
+  m_eventListenerMap.reset();
+  m_eventHandlerMap.reset();
+  m_properties.reset();
+  m_nodeFlags = static_cast<uint32_t>(NodeFlag::IsRecyclable);
+
+  // Dart element is kept with the same id, only clear its children, styles, properties and events.
+  m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::resetElement, nullptr);
+}
+
+void ElementInstance::reviveFromRecycle() {
+  jsObject = JS_NewObjectProtoClass(m_ctx, m_hostClass->prototype(), Element::classId());
+  JS_SetOpaque(jsObject, this);
+  childNodes = JS_NewArray(m_ctx);
+  m_attributes = makeGarbageCollected<ElementAttributes>()->initialize(m_ctx, &ElementAttributes::classId)->toQuickJS();
+}
+
 JSClassExoticMethods ElementInstance::exoticMethods{nullptr, nullptr, nullptr, nullptr, hasProperty, getProperty, setProperty};
 
+ElementAttributes* ElementInstance::attributes() {
+  return static_cast<ElementAttributes*>(JS_GetOpaque(m_attributes, ElementAttributes::classId));
+}
+
+JSValue ElementInstance::internalSetAttribute(std::string& name, JSValue value) {
+  auto* attributes = this->attributes();
+
+  if (attributes->hasAttribute(name)) {
+    JSValue oldAttribute = attributes->getAttribute(name);
+    JSValue exception = attributes->setAttribute(name, value);
+    if (JS_IsException(exception)) {
+      JS_FreeValue(m_ctx, oldAttribute);
+      return exception;
+    }
+    _didModifyAttribute(name, oldAttribute, value);
+    JS_FreeValue(m_ctx, oldAttribute);
+  } else {
+    JSValue exception = attributes->setAttribute(name, value);
+    if (JS_IsException(exception))
+      return exception;
+    _didModifyAttribute(name, JS_NULL, value);
+  }
+
+  std::unique_ptr<NativeString> args_01 = stringToNativeString(name);
+  std::unique_ptr<NativeString> args_02 = jsValueToNativeString(m_ctx, value);
+  m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::setProperty, *args_01, *args_02, nullptr);
+
+  return JS_NULL;
+}
+
 StyleDeclarationInstance* ElementInstance::style() {
-  return m_style;
+  return static_cast<StyleDeclarationInstance*>(JS_GetOpaque(m_style, CSSStyleDeclaration::kCSSStyleDeclarationClassId));
+}
+
+StyleDeclarationInstance* ElementInstance::ensureStyle() {
+  if (JS_IsNull(m_style)) {
+    JSValue arguments[] = {jsObject};
+    m_style = JS_CallConstructor(m_ctx, CSSStyleDeclaration::instance(m_context)->jsObject, 1, arguments);
+  }
+  return style();
 }
 
 IMPL_PROPERTY_GETTER(BoundingClientRect, x)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
@@ -19,6 +19,9 @@ void bindElement(ExecutionContext* context);
 class ElementInstance;
 
 class Element;
+class Document;
+class HTMLSerializer;
+class ElementPool;
 
 using ElementCreator = ElementInstance* (*)(Element* element, std::string tagName);
 
@@ -58,20 +61,19 @@ class ElementAttributes : public GarbageCollected<ElementAttributes> {
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const override;
 
   JSValue getAttribute(const std::string& name);
+  // Values are strings, callers convert them first so reading attributes never runs scripts.
   JSValue setAttribute(const std::string& name, JSValue value);
   bool hasAttribute(std::string& name);
   void removeAttribute(std::string& name);
   void copyWith(ElementAttributes* attributes);
   std::shared_ptr<SpaceSplitString> className();
-  std::string toString();
 
  private:
   std::unordered_map<std::string, JSValue> m_attributes;
   std::shared_ptr<SpaceSplitString> m_className{std::make_shared<SpaceSplitString>("")};
+  friend HTMLSerializer;
 };
 
-bool isJavaScriptExtensionElementInstance(ExecutionContext* context, JSValue instance);
-
 class Element : public Node {
  public:
   static JSClassID kElementClassId;
@@ -111,6 +113,7 @@ class Element : public Node {
   DEFINE_PROTOTYPE_READONLY_PROPERTY(lastElementChild);
   DEFINE_PROTOTYPE_READONLY_PROPERTY(children);
   DEFINE_PROTOTYPE_READONLY_PROPERTY(attributes);
+  DEFINE_PROTOTYPE_READONLY_PROPERTY(style);
 
   DEFINE_PROTOTYPE_PROPERTY(className);
   DEFINE_PROTOTYPE_PROPERTY(innerHTML);
@@ -147,9 +150,12 @@ class ElementInstance : public NodeInstance {
   std::shared_ptr<SpaceSplitString> classNames();
   std::string tagName();
   std::string getRegisteredTagName();
-  std::string outerHTML();
-  std::string innerHTML();
+  ElementAttributes* attributes();
+  JSValue internalSetAttribute(std::string& name, JSValue value);
+  // Most elements never have inline styles, style declaration is created at first use.
+  // Use ensureStyle() to get a writable style, style() returns nullptr before that.
   StyleDeclarationInstance* style();
+  StyleDeclarationInstance* ensureStyle();
 
   static inline JSClassID classID();
 
@@ -159,20 +165,28 @@ class ElementInstance : public NodeInstance {
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
 
  private:
-  void _notifyNodeRemoved(NodeInstance* node) override;
   void _notifyChildRemoved();
-  void _notifyNodeInsert(NodeInstance* insertNode) override;
   void _notifyChildInsert();
   void _didModifyAttribute(std::string& name, JSValue oldId, JSValue newId);
   void _beforeUpdateId(JSValue oldIdValue, JSValue newIdValue);
 
+  bool recycle() override;
+  // Release everything reachable from javascript before kept by ElementPool, and create a new jsObject when reused.
+  void resetForRecycle();
+  void reviveFromRecycle();
+  void clearIntersectionObserverRegistrations();
+  void clearResizeObserverRegistrations();
+
   std::string m_tagName;
   friend Element;
+  friend ElementPool;
   friend NodeInstance;
   friend Node;
   friend DocumentInstance;
-  StyleDeclarationInstance* m_style{nullptr};
-  ElementAttributes* m_attributes{nullptr};
+  friend Document;
+  friend HTMLSerializer;
+  JSValue m_style{JS_NULL};
+  JSValue m_attributes{JS_NULL};
 
   static JSClassExoticMethods exoticMethods;
 };
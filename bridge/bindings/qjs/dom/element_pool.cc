@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "element_pool.h"
+#include "element.h"
+
+namespace kraken::binding::qjs {
+
+ElementPool::~ElementPool() {
+  setCapacity(0);
+}
+
+bool ElementPool::recycle(ElementInstance* element) {
+  GumboTag tag = gumbo_tag_enum(element->m_tagName.c_str());
+  if (tag >= GUMBO_TAG_UNKNOWN)
+    return false;
+
+  std::vector<ElementInstance*>& elements = m_elementsByTag[tag];
+  if (elements.size() >= m_capacity)
+    return false;
+
+  element->resetForRecycle();
+  elements.push_back(element);
+  return true;
+}
+
+ElementInstance* ElementPool::take(GumboTag tag) {
+  std::vector<ElementInstance*>& elements = m_elementsByTag[tag];
+  if (elements.empty())
+    return nullptr;
+
+  ElementInstance* element = elements.back();
+  elements.pop_back();
+  element->reviveFromRecycle();
+  return element;
+}
+
+void ElementPool::setCapacity(uint32_t capacity) {
+  m_capacity = capacity;
+  for (auto& elements : m_elementsByTag) {
+    while (elements.size() > capacity) {
+      delete elements.back();
+      elements.pop_back();
+    }
+  }
+}
+
+}  // namespace kraken::binding::qjs
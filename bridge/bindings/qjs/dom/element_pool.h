@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_ELEMENT_POOL_H
+#define KRAKENBRIDGE_ELEMENT_POOL_H
+
+#include <cstdint>
+#include <vector>
+#include "third_party/gumbo-parser/src/gumbo.h"
+
+namespace kraken::binding::qjs {
+
+class ElementInstance;
+
+// Keep finalized elements of generic tags (div, span, li...) for reuse.
+// Pages such as infinite-scroll lists keep creating and dropping the same rows, reusing an element keeps both
+// the native instance and its dart peer alive, so dart only receives a resetElement command instead of a
+// disposeEventTarget and createElement pair.
+class ElementPool {
+ public:
+  ElementPool() = delete;
+  explicit ElementPool(uint32_t capacity) : m_capacity(capacity), m_elementsByTag(GUMBO_TAG_UNKNOWN){};
+  ~ElementPool();
+
+  // Take over an element which is being finalized, return false if the element should be deleted as usual.
+  bool recycle(ElementInstance* element);
+  // Return a reset element of tag with a new jsObject, or nullptr if there are none.
+  ElementInstance* take(GumboTag tag);
+  // Max count of elements kept for each tag, extra elements are deleted.
+  void setCapacity(uint32_t capacity);
+
+ private:
+  uint32_t m_capacity;
+  std::vector<std::vector<ElementInstance*>> m_elementsByTag;
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_ELEMENT_POOL_H
@@ -3,6 +3,7 @@
  * Author: Kraken Team.
  */
 
+#include "document.h"
 #include "event_target.h"
 #include "gtest/gtest.h"
 #include "kraken_test_env.h"
@@ -144,3 +145,147 @@ TEST(Element, stringifyBoundingClientRect) {
   EXPECT_EQ(errorCalled, false);
   EXPECT_EQ(logCalled, true);
 }
+
+TEST(Element, styleAndChildNodesAreReadonlyPrototypeProperties) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "true true false false 1");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "let style = div.style;"
+      "let childNodes = div.childNodes;"
+      "div.style = null;"
+      "div.childNodes = null;"
+      "div.appendChild(document.createElement('span'));"
+      "console.log(div.style === style, div.childNodes === childNodes, div.hasOwnProperty('style'), "
+      "Object.keys(div).includes('childNodes'), div.childNodes.length);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Element, outerHTMLWithLazyStyle) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "<div></div> <div style=\"width: 100px;\"></div> <head></head><body><span style=\"color: red;\"></span></body>");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "let empty = div.outerHTML;"
+      "div.style.width = '100px';"
+      "let parent = document.createElement('div');"
+      "parent.innerHTML = '<span style=\"color: red\"></span>';"
+      "console.log(empty, div.cloneNode(true).outerHTML, parent.innerHTML);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Element, serializeEscapedHTMLAndTextContent) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(),
+                 "<div title=\"a&quot;b&amp;c\"><span>1 &lt; 2 &amp; 3 &gt; 0&nbsp;中文😀</span><style>a > b</style></div> "
+                 "1 < 2 & 3 > 0\u00a0中文😀a > b <p class=\"1\"></p> <p class=\"b\"></p> true 1");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "div.setAttribute('title', 'a\"b&c');"
+      "let span = document.createElement('span');"
+      "span.appendChild(document.createTextNode('1 < 2 & 3 > 0\\u00a0中文😀'));"
+      "let style = document.createElement('style');"
+      "style.appendChild(document.createTextNode('a > b'));"
+      "div.appendChild(span);"
+      "div.appendChild(style);"
+      "let p = document.createElement('p');"
+      "p.className = 1;"
+      "let q = document.createElement('p');"
+      "let calls = 0;"
+      // Converted once when set, serializing does not call toString again.
+      "q.className = { toString() { calls++; return 'b'; } };"
+      "let error;"
+      "try { q.className = { toString() { throw new Error('bad'); } }; } catch (e) { error = e; }"
+      "console.log(div.outerHTML, div.textContent, p.outerHTML, q.outerHTML, error instanceof Error, calls);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Element, recycleDetachedElements) {
+  using namespace kraken::binding::qjs;
+
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "null 0 true true true false");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  Document::instance(context)->setElementRecyclingCapacity(4);
+
+  std::string create = "var row = document.createElement('div');";
+  bridge->evaluateScript(create.c_str(), create.size(), "vm://", 0);
+  JSValue rowValue = JS_GetPropertyStr(context->ctx(), context->global(), "row");
+  auto* row = static_cast<ElementInstance*>(JS_GetOpaque(rowValue, Element::classId()));
+  int32_t rowId = row->eventTargetId();
+  JS_FreeValue(context->ctx(), rowValue);
+
+  std::string drop = R"(
+row.setAttribute('id', 'row');
+row.style.height = '20px';
+row.addEventListener('click', () => {});
+row.onscroll = () => {};
+row._expando = 1;
+row.appendChild(document.createElement('span'));
+document.body.appendChild(row);
+document.body.removeChild(row);
+row = null;
+)";
+  bridge->evaluateScript(drop.c_str(), drop.size(), "vm://", 0);
+  JS_RunGC(context->runtime());
+
+  context->uiCommandBuffer()->clear();
+  std::string reuse = R"(
+var reused = document.createElement('div');
+console.log(reused.getAttribute('id'), reused.childNodes.length, reused._expando === undefined, reused.onscroll === null || reused.onscroll === undefined,
+  reused.style.height === '', document.getElementById('row') !== null);
+)";
+  bridge->evaluateScript(reuse.c_str(), reuse.size(), "vm://", 0);
+
+  JSValue reusedValue = JS_GetPropertyStr(context->ctx(), context->global(), "reused");
+  auto* reused = static_cast<ElementInstance*>(JS_GetOpaque(reusedValue, Element::classId()));
+  JS_FreeValue(context->ctx(), reusedValue);
+
+  // The same native element is reused with a new jsObject, and dart keeps the element with the same id.
+  EXPECT_EQ(reused, row);
+  EXPECT_EQ(reused->eventTargetId(), rowId);
+  UICommandItem* commands = context->uiCommandBuffer()->data();
+  for (int64_t i = 0; i < context->uiCommandBuffer()->size(); i++) {
+    EXPECT_NE(commands[i].type, UICommand::createElement);
+  }
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
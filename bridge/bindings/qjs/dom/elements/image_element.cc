@@ -105,12 +105,10 @@ ImageElementInstance::ImageElementInstance(ImageElement* element) : ElementInsta
 }
 
 bool ImageElementInstance::dispatchEvent(EventInstance* event) {
-  std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t*>(event->type()->string), event->type()->length);
-  std::string eventType = toUTF8(u16EventType);
   bool result = EventTargetInstance::dispatchEvent(event);
 
   // Free image instance after load or error event triggered.
-  if ((eventType == "load" || eventType == "error") && !freed) {
+  if ((event->isType(u"load") || event->isType(u"error")) && !freed) {
     freed = true;
     unrefer();
   }
@@ -118,4 +116,8 @@ bool ImageElementInstance::dispatchEvent(EventInstance* event) {
   return result;
 }
 
+bool ImageElementInstance::hasDefaultEventHandler(NativeString* eventType) {
+  return !freed && (isEventType(eventType, u"load") || isEventType(eventType, u"error"));
+}
+
 }  // namespace kraken::binding::qjs
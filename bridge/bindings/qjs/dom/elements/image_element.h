@@ -40,6 +40,7 @@ class ImageElementInstance : public ElementInstance {
   bool dispatchEvent(EventInstance* event);
 
  private:
+  bool hasDefaultEventHandler(NativeString* eventType) override;
   bool freed{false};
   friend ImageElement;
 };
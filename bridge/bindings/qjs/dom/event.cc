@@ -107,6 +107,11 @@ IMPL_PROPERTY_GETTER(Event, cancelBubble)(JSContext* ctx, JSValue this_val, int
   return JS_NewBool(ctx, eventInstance->cancelled());
 }
 
+IMPL_PROPERTY_GETTER(Event, eventPhase)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* eventInstance = static_cast<EventInstance*>(JS_GetOpaque(this_val, Event::kEventClassID));
+  return JS_NewUint32(ctx, static_cast<uint32_t>(eventInstance->eventPhase()));
+}
+
 EventInstance* Event::buildEventInstance(std::string& eventType, ExecutionContext* context, void* nativeEvent, bool isCustomEvent) {
   EventInstance* eventInstance;
   if (isCustomEvent) {
@@ -120,6 +125,12 @@ EventInstance* Event::buildEventInstance(std::string& eventType, ExecutionContex
   return eventInstance;
 }
 
+EventInstance* Event::buildEventInstance(NativeString* eventType, ExecutionContext* context, void* nativeEvent, bool isCustomEvent) {
+  std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t*>(eventType->string), eventType->length);
+  std::string eventTypeStr = toUTF8(u16EventType);
+  return buildEventInstance(eventTypeStr, context, nativeEvent, isCustomEvent);
+}
+
 void Event::defineEvent(const std::string& eventType, EventCreator creator) {
   m_eventCreatorMap[eventType] = creator;
 }
@@ -139,12 +150,34 @@ JSValue Event::stopImmediatePropagation(JSContext* ctx, JSValue this_val, int ar
 
 JSValue Event::preventDefault(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* event = static_cast<EventInstance*>(JS_GetOpaque(this_val, Event::kEventClassID));
-  if (event->nativeEvent->cancelable) {
+  if (event->nativeEvent->cancelable && !event->m_inPassiveListener) {
     event->m_cancelled = true;
   }
   return JS_NULL;
 }
 
+JSValue Event::getCoalescedEvents(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* event = static_cast<EventInstance*>(JS_GetOpaque(this_val, Event::kEventClassID));
+  // Samples skipped before the dispatched one in the order they arrived, empty for events not coalesced.
+  if (JS_IsNull(event->m_coalescedEvents)) {
+    event->m_coalescedEvents = JS_NewArray(ctx);
+    uint32_t index = 0;
+    for (NativeEvent* nativeEvent : event->m_coalescedNativeEvents) {
+#if ANDROID_32_BIT
+      auto* pType = reinterpret_cast<NativeString*>(nativeEvent->type);
+#else
+      auto* pType = nativeEvent->type;
+#endif
+      EventInstance* coalescedEvent = buildEventInstance(pType, event->m_context, nativeEvent, event->m_isCustomEvent);
+      coalescedEvent->setTarget(event->target());
+      JS_SetPropertyUint32(ctx, event->m_coalescedEvents, index++, coalescedEvent->jsObject);
+    }
+    event->m_coalescedNativeEvents.clear();
+  }
+
+  return JS_DupValue(ctx, event->m_coalescedEvents);
+}
+
 JSValue Event::initEvent(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   if (argc < 1) {
     return JS_ThrowTypeError(ctx, "Failed to initEvent required, but only 0 present.");
@@ -181,12 +214,26 @@ EventInstance* EventInstance::fromNativeEvent(Event* event, NativeEvent* nativeE
   return new EventInstance(event, nativeEvent);
 }
 
-void EventInstance::setType(NativeString* type) const {
+void EventInstance::setCoalescedNativeEvents(std::vector<NativeEvent*>&& nativeEvents, bool isCustomEvent) {
+  m_isCustomEvent = isCustomEvent;
+  m_coalescedNativeEvents = std::move(nativeEvents);
+}
+
+void EventInstance::setType(NativeString* type) {
 #if ANDROID_32_BIT
   nativeEvent->type = reinterpret_cast<int64_t>(type);
 #else
   nativeEvent->type = type;
 #endif
+  internType();
+}
+
+void EventInstance::internType() {
+  JS_FreeAtom(m_ctx, m_typeAtom);
+  NativeString* pType = type();
+  JSValue typeValue = JS_NewUnicodeString(m_context->runtime(), m_ctx, pType->string, pType->length);
+  m_typeAtom = JS_ValueToAtom(m_ctx, typeValue);
+  JS_FreeValue(m_ctx, typeValue);
 }
 void EventInstance::setTarget(EventTargetInstance* target) const {
 #if ANDROID_32_BIT
@@ -203,7 +250,9 @@ void EventInstance::setCurrentTarget(EventTargetInstance* currentTarget) const {
 #endif
 }
 
-EventInstance::EventInstance(Event* event, NativeEvent* nativeEvent) : nativeEvent(nativeEvent), Instance(event, "Event", nullptr, Event::kEventClassID, finalizer) {}
+EventInstance::EventInstance(Event* event, NativeEvent* nativeEvent) : nativeEvent(nativeEvent), Instance(event, "Event", nullptr, Event::kEventClassID, finalizer) {
+  internType();
+}
 EventInstance::EventInstance(Event* jsEvent, JSAtom eventType, JSValue eventInit) : Instance(jsEvent, "Event", nullptr, Event::kEventClassID, finalizer) {
   JSValue v = JS_AtomToValue(m_ctx, eventType);
 #if ANDROID_32_BIT
@@ -212,6 +261,7 @@ EventInstance::EventInstance(Event* jsEvent, JSAtom eventType, JSValue eventInit
   nativeEvent = new NativeEvent{jsValueToNativeString(m_ctx, v).release()};
 #endif
   JS_FreeValue(m_ctx, v);
+  m_typeAtom = JS_DupAtom(m_ctx, eventType);
 
   auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
   nativeEvent->timeStamp = ms.count();
@@ -232,6 +282,20 @@ EventInstance::EventInstance(Event* jsEvent, JSAtom eventType, JSValue eventInit
   }
 }
 
+EventInstance::~EventInstance() {
+  JSRuntime* rt = ExecutionContext::runtime();
+  JS_FreeAtomRT(rt, m_typeAtom);
+  JS_FreeValueRT(rt, m_coalescedEvents);
+  for (NativeEvent* coalescedNativeEvent : m_coalescedNativeEvents) {
+    delete coalescedNativeEvent;
+  }
+  delete nativeEvent;
+}
+
+void EventInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  JS_MarkValue(rt, m_coalescedEvents, mark_func);
+}
+
 void EventInstance::finalizer(JSRuntime* rt, JSValue val) {
   auto* event = static_cast<EventInstance*>(JS_GetOpaque(val, Event::kEventClassID));
   if (event->context()->isValid()) {
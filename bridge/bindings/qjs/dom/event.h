@@ -6,6 +6,8 @@
 #ifndef KRAKENBRIDGE_EVENT_H
 #define KRAKENBRIDGE_EVENT_H
 
+#include <algorithm>
+#include <string_view>
 #include "bindings/qjs/host_class.h"
 
 namespace kraken::binding::qjs {
@@ -66,6 +68,7 @@ class Event : public HostClass {
   explicit Event(ExecutionContext* context);
 
   static EventInstance* buildEventInstance(std::string& eventType, ExecutionContext* context, void* nativeEvent, bool isCustomEvent);
+  static EventInstance* buildEventInstance(NativeString* eventType, ExecutionContext* context, void* nativeEvent, bool isCustomEvent);
   static void defineEvent(const std::string& eventType, EventCreator creator);
 
   OBJECT_INSTANCE(Event);
@@ -74,6 +77,7 @@ class Event : public HostClass {
   static JSValue stopImmediatePropagation(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
   static JSValue preventDefault(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
   static JSValue initEvent(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue getCoalescedEvents(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
 
  private:
   static std::unordered_map<std::string, EventCreator> m_eventCreatorMap;
@@ -88,11 +92,13 @@ class Event : public HostClass {
   DEFINE_PROTOTYPE_READONLY_PROPERTY(currentTarget);
   DEFINE_PROTOTYPE_READONLY_PROPERTY(returnValue);
   DEFINE_PROTOTYPE_READONLY_PROPERTY(cancelBubble);
+  DEFINE_PROTOTYPE_READONLY_PROPERTY(eventPhase);
 
   DEFINE_PROTOTYPE_FUNCTION(stopPropagation, 0);
   DEFINE_PROTOTYPE_FUNCTION(stopImmediatePropagation, 0);
   DEFINE_PROTOTYPE_FUNCTION(preventDefault, 1);
   DEFINE_PROTOTYPE_FUNCTION(initEvent, 3);
+  DEFINE_PROTOTYPE_FUNCTION(getCoalescedEvents, 0);
 
   friend EventInstance;
 };
@@ -130,10 +136,18 @@ struct RawEvent {
   int64_t length;
 };
 
+// Compare the type of native event without converting it into UTF-8.
+inline bool isEventType(NativeString* type, std::u16string_view eventType) {
+  return type->length == eventType.size() && std::equal(eventType.begin(), eventType.end(), type->string);
+}
+
 class EventInstance : public Instance {
  public:
+  // https://dom.spec.whatwg.org/#dom-event-eventphase
+  enum class Phase : uint8_t { none = 0, capturing = 1, atTarget = 2, bubbling = 3 };
+
   EventInstance() = delete;
-  ~EventInstance() override { delete nativeEvent; }
+  ~EventInstance() override;
 
   static EventInstance* fromNativeEvent(Event* event, NativeEvent* nativeEvent);
   NativeEvent* nativeEvent{nullptr};
@@ -149,11 +163,20 @@ class EventInstance : public Instance {
     return nativeEvent->type;
 #endif
   };
-  void setType(NativeString* type) const;
+  // The event type interned once when the event arrives, listeners are looked up by this atom at every target.
+  FORCE_INLINE JSAtom typeAtom() const { return m_typeAtom; }
+  void setType(NativeString* type);
+  FORCE_INLINE bool isType(std::u16string_view eventType) { return isEventType(type(), eventType); }
   FORCE_INLINE EventTargetInstance* target() { return reinterpret_cast<EventTargetInstance*>(nativeEvent->target); }
   void setTarget(EventTargetInstance* target) const;
   FORCE_INLINE EventTargetInstance* currentTarget() { return reinterpret_cast<EventTargetInstance*>(nativeEvent->currentTarget); }
   void setCurrentTarget(EventTargetInstance* target) const;
+  FORCE_INLINE Phase eventPhase() const { return m_eventPhase; }
+  FORCE_INLINE void setEventPhase(Phase phase) { m_eventPhase = phase; }
+  // preventDefault() is ignored while a listener registered with {passive: true} is running.
+  FORCE_INLINE void setInPassiveListener(bool v) { m_inPassiveListener = v; }
+  // Take over the samples merged into this event by EventCoalescer, they are turned into events at first access.
+  void setCoalescedNativeEvents(std::vector<NativeEvent*>&& nativeEvents, bool isCustomEvent);
 
  protected:
   explicit EventInstance(Event* jsEvent, JSAtom eventType, JSValue eventInit);
@@ -162,8 +185,17 @@ class EventInstance : public Instance {
   bool m_propagationStopped{false};
   bool m_propagationImmediatelyStopped{false};
 
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
+
  private:
+  void internType();
   static void finalizer(JSRuntime* rt, JSValue val);
+  JSAtom m_typeAtom{JS_ATOM_NULL};
+  bool m_isCustomEvent{false};
+  bool m_inPassiveListener{false};
+  Phase m_eventPhase{Phase::none};
+  std::vector<NativeEvent*> m_coalescedNativeEvents;
+  JSValue m_coalescedEvents{JS_NULL};
   friend Event;
 };
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "event_coalescer.h"
+#include "document.h"
+#include "event_target.h"
+
+namespace kraken::binding::qjs {
+
+EventCoalescer::~EventCoalescer() {
+  JSRuntime* rt = ExecutionContext::runtime();
+  for (auto& pending : m_pendingEvents) {
+    delete pending.latest;
+    for (NativeEvent* nativeEvent : pending.coalesced) {
+      delete nativeEvent;
+    }
+    JS_FreeAtomRT(rt, pending.eventType);
+    JS_FreeValueRT(rt, pending.target->jsObject);
+  }
+}
+
+bool EventCoalescer::isCoalescable(NativeString* eventType) {
+  return isEventType(eventType, u"touchmove") || isEventType(eventType, u"scroll") || isEventType(eventType, u"mousemove") || isEventType(eventType, u"pointermove");
+}
+
+void EventCoalescer::enqueue(EventTargetInstance* target, NativeEvent* nativeEvent, bool isCustomEvent) {
+  JSContext* ctx = target->context()->ctx();
+#if ANDROID_32_BIT
+  auto* pType = reinterpret_cast<NativeString*>(nativeEvent->type);
+#else
+  auto* pType = nativeEvent->type;
+#endif
+  JSValue eventTypeValue = JS_NewUnicodeString(ExecutionContext::runtime(), ctx, pType->string, pType->length);
+  JSAtom eventType = JS_ValueToAtom(ctx, eventTypeValue);
+  JS_FreeValue(ctx, eventTypeValue);
+
+  for (auto& pending : m_pendingEvents) {
+    if (pending.target == target && pending.eventType == eventType) {
+      pending.coalesced.push_back(pending.latest);
+      pending.latest = nativeEvent;
+      JS_FreeAtom(ctx, eventType);
+      return;
+    }
+  }
+
+  // Keep target alive until the event is dispatched.
+  JS_DupValue(ctx, target->jsObject);
+  m_pendingEvents.push_back({target, eventType, isCustomEvent, nativeEvent, {}});
+  requestFrame();
+}
+
+static JSValue flushCoalescedEvents(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+  if (context->isValid()) {
+    context->document()->eventCoalescer()->flush();
+  }
+  return JS_NULL;
+}
+
+void EventCoalescer::requestFrame() {
+  if (m_frameRequested)
+    return;
+  m_frameRequested = true;
+
+  JSContext* ctx = m_document->context()->ctx();
+  JSValue callback = JS_NewCFunction(ctx, flushCoalescedEvents, "flushCoalescedEvents", 1);
+  auto* frameCallback = makeGarbageCollected<FrameCallback>(callback)->initialize(ctx, &FrameCallback::classId);
+  m_document->requestAnimationFrame(frameCallback);
+}
+
+void EventCoalescer::flush() {
+  m_frameRequested = false;
+  if (m_pendingEvents.empty())
+    return;
+
+  // Listeners may cause more events, they are dispatched at the next flush.
+  std::vector<PendingEvent> pendingEvents;
+  pendingEvents.swap(m_pendingEvents);
+
+  ExecutionContext* context = m_document->context();
+  JSContext* ctx = context->ctx();
+  for (auto& pending : pendingEvents) {
+#if ANDROID_32_BIT
+    auto* pType = reinterpret_cast<NativeString*>(pending.latest->type);
+#else
+    auto* pType = pending.latest->type;
+#endif
+    EventInstance* event = Event::buildEventInstance(pType, context, pending.latest, pending.isCustomEvent);
+    event->setTarget(pending.target);
+    event->setCoalescedNativeEvents(std::move(pending.coalesced), pending.isCustomEvent);
+    pending.target->dispatchEvent(event);
+    JS_FreeValue(ctx, event->jsObject);
+    JS_FreeAtom(ctx, pending.eventType);
+    JS_FreeValue(ctx, pending.target->jsObject);
+    // Each event is a task of its own, microtasks queued by its listeners run before the next event.
+    context->drainPendingPromiseJobs();
+  }
+}
+
+void EventCoalescer::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const {
+  for (auto& pending : m_pendingEvents) {
+    JS_MarkValue(rt, pending.target->jsObject, mark_func);
+  }
+}
+
+}  // namespace kraken::binding::qjs
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_EVENT_COALESCER_H
+#define KRAKENBRIDGE_EVENT_COALESCER_H
+
+#include <quickjs/quickjs.h>
+#include <vector>
+#include "event.h"
+
+namespace kraken::binding::qjs {
+
+class DocumentInstance;
+
+// Continuous events from dart, such as touchmove and scroll, are sampled faster than frames are produced on
+// high refresh rate devices. Only the latest sample of each target and type is dispatched at the next frame,
+// earlier samples are exposed by event.getCoalescedEvents().
+class EventCoalescer {
+ public:
+  EventCoalescer() = delete;
+  explicit EventCoalescer(DocumentInstance* document) : m_document(document){};
+  ~EventCoalescer();
+
+  static bool isCoalescable(NativeString* eventType);
+
+  // Take over the native event until the next frame.
+  void enqueue(EventTargetInstance* target, NativeEvent* nativeEvent, bool isCustomEvent);
+  // Dispatch all pending events in the order they first arrived.
+  void flush();
+
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const;
+
+ private:
+  struct PendingEvent {
+    EventTargetInstance* target;
+    JSAtom eventType;
+    bool isCustomEvent;
+    NativeEvent* latest;
+    std::vector<NativeEvent*> coalesced;
+  };
+
+  void requestFrame();
+
+  DocumentInstance* m_document;
+  std::vector<PendingEvent> m_pendingEvents;
+  bool m_frameRequested{false};
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_EVENT_COALESCER_H
@@ -7,20 +7,23 @@
 
 namespace kraken::binding::qjs {
 
-static bool addListenerToVector(EventListenerVector* vector, JSValue callback) {
-  if (std::find_if(vector->begin(), vector->end(), [&callback](JSValue fn) { return JS_VALUE_GET_PTR(fn) == JS_VALUE_GET_PTR(callback); }) != vector->end()) {
+static EventListenerVector::const_iterator findListener(const EventListenerVector* vector, JSValue callback, bool capture) {
+  return std::find_if(vector->begin(), vector->end(), [&callback, capture](const RegisteredEventListener& listener) {
+    return JS_VALUE_GET_PTR(listener.callback) == JS_VALUE_GET_PTR(callback) && listener.options.capture == capture;
+  });
+}
+
+static bool addListenerToVector(EventListenerVector* vector, JSValue callback, const EventListenerOptions& options) {
+  if (findListener(vector, callback, options.capture) != vector->end()) {
     return false;  // Duplicate listener.
   }
 
-  vector->push_back(callback);
+  vector->push_back({callback, options});
   return true;
 }
 
-static bool removeListenerFromVector(EventListenerVector* listenerVector, JSValue callback) {
-  // Do a manual search for the matching listener. It is not
-  // possible to create a listener on the stack because of the
-  // const on |listener|.
-  auto it = std::find_if(listenerVector->begin(), listenerVector->end(), [&callback](const JSValue& listener) -> bool { return JS_VALUE_GET_PTR(listener) == JS_VALUE_GET_PTR(callback); });
+static bool removeListenerFromVector(EventListenerVector* listenerVector, JSValue callback, bool capture) {
+  auto it = findListener(listenerVector, callback, capture);
 
   if (it == listenerVector->end()) {
     return false;
@@ -29,38 +32,51 @@ static bool removeListenerFromVector(EventListenerVector* listenerVector, JSValu
   return true;
 }
 
-bool EventListenerMap::contains(JSAtom eventType) const {
-  for (const auto& entry : m_entries) {
-    if (entry.first == eventType)
-      return true;
-  }
-  return false;
-}
-
 void EventListenerMap::clear() {
   m_entries.clear();
+  m_typeBits = 0;
 }
 
-bool EventListenerMap::add(JSAtom eventType, JSValue callback) {
+bool EventListenerMap::containsCapturing(JSAtom eventType) const {
+  const EventListenerVector* vector = find(eventType);
+  return vector != nullptr && std::any_of(vector->begin(), vector->end(), [](const RegisteredEventListener& listener) { return listener.options.capture; });
+}
+
+bool EventListenerMap::containsNonPassive(JSAtom eventType) const {
+  const EventListenerVector* vector = find(eventType);
+  return vector != nullptr && std::any_of(vector->begin(), vector->end(), [](const RegisteredEventListener& listener) { return !listener.options.passive; });
+}
+
+bool EventListenerMap::containsListener(JSAtom eventType, JSValue callback, bool capture) const {
+  const EventListenerVector* vector = find(eventType);
+  return vector != nullptr && findListener(vector, callback, capture) != vector->end();
+}
+
+bool EventListenerMap::add(JSAtom eventType, JSValue callback, const EventListenerOptions& options) {
   for (const auto& entry : m_entries) {
     if (entry.first == eventType) {
-      return addListenerToVector(const_cast<EventListenerVector*>(&entry.second), callback);
+      return addListenerToVector(const_cast<EventListenerVector*>(&entry.second), callback, options);
     }
   }
 
-  std::vector<JSValue> list;
+  EventListenerVector list;
   list.reserve(8);
   m_entries.emplace_back(std::make_pair(eventType, list));
+  m_typeBits |= typeBit(eventType);
 
-  return addListenerToVector(&m_entries.back().second, callback);
+  return addListenerToVector(&m_entries.back().second, callback, options);
 }
 
-bool EventListenerMap::remove(JSAtom eventType, JSValue callback) {
+bool EventListenerMap::remove(JSAtom eventType, JSValue callback, bool capture) {
   for (unsigned i = 0; i < m_entries.size(); ++i) {
     if (m_entries[i].first == eventType) {
-      bool was_removed = removeListenerFromVector(&m_entries[i].second, callback);
+      bool was_removed = removeListenerFromVector(&m_entries[i].second, callback, capture);
       if (m_entries[i].second.empty()) {
         m_entries.erase(m_entries.begin() + i);
+        m_typeBits = 0;
+        for (const auto& entry : m_entries) {
+          m_typeBits |= typeBit(entry.first);
+        }
       }
       return was_removed;
     }
@@ -69,7 +85,10 @@ bool EventListenerMap::remove(JSAtom eventType, JSValue callback) {
   return false;
 }
 
-const EventListenerVector* EventListenerMap::find(JSAtom eventType) {
+const EventListenerVector* EventListenerMap::find(JSAtom eventType) const {
+  if ((m_typeBits & typeBit(eventType)) == 0)
+    return nullptr;
+
   for (const auto& entry : m_entries) {
     if (entry.first == eventType)
       return &entry.second;
@@ -80,17 +99,17 @@ const EventListenerVector* EventListenerMap::find(JSAtom eventType) {
 
 void EventListenerMap::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
   for (const auto& entry : m_entries) {
-    for (const auto& vector : entry.second) {
-      JS_MarkValue(rt, vector, mark_func);
+    for (const auto& listener : entry.second) {
+      JS_MarkValue(rt, listener.callback, mark_func);
     }
   }
 }
 
 EventListenerMap::~EventListenerMap() {
   for (const auto& entry : m_entries) {
-    for (const auto& vector : entry.second) {
+    for (const auto& listener : entry.second) {
       JS_FreeAtomRT(m_runtime, entry.first);
-      JS_FreeValueRT(m_runtime, vector);
+      JS_FreeValueRT(m_runtime, listener.callback);
     }
   }
 }
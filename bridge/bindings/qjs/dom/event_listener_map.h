@@ -12,7 +12,20 @@
 
 namespace kraken::binding::qjs {
 
-using EventListenerVector = std::vector<JSValue>;
+// https://dom.spec.whatwg.org/#dictdef-addeventlisteneroptions
+struct EventListenerOptions {
+  bool capture{false};
+  bool once{false};
+  // Listener will not call preventDefault(), dart does not need to wait for it.
+  bool passive{false};
+};
+
+struct RegisteredEventListener {
+  JSValue callback;
+  EventListenerOptions options;
+};
+
+using EventListenerVector = std::vector<RegisteredEventListener>;
 
 class EventListenerMap final {
  public:
@@ -20,11 +33,15 @@ class EventListenerMap final {
   ~EventListenerMap();
 
   [[nodiscard]] bool empty() const { return m_entries.empty(); }
-  [[nodiscard]] bool contains(JSAtom eventType) const;
+  [[nodiscard]] bool contains(JSAtom eventType) const { return find(eventType) != nullptr; }
+  [[nodiscard]] bool containsCapturing(JSAtom eventType) const;
+  [[nodiscard]] bool containsNonPassive(JSAtom eventType) const;
+  // Listener is identified by callback and capture.
+  [[nodiscard]] bool containsListener(JSAtom eventType, JSValue callback, bool capture) const;
   void clear();
-  bool add(JSAtom eventType, JSValue callback);
-  bool remove(JSAtom eventType, JSValue callback);
-  const EventListenerVector* find(JSAtom eventType);
+  bool add(JSAtom eventType, JSValue callback, const EventListenerOptions& options);
+  bool remove(JSAtom eventType, JSValue callback, bool capture);
+  const EventListenerVector* find(JSAtom eventType) const;
 
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func);
 
@@ -36,6 +53,11 @@ class EventListenerMap final {
   //    vector is faster in such cases.
   std::vector<std::pair<JSAtom, EventListenerVector>> m_entries;
 
+  // One bit per atom slot of the registered event types. Events bubble through many targets which have listeners
+  // for other types only, the bit test rejects them without scanning the entries.
+  static inline uint64_t typeBit(JSAtom eventType) { return uint64_t(1) << (eventType & 63); }
+  uint64_t m_typeBits{0};
+
   JSRuntime* m_runtime;
 };
 
@@ -12,6 +12,7 @@
 #include "document.h"
 #include "element.h"
 #include "event.h"
+#include "intersection_observer.h"
 #include "kraken_bridge.h"
 
 #if UNIT_TEST
@@ -20,7 +21,6 @@
 
 namespace kraken::binding::qjs {
 
-static std::atomic<int32_t> globalEventTargetId{0};
 std::once_flag kEventTargetInitFlag;
 #define GetPropertyCallPreFix "_getProperty_"
 
@@ -38,6 +38,16 @@ EventTarget::EventTarget(ExecutionContext* context) : HostClass(context, "EventT
   std::call_once(kEventTargetInitFlag, []() { JS_NewClassID(&kEventTargetClassId); });
 }
 
+EventTarget::~EventTarget() {
+  JSRuntime* runtime = ExecutionContext::runtime();
+  for (auto& entry : m_propertyHandlers) {
+    JS_FreeAtomRT(runtime, entry.first);
+    if (entry.second.eventType != JS_ATOM_NULL) {
+      JS_FreeAtomRT(runtime, entry.second.eventType);
+    }
+  }
+}
+
 JSValue EventTarget::instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue this_val, int argc, JSValue* argv) {
   auto eventTarget = new EventTargetInstance(this, kEventTargetClassId, "EventTarget");
   return eventTarget->jsObject;
@@ -53,6 +63,80 @@ JSClassID EventTarget::classId(JSValue& value) {
   return classId;
 }
 
+// Property names used by scripts are limited, the limit here only protects against scripts which generate names dynamically.
+static constexpr size_t kMaxCachedPropertyHandlers = 4096;
+
+EventTargetPropertyHandler EventTarget::resolvePropertyHandler(JSAtom atom) {
+  auto it = m_propertyHandlers.find(atom);
+  if (it != m_propertyHandlers.end()) {
+    return it->second;
+  }
+
+  EventTargetPropertyHandler handler;
+  JSValue atomString = JS_AtomToString(m_ctx, atom);
+  JSString* p = JS_VALUE_GET_STRING(atomString);
+  if (p->is_wide_char || (p->len > 0 && p->u.str8[0] == '_')) {
+    handler.kind = EventTargetPropertyHandler::Kind::PrivateExpando;
+  } else if (p->len > 2 && p->u.str8[0] == 'o' && p->u.str8[1] == 'n') {
+    handler.kind = EventTargetPropertyHandler::Kind::EventHandlerAttribute;
+    handler.eventType = JS_NewAtomLen(m_ctx, reinterpret_cast<const char*>(&p->u.str8[2]), p->len - 2);
+  }
+  JS_FreeValue(m_ctx, atomString);
+
+  if (m_propertyHandlers.size() < kMaxCachedPropertyHandlers) {
+    m_propertyHandlers[JS_DupAtom(m_ctx, atom)] = handler;
+  } else {
+    handler.ownsEventType = handler.eventType != JS_ATOM_NULL;
+  }
+  return handler;
+}
+
+// Release the event type of handlers which were not cached when the property hook returns.
+struct ScopedPropertyHandler {
+  ScopedPropertyHandler(JSContext* ctx, EventTargetPropertyHandler handler) : ctx(ctx), handler(handler) {}
+  ~ScopedPropertyHandler() {
+    if (handler.ownsEventType)
+      JS_FreeAtom(ctx, handler.eventType);
+  }
+  ScopedPropertyHandler(const ScopedPropertyHandler&) = delete;
+  ScopedPropertyHandler& operator=(const ScopedPropertyHandler&) = delete;
+
+  JSContext* ctx;
+  const EventTargetPropertyHandler handler;
+};
+
+void EventTarget::setPropertyOnPrototype(JSAtom atom, bool onPrototype) {
+  auto it = m_propertyHandlers.find(atom);
+  if (it != m_propertyHandlers.end()) {
+    it->second.onPrototype = onPrototype;
+  }
+}
+
+// The third argument of addEventListener is either a boolean of capture or an options object.
+// https://dom.spec.whatwg.org/#concept-flatten-options
+static EventListenerOptions parseEventListenerOptions(JSContext* ctx, int argc, JSValue* argv) {
+  EventListenerOptions options;
+  if (argc < 3)
+    return options;
+
+  JSValue value = argv[2];
+  if (!JS_IsObject(value)) {
+    options.capture = JS_ToBool(ctx, value);
+    return options;
+  }
+
+  auto readOption = [ctx, &value](const char* name) {
+    JSValue optionValue = JS_GetPropertyStr(ctx, value, name);
+    bool result = JS_ToBool(ctx, optionValue);
+    JS_FreeValue(ctx, optionValue);
+    return result;
+  };
+  options.capture = readOption("capture");
+  options.once = readOption("once");
+  options.passive = readOption("passive");
+  return options;
+}
+
 JSValue EventTarget::addEventListener(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   if (argc < 2) {
     return JS_ThrowTypeError(ctx, "Failed to addEventListener: type and listener are required.");
@@ -73,23 +157,20 @@ JSValue EventTarget::addEventListener(JSContext* ctx, JSValue this_val, int argc
   // EventType atom will be freed when eventTarget finalized.
   JSAtom eventType = JS_ValueToAtom(ctx, eventTypeValue);
 
-  // Dart needs to be notified for the first registration event.
-  if (!eventTargetInstance->m_eventListenerMap.contains(eventType) || eventTargetInstance->m_eventHandlerMap.contains(eventType)) {
-    int32_t contextId = eventTargetInstance->prototype()->contextId();
-
-    NativeString args_01{};
-    buildUICommandArgs(ctx, eventTypeValue, args_01);
+  EventListenerOptions options = parseEventListenerOptions(ctx, argc, argv);
+  bool wasListening = eventTargetInstance->hasEventListener(eventType);
+  bool wasNonPassive = eventTargetInstance->hasNonPassiveEventListener(eventType);
 
-    eventTargetInstance->m_context->uiCommandBuffer()->addCommand(eventTargetInstance->m_eventTargetId, UICommand::addEvent, args_01, nullptr);
-  }
-
-  bool success = eventTargetInstance->m_eventListenerMap.add(eventType, JS_DupValue(ctx, callback));
+  bool success = eventTargetInstance->ensureEventListenerMap()->add(eventType, JS_DupValue(ctx, callback), options);
   // Callback didn't saved to eventListenerMap.
   if (!success) {
     JS_FreeAtom(ctx, eventType);
     JS_FreeValue(ctx, callback);
+    return JS_UNDEFINED;
   }
 
+  eventTargetInstance->didChangeEventListeners(eventType, wasListening, wasNonPassive);
+
   return JS_UNDEFINED;
 }
 
@@ -111,19 +192,23 @@ JSValue EventTarget::removeEventListener(JSContext* ctx, JSValue this_val, int a
   }
 
   JSAtom eventType = JS_ValueToAtom(ctx, eventTypeValue);
-  auto& eventHandlers = eventTargetInstance->m_eventListenerMap;
+  EventListenerMap* eventHandlers = eventTargetInstance->m_eventListenerMap.get();
 
-  if (!eventTargetInstance->m_eventListenerMap.contains(eventType)) {
+  if (eventHandlers == nullptr || !eventHandlers->contains(eventType)) {
     JS_FreeAtom(ctx, eventType);
     return JS_UNDEFINED;
   }
 
-  if (eventHandlers.remove(eventType, callback)) {
+  bool wasNonPassive = eventTargetInstance->hasNonPassiveEventListener(eventType);
+  bool capture = parseEventListenerOptions(ctx, argc, argv).capture;
+  if (eventHandlers->remove(eventType, callback, capture)) {
     JS_FreeAtom(ctx, eventType);
     JS_FreeValue(ctx, callback);
+    eventTargetInstance->didChangeEventListeners(eventType, true, wasNonPassive);
   }
 
-  if (eventHandlers.empty() && eventTargetInstance->m_eventHandlerMap.contains(eventType)) {
+  EventHandlerMap* eventHandlerMap = eventTargetInstance->m_eventHandlerMap.get();
+  if (eventHandlers->empty() && eventHandlerMap != nullptr && eventHandlerMap->contains(eventType)) {
     // Dart needs to be notified for handles is empty.
     int32_t contextId = eventTargetInstance->prototype()->contextId();
 
@@ -157,48 +242,90 @@ JSValue EventTarget::dispatchEvent(JSContext* ctx, JSValue this_val, int argc, J
   return JS_NewBool(ctx, eventTargetInstance->dispatchEvent(eventInstance));
 }
 
-bool EventTargetInstance::dispatchEvent(EventInstance* event) {
-  auto* pEventType = reinterpret_cast<NativeString*>(event->nativeEvent->type);
+void EventTargetInstance::collectEventPath(std::vector<EventTargetInstance*>& path) {
+  path.push_back(this);
 
-  std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t*>(pEventType->string), pEventType->length);
-  std::string eventType = toUTF8(u16EventType);
+  auto* node = static_cast<NodeInstance*>(JS_GetOpaque(jsObject, Node::classId(jsObject)));
+  // Window is not a node, it is always the last one of the path.
+  if (node == nullptr)
+    return;
 
-  // protect this util event trigger finished.
-  JS_DupValue(m_ctx, jsObject);
+  while (auto* parent = static_cast<NodeInstance*>(JS_GetOpaque(node->parentNode, Node::classId(node->parentNode)))) {
+    path.push_back(parent);
+    node = parent;
+  }
+  // Window does not inherit from Node, so it is not in the Node tree and needs to continue passing to the Window when it bubbles to Document.
+  JSValue globalObjectValue = JS_GetGlobalObject(m_ctx);
+  path.push_back(static_cast<WindowInstance*>(JS_GetOpaque(globalObjectValue, Window::classId())));
+  JS_FreeValue(m_ctx, globalObjectValue);
+}
 
-  internalDispatchEvent(event);
+bool EventTargetInstance::hasEventListener(JSAtom eventType) const {
+  return (m_eventListenerMap != nullptr && m_eventListenerMap->contains(eventType)) || (m_eventHandlerMap != nullptr && m_eventHandlerMap->contains(eventType));
+}
 
-  // Bubble event to root event target.
-  if (event->nativeEvent->bubbles == 1 && !event->propagationStopped()) {
-    auto node = reinterpret_cast<NodeInstance*>(this);
-    auto* parent = static_cast<NodeInstance*>(JS_GetOpaque(node->parentNode, Node::classId(node->parentNode)));
+bool EventTargetInstance::hasNonPassiveEventListener(JSAtom eventType) const {
+  return (m_eventListenerMap != nullptr && m_eventListenerMap->containsNonPassive(eventType)) || (m_eventHandlerMap != nullptr && m_eventHandlerMap->contains(eventType));
+}
 
-    if (parent != nullptr) {
-      parent->dispatchEvent(event);
-    } else {
-      // Window does not inherit from Node, so it is not in the Node tree and needs to continue passing to the Window when it bubbles to Document.
-      JSValue globalObjectValue = JS_GetGlobalObject(m_context->ctx());
-      auto* window = static_cast<WindowInstance*>(JS_GetOpaque(globalObjectValue, Window::classId()));
-      window->internalDispatchEvent(event);
-      JS_FreeValue(m_ctx, globalObjectValue);
+void EventTargetInstance::didChangeEventListeners(JSAtom eventType, bool wasListening, bool wasNonPassive) {
+  bool listening = hasEventListener(eventType);
+  if (!listening && !wasListening)
+    return;
+
+  // Dart keeps forwarding a type once it was added, a type without listeners is reported as passive instead.
+  bool nonPassive = listening && hasNonPassiveEventListener(eventType);
+  if (wasListening && nonPassive == wasNonPassive)
+    return;
+
+  // Dart waits for listeners before default actions such as scrolling, unless all of them are passive.
+  std::unique_ptr<NativeString> args_01 = atomToNativeString(m_ctx, eventType);
+  std::unique_ptr<NativeString> args_02 = stringToNativeString(nonPassive ? "0" : "1");
+  m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::addEvent, *args_01, *args_02, nullptr);
+}
+
+bool EventTargetInstance::dispatchEvent(EventInstance* event) {
+  // Collect the propagation path before any listener runs, listeners moving nodes around should not change
+  // the targets of the current dispatch.
+  std::vector<EventTargetInstance*> path;
+  collectEventPath(path);
+
+  // protect targets util event trigger finished.
+  for (auto* target : path) {
+    JS_DupValue(m_ctx, target->jsObject);
+  }
+
+  // Capturing phase goes from window down to the parent of target, then back up in bubbling phase.
+  // https://dom.spec.whatwg.org/#concept-event-dispatch
+  for (size_t i = path.size() - 1; i > 0 && !event->propagationStopped(); i--) {
+    path[i]->internalDispatchEvent(event, EventInstance::Phase::capturing);
+  }
+  if (!event->propagationStopped()) {
+    internalDispatchEvent(event, EventInstance::Phase::atTarget);
+  }
+  if (event->nativeEvent->bubbles == 1) {
+    for (size_t i = 1; i < path.size() && !event->propagationStopped(); i++) {
+      path[i]->internalDispatchEvent(event, EventInstance::Phase::bubbling);
     }
   }
+  event->setEventPhase(EventInstance::Phase::none);
 
-  JS_FreeValue(m_ctx, jsObject);
+  for (auto* target : path) {
+    JS_FreeValue(m_ctx, target->jsObject);
+  }
 
   return event->cancelled();
 }
 
-bool EventTargetInstance::internalDispatchEvent(EventInstance* eventInstance) {
-  std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t*>(eventInstance->type()->string), eventInstance->type()->length);
-  std::string eventTypeStr = toUTF8(u16EventType);
-  JSAtom eventType = JS_NewAtom(m_ctx, eventTypeStr.c_str());
+bool EventTargetInstance::internalDispatchEvent(EventInstance* eventInstance, EventInstance::Phase phase) {
+  JSAtom eventType = eventInstance->typeAtom();
 
   // Modify the currentTarget to this.
   eventInstance->setCurrentTarget(this);
+  eventInstance->setEventPhase(phase);
 
   // Dispatch event listeners writen by addEventListener
-  auto _dispatchEvent = [&eventInstance, this](JSValue handler) {
+  auto _dispatchEvent = [&eventInstance, this](JSValue handler, bool passive) {
     if (!JS_IsFunction(m_ctx, handler))
       return;
 
@@ -210,7 +337,9 @@ bool EventTargetInstance::internalDispatchEvent(EventInstance* eventInstance) {
     JS_DupValue(m_ctx, handler);
 
     // The third params `thisObject` to null equals global object.
+    eventInstance->setInPassiveListener(passive);
     JSValue returnedValue = JS_Call(m_ctx, handler, JS_NULL, 1, &eventInstance->jsObject);
+    eventInstance->setInPassiveListener(false);
 
     JS_FreeValue(m_ctx, handler);
     m_context->handleException(&returnedValue);
@@ -218,20 +347,52 @@ bool EventTargetInstance::internalDispatchEvent(EventInstance* eventInstance) {
     JS_FreeValue(m_ctx, returnedValue);
   };
 
-  if (m_eventListenerMap.contains(eventType)) {
-    const EventListenerVector* vector = m_eventListenerMap.find(eventType);
-    for (auto& eventHandler : *vector) {
-      _dispatchEvent(eventHandler);
+  const EventListenerVector* vector = m_eventListenerMap != nullptr ? m_eventListenerMap->find(eventType) : nullptr;
+  if (vector != nullptr) {
+    // Listeners may add or remove listeners of this target, iterate over a copy and skip the removed ones.
+    EventListenerVector listeners = *vector;
+    for (auto& listener : listeners) {
+      JS_DupValue(m_ctx, listener.callback);
+    }
+
+    // Capturing listeners run before the others at target.
+    auto _dispatchListeners = [&](bool capture) {
+      for (auto& listener : listeners) {
+        if (eventInstance->propagationImmediatelyStopped())
+          return;
+        if (listener.options.capture != capture || !m_eventListenerMap->containsListener(eventType, listener.callback, capture))
+          continue;
+
+        if (listener.options.once) {
+          bool wasNonPassive = hasNonPassiveEventListener(eventType);
+          m_eventListenerMap->remove(eventType, listener.callback, capture);
+          JS_FreeAtom(m_ctx, eventType);
+          JS_FreeValue(m_ctx, listener.callback);
+          didChangeEventListeners(eventType, true, wasNonPassive);
+        }
+        _dispatchEvent(listener.callback, listener.options.passive);
+      }
+    };
+
+    if (phase != EventInstance::Phase::bubbling) {
+      _dispatchListeners(true);
+    }
+    if (phase != EventInstance::Phase::capturing) {
+      _dispatchListeners(false);
+    }
+
+    for (auto& listener : listeners) {
+      JS_FreeValue(m_ctx, listener.callback);
     }
   }
 
   // Dispatch event listener white by 'on' prefix property.
-  if (m_eventHandlerMap.contains(eventType)) {
+  if (phase != EventInstance::Phase::capturing && m_eventHandlerMap != nullptr && m_eventHandlerMap->contains(eventType)) {
     // Let special error event handling be true if event is an ErrorEvent.
-    bool specialErrorEventHanding = eventTypeStr == "error";
+    bool specialErrorEventHanding = eventInstance->isType(u"error");
 
     if (specialErrorEventHanding) {
-      auto _dispatchErrorEvent = [&eventInstance, this, eventTypeStr](JSValue handler) {
+      auto _dispatchErrorEvent = [&eventInstance, this](JSValue handler) {
         JSValue error = JS_GetPropertyStr(m_ctx, eventInstance->jsObject, "error");
         JSValue messageValue = JS_GetPropertyStr(m_ctx, error, "message");
         JSValue lineNumberValue = JS_GetPropertyStr(m_ctx, error, "lineNumber");
@@ -249,30 +410,28 @@ bool EventTargetInstance::internalDispatchEvent(EventInstance* eventInstance) {
         JS_FreeValue(m_ctx, lineNumberValue);
         JS_FreeValue(m_ctx, columnValue);
       };
-      _dispatchErrorEvent(m_eventHandlerMap.getProperty(eventType));
+      _dispatchErrorEvent(m_eventHandlerMap->getProperty(eventType));
     } else {
-      _dispatchEvent(m_eventHandlerMap.getProperty(eventType));
+      _dispatchEvent(m_eventHandlerMap->getProperty(eventType), false);
     }
   }
 
-  JS_FreeAtom(m_ctx, eventType);
-
   // do not dispatch event when event has been canceled
   // true is prevented.
   return eventInstance->cancelled();
 }
 
-EventTargetInstance::EventTargetInstance(EventTarget* eventTarget, JSClassID classId, JSClassExoticMethods& exoticMethods, std::string name)
+EventTargetInstance::EventTargetInstance(EventTarget* eventTarget, JSClassID classId, JSClassExoticMethods& exoticMethods, const char* name)
     : Instance(eventTarget, name, &exoticMethods, classId, finalize) {
-  m_eventTargetId = globalEventTargetId++;
+  m_eventTargetId = m_context->eventTargetIds()->allocate();
 }
 
-EventTargetInstance::EventTargetInstance(EventTarget* eventTarget, JSClassID classId, std::string name) : Instance(eventTarget, std::move(name), nullptr, classId, finalize) {
-  m_eventTargetId = globalEventTargetId++;
+EventTargetInstance::EventTargetInstance(EventTarget* eventTarget, JSClassID classId, const char* name) : Instance(eventTarget, name, nullptr, classId, finalize) {
+  m_eventTargetId = m_context->eventTargetIds()->allocate();
 }
 
-EventTargetInstance::EventTargetInstance(EventTarget* eventTarget, JSClassID classId, std::string name, int64_t eventTargetId)
-    : Instance(eventTarget, std::move(name), nullptr, classId, finalize), m_eventTargetId(eventTargetId) {}
+EventTargetInstance::EventTargetInstance(EventTarget* eventTarget, JSClassID classId, const char* name, int64_t eventTargetId)
+    : Instance(eventTarget, name, nullptr, classId, finalize), m_eventTargetId(eventTargetId) {}
 
 JSClassID EventTargetInstance::classId() {
   assert_m(false, "classId is not implemented");
@@ -289,59 +448,92 @@ EventTargetInstance::~EventTargetInstance() {
 
   m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::disposeEventTarget, nullptr, false);
   getDartMethod()->flushUICommand();
-  delete nativeEventTarget;
+
+  // Window and document have reserved ids.
+  if (m_eventTargetId >= 0) {
+    m_context->eventTargetIds()->free(m_eventTargetId);
+  }
+}
+
+EventListenerMap* EventTargetInstance::ensureEventListenerMap() {
+  if (m_eventListenerMap == nullptr) {
+    m_eventListenerMap = std::make_unique<EventListenerMap>(m_ctx);
+  }
+  return m_eventListenerMap.get();
+}
+
+EventHandlerMap* EventTargetInstance::ensureEventHandlerMap() {
+  if (m_eventHandlerMap == nullptr) {
+    m_eventHandlerMap = std::make_unique<EventHandlerMap>(m_ctx);
+  }
+  return m_eventHandlerMap.get();
+}
+
+EventTargetProperties* EventTargetInstance::ensureProperties() {
+  if (m_properties == nullptr) {
+    m_properties = std::make_unique<EventTargetProperties>(m_ctx);
+  }
+  return m_properties.get();
 }
 
 int EventTargetInstance::hasProperty(JSContext* ctx, JSValue obj, JSAtom atom) {
   auto* eventTarget = static_cast<EventTargetInstance*>(JS_GetOpaque(obj, JSValueGetClassId(obj)));
-  auto* prototype = static_cast<EventTarget*>(eventTarget->prototype());
+  auto* eventTargetClass = static_cast<EventTarget*>(eventTarget->prototype());
 
-  if (JS_HasProperty(ctx, prototype->m_prototypeObject, atom))
+  if (JS_HasProperty(ctx, eventTargetClass->m_prototypeObject, atom))
     return true;
 
-  JSValue atomString = JS_AtomToString(ctx, atom);
-  JSString* p = JS_VALUE_GET_STRING(atomString);
-  // There are still one reference_count in atom. It's safe to free here.
-  JS_FreeValue(ctx, atomString);
-
-  if (!p->is_wide_char && p->u.str8[0] == 'o' && p->u.str8[1] == 'n') {
-    return !JS_IsNull(eventTarget->getAttributesEventHandler(p));
+  ScopedPropertyHandler scopedHandler(ctx, eventTargetClass->resolvePropertyHandler(atom));
+  const EventTargetPropertyHandler& handler = scopedHandler.handler;
+  if (handler.kind == EventTargetPropertyHandler::Kind::EventHandlerAttribute) {
+    return eventTarget->m_eventHandlerMap != nullptr && eventTarget->m_eventHandlerMap->contains(handler.eventType);
   }
 
-  return eventTarget->m_properties.contains(atom);
+  return eventTarget->m_properties != nullptr && eventTarget->m_properties->contains(atom);
 }
 
 JSValue EventTargetInstance::getProperty(JSContext* ctx, JSValue obj, JSAtom atom, JSValue receiver) {
   auto* eventTarget = static_cast<EventTargetInstance*>(JS_GetOpaque(obj, JSValueGetClassId(obj)));
+  auto* eventTargetClass = static_cast<EventTarget*>(eventTarget->prototype());
+  ScopedPropertyHandler scopedHandler(ctx, eventTargetClass->resolvePropertyHandler(atom));
+  const EventTargetPropertyHandler& handler = scopedHandler.handler;
+
   JSValue prototype = JS_GetPrototype(ctx, eventTarget->jsObject);
-  if (JS_HasProperty(ctx, prototype, atom)) {
+  // Cached results are only valid when the prototype of instance had not been replaced by javascript.
+  bool isClassPrototype = JS_VALUE_GET_PTR(prototype) == JS_VALUE_GET_PTR(eventTargetClass->m_prototypeObject);
+  if (handler.onPrototype && isClassPrototype) {
+    // Read from prototype directly, only check the existence of property when the result is undefined.
+    JSValue ret = JS_GetPropertyInternal(ctx, prototype, atom, eventTarget->jsObject, 0);
+    if (!JS_IsUndefined(ret) || JS_HasProperty(ctx, prototype, atom)) {
+      JS_FreeValue(ctx, prototype);
+      return ret;
+    }
+    eventTargetClass->setPropertyOnPrototype(atom, false);
+  } else if (JS_HasProperty(ctx, prototype, atom)) {
+    if (isClassPrototype) {
+      eventTargetClass->setPropertyOnPrototype(atom, true);
+    }
     JSValue ret = JS_GetPropertyInternal(ctx, prototype, atom, eventTarget->jsObject, 0);
     JS_FreeValue(ctx, prototype);
     return ret;
   }
   JS_FreeValue(ctx, prototype);
 
-  JSValue atomString = JS_AtomToString(ctx, atom);
-  JSString* p = JS_VALUE_GET_STRING(atomString);
-  // There are still one reference_count in atom. It's safe to free here.
-  JS_FreeValue(ctx, atomString);
-
-  if (!p->is_wide_char && p->u.str8[0] == 'o' && p->u.str8[1] == 'n') {
-    return eventTarget->getAttributesEventHandler(p);
+  if (handler.kind == EventTargetPropertyHandler::Kind::EventHandlerAttribute) {
+    return eventTarget->getAttributesEventHandler(handler.eventType);
   }
 
-  if (eventTarget->m_properties.contains(atom)) {
-    return JS_DupValue(ctx, eventTarget->m_properties.getProperty(atom));
+  if (eventTarget->m_properties != nullptr && eventTarget->m_properties->contains(atom)) {
+    return JS_DupValue(ctx, eventTarget->m_properties->getProperty(atom));
   }
 
   // For plugin elements, try to auto generate properties and functions from dart response.
-  if (isJavaScriptExtensionElementInstance(eventTarget->context(), eventTarget->jsObject)) {
-    const char* cmethod = JS_AtomToCString(eventTarget->m_ctx, atom);
+  if (eventTarget->m_isJavaScriptExtensionElement) {
     // Property starts with underscore are taken as private property in javascript object.
-    if (cmethod[0] == '_') {
-      JS_FreeCString(eventTarget->m_ctx, cmethod);
+    if (handler.kind == EventTargetPropertyHandler::Kind::PrivateExpando) {
       return JS_UNDEFINED;
     }
+    const char* cmethod = JS_AtomToCString(eventTarget->m_ctx, atom);
     JSValue result = eventTarget->getNativeProperty(cmethod);
     JS_FreeCString(ctx, cmethod);
     return result;
@@ -352,44 +544,66 @@ JSValue EventTargetInstance::getProperty(JSContext* ctx, JSValue obj, JSAtom ato
 
 int EventTargetInstance::setProperty(JSContext* ctx, JSValue obj, JSAtom atom, JSValue value, JSValue receiver, int flags) {
   auto* eventTarget = static_cast<EventTargetInstance*>(JS_GetOpaque(obj, JSValueGetClassId(obj)));
+  auto* eventTargetClass = static_cast<EventTarget*>(eventTarget->prototype());
+  ScopedPropertyHandler scopedHandler(ctx, eventTargetClass->resolvePropertyHandler(atom));
+  const EventTargetPropertyHandler& handler = scopedHandler.handler;
+
   JSValue prototype = JS_GetPrototype(ctx, eventTarget->jsObject);
+  bool isClassPrototype = JS_VALUE_GET_PTR(prototype) == JS_VALUE_GET_PTR(eventTargetClass->m_prototypeObject);
 
   // Check there are setter functions on prototype.
-  if (JS_HasProperty(ctx, prototype, atom)) {
-    // Read setter function from prototype Object.
-    JSPropertyDescriptor descriptor;
-    JS_GetOwnProperty(ctx, &descriptor, prototype, atom);
-    JSValue setterFunc = descriptor.setter;
-    assert_m(JS_IsFunction(ctx, setterFunc), "Setter on prototype should be an function.");
-    JSValue ret = JS_Call(ctx, setterFunc, eventTarget->jsObject, 1, &value);
-    if (JS_IsException(ret))
-      return -1;
-
-    JS_FreeValue(ctx, ret);
-    JS_FreeValue(ctx, descriptor.setter);
-    JS_FreeValue(ctx, descriptor.getter);
-    JS_FreeValue(ctx, prototype);
-    return 1;
+  if ((handler.onPrototype && isClassPrototype) || JS_HasProperty(ctx, prototype, atom)) {
+    // Read setter function from the prototype chain, accessors may be defined by parent classes.
+    JSPropertyDescriptor descriptor{0, JS_UNDEFINED, JS_UNDEFINED, JS_UNDEFINED};
+    int found = 0;
+    JSValue owner = JS_DupValue(ctx, prototype);
+    while (JS_IsObject(owner)) {
+      found = JS_GetOwnProperty(ctx, &descriptor, owner, atom);
+      if (found != 0)
+        break;
+      JSValue parent = JS_GetPrototype(ctx, owner);
+      JS_FreeValue(ctx, owner);
+      owner = parent;
+    }
+    JS_FreeValue(ctx, owner);
+
+    if (isClassPrototype && handler.onPrototype != (found == 1)) {
+      eventTargetClass->setPropertyOnPrototype(atom, found == 1);
+    }
+
+    if (found != 0) {
+      int result = 1;
+      // Readonly properties such as childNodes and style have no setter, assignments to them are ignored.
+      if (found < 0) {
+        result = -1;
+      } else if (JS_IsFunction(ctx, descriptor.setter)) {
+        JSValue ret = JS_Call(ctx, descriptor.setter, eventTarget->jsObject, 1, &value);
+        if (JS_IsException(ret))
+          result = -1;
+        JS_FreeValue(ctx, ret);
+      }
+
+      JS_FreeValue(ctx, descriptor.value);
+      JS_FreeValue(ctx, descriptor.setter);
+      JS_FreeValue(ctx, descriptor.getter);
+      JS_FreeValue(ctx, prototype);
+      return result;
+    }
   }
 
   JS_FreeValue(ctx, prototype);
 
-  JSValue atomString = JS_AtomToString(ctx, atom);
-  JSString* p = JS_VALUE_GET_STRING(atomString);
-
-  if (!p->is_wide_char && p->len > 2 && p->u.str8[0] == 'o' && p->u.str8[1] == 'n') {
-    eventTarget->setAttributesEventHandler(p, value);
+  if (handler.kind == EventTargetPropertyHandler::Kind::EventHandlerAttribute) {
+    eventTarget->setAttributesEventHandler(handler.eventType, value);
   } else {
-    eventTarget->m_properties.setProperty(JS_DupAtom(ctx, atom), JS_DupValue(ctx, value));
-    if (isJavaScriptExtensionElementInstance(eventTarget->context(), eventTarget->jsObject) && !p->is_wide_char && p->u.str8[0] != '_') {
+    eventTarget->ensureProperties()->setProperty(JS_DupAtom(ctx, atom), JS_DupValue(ctx, value));
+    if (eventTarget->m_isJavaScriptExtensionElement && handler.kind == EventTargetPropertyHandler::Kind::Expando) {
       std::unique_ptr<NativeString> args_01 = atomToNativeString(ctx, atom);
       std::unique_ptr<NativeString> args_02 = jsValueToNativeString(ctx, value);
       eventTarget->m_context->uiCommandBuffer()->addCommand(eventTarget->m_eventTargetId, UICommand::setProperty, *args_01, *args_02, nullptr);
     }
   }
 
-  JS_FreeValue(ctx, atomString);
-
   return 0;
 }
 
@@ -398,7 +612,7 @@ int EventTargetInstance::deleteProperty(JSContext* ctx, JSValue obj, JSAtom prop
 }
 
 JSValue EventTargetInstance::callNativeMethods(const char* method, int32_t argc, NativeValue* argv) {
-  if (nativeEventTarget->callNativeMethods == nullptr) {
+  if (nativeEventTarget.callNativeMethods == nullptr) {
     return JS_ThrowTypeError(m_ctx, "Failed to call native dart methods: callNativeMethods not initialized.");
   }
 
@@ -408,49 +622,43 @@ JSValue EventTargetInstance::callNativeMethods(const char* method, int32_t argc,
   NativeString m{reinterpret_cast<const uint16_t*>(methodString.c_str()), static_cast<uint32_t>(methodString.size())};
 
   NativeValue nativeValue{};
-  nativeEventTarget->callNativeMethods(nativeEventTarget, &nativeValue, &m, argc, argv);
+  nativeEventTarget.callNativeMethods(&nativeEventTarget, &nativeValue, &m, argc, argv);
   JSValue returnValue = nativeValueToJSValue(m_context, nativeValue);
   return returnValue;
 }
 
-void EventTargetInstance::setAttributesEventHandler(JSString* p, JSValue value) {
-  char eventType[p->len + 1 - 2];
-  memcpy(eventType, &p->u.str8[2], p->len + 1 - 2);
-  JSAtom atom = JS_NewAtom(m_ctx, eventType);
-
+void EventTargetInstance::setAttributesEventHandler(JSAtom eventType, JSValue value) {
   // When evaluate scripts like 'element.onclick = null', we needs to remove the event handlers callbacks
+  bool wasListening = hasEventListener(eventType);
+  bool wasNonPassive = hasNonPassiveEventListener(eventType);
+
   if (JS_IsNull(value)) {
-    m_eventHandlerMap.erase(atom);
-    JS_FreeAtom(m_ctx, atom);
+    if (m_eventHandlerMap != nullptr) {
+      m_eventHandlerMap->erase(eventType);
+      didChangeEventListeners(eventType, wasListening, wasNonPassive);
+    }
     return;
   }
 
-  m_eventHandlerMap.setProperty(atom, JS_DupValue(m_ctx, value));
+  ensureEventHandlerMap()->setProperty(JS_DupAtom(m_ctx, eventType), JS_DupValue(m_ctx, value));
 
-  if (JS_IsFunction(m_ctx, value) && m_eventListenerMap.empty()) {
-    int32_t contextId = m_context->getContextId();
-    std::unique_ptr<NativeString> args_01 = atomToNativeString(m_ctx, atom);
-    int32_t type = JS_IsFunction(m_ctx, value) ? UICommand::addEvent : UICommand::removeEvent;
-    m_context->uiCommandBuffer()->addCommand(m_eventTargetId, type, *args_01, nullptr);
+  if (JS_IsFunction(m_ctx, value)) {
+    didChangeEventListeners(eventType, wasListening, wasNonPassive);
   }
 }
 
-JSValue EventTargetInstance::getAttributesEventHandler(JSString* p) {
-  char eventType[p->len + 1 - 2];
-  memcpy(eventType, &p->u.str8[2], p->len + 1 - 2);
-  JSAtom atom = JS_NewAtom(m_ctx, eventType);
-  if (!m_eventHandlerMap.contains(atom)) {
-    JS_FreeAtom(m_ctx, atom);
+JSValue EventTargetInstance::getAttributesEventHandler(JSAtom eventType) {
+  if (m_eventHandlerMap == nullptr || !m_eventHandlerMap->contains(eventType)) {
     return JS_NULL;
   }
 
-  JSValue handler = JS_DupValue(m_ctx, m_eventHandlerMap.getProperty(atom));
-  JS_FreeAtom(m_ctx, atom);
-  return handler;
+  return JS_DupValue(m_ctx, m_eventHandlerMap->getProperty(eventType));
 }
 
 void EventTargetInstance::finalize(JSRuntime* rt, JSValue val) {
   auto* eventTarget = static_cast<EventTargetInstance*>(JS_GetOpaque(val, EventTarget::classId(val)));
+  if (eventTarget->recycle())
+    return;
   delete eventTarget;
 }
 
@@ -465,43 +673,97 @@ JSValue EventTargetInstance::getNativeProperty(const char* prop) {
 // We needs to gc which JSValues are still holding.
 void EventTargetInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
   // Trace m_eventListeners.
-  m_eventListenerMap.trace(rt, JS_UNDEFINED, mark_func);
+  if (m_eventListenerMap != nullptr)
+    m_eventListenerMap->trace(rt, JS_UNDEFINED, mark_func);
 
   // Trace m_eventHandlers.
-  m_eventHandlerMap.trace(rt, JS_UNDEFINED, mark_func);
+  if (m_eventHandlerMap != nullptr)
+    m_eventHandlerMap->trace(rt, JS_UNDEFINED, mark_func);
 
   // Trace properties.
-  m_properties.trace(rt, JS_UNDEFINED, mark_func);
+  if (m_properties != nullptr)
+    m_properties->trace(rt, JS_UNDEFINED, mark_func);
 }
 
 void EventTargetInstance::copyNodeProperties(EventTargetInstance* newNode, EventTargetInstance* referenceNode) {
-  referenceNode->m_properties.copyWith(&newNode->m_properties);
+  if (referenceNode->m_properties == nullptr)
+    return;
+  referenceNode->m_properties->copyWith(newNode->ensureProperties());
 }
 
 void NativeEventTarget::dispatchEventImpl(int32_t contextId, NativeEventTarget* nativeEventTarget, NativeString* nativeEventType, void* rawEvent, int32_t isCustomEvent) {
+  // Should avoid dispatch event is ctx is invalid, eventTargets may already been freed when context disposing.
+  if (!isContextValid(contextId)) {
+    return;
+  }
+
   assert_m(nativeEventTarget->instance != nullptr, "NativeEventTarget should have owner");
   EventTargetInstance* eventTargetInstance = nativeEventTarget->instance;
 
   auto* runtime = ExecutionContext::runtime();
 
-  // Should avoid dispatch event is ctx is invalid.
-  if (!isContextValid(contextId)) {
-    return;
-  }
-
   // We should avoid trigger event if eventTarget are no long live on heap.
   if (!JS_IsLiveObject(runtime, eventTargetInstance->jsObject)) {
     return;
   }
 
   ExecutionContext* context = eventTargetInstance->context();
-  std::u16string u16EventType = std::u16string(reinterpret_cast<const char16_t*>(nativeEventType->string), nativeEventType->length);
-  std::string eventType = toUTF8(u16EventType);
   auto* raw = static_cast<RawEvent*>(rawEvent);
   // NativeEvent members are memory aligned corresponding to NativeEvent.
   // So we can reinterpret_cast raw bytes pointer to NativeEvent type directly.
   auto* nativeEvent = reinterpret_cast<NativeEvent*>(raw->bytes);
-  EventInstance* eventInstance = Event::buildEventInstance(eventType, context, nativeEvent, isCustomEvent == 1);
+
+  // Intersections of elements observed by IntersectionObservers are consumed natively and delivered per frame.
+  if (UNLIKELY(context->hasIntersectionObservers()) && isEventType(nativeEventType, u"intersectionchange")) {
+    auto* element = static_cast<ElementInstance*>(JS_GetOpaque(eventTargetInstance->jsObject, Element::classId()));
+    if (element != nullptr) {
+      IntersectionObserverInstance::queueEntries(element, nativeEvent);
+    }
+  }
+
+  // Most events from dart, such as touchmove over elements, have no listeners at all. Look for listeners along the
+  // propagation path first, creating the event object and its members is skipped when there are none.
+  if (!eventTargetInstance->hasDefaultEventHandler(nativeEventType)) {
+    std::vector<EventTargetInstance*> path;
+    eventTargetInstance->collectEventPath(path);
+
+    JSValue eventTypeValue = JS_NewUnicodeString(runtime, context->ctx(), nativeEventType->string, nativeEventType->length);
+    JSAtom eventTypeAtom = JS_ValueToAtom(context->ctx(), eventTypeValue);
+    JS_FreeValue(context->ctx(), eventTypeValue);
+    // Ancestors only receive events which don't bubble in capturing phase.
+    bool bubbles = nativeEvent->bubbles == 1;
+    bool hasListener = eventTargetInstance->hasEventListener(eventTypeAtom) || std::any_of(path.begin() + 1, path.end(), [eventTypeAtom, bubbles](EventTargetInstance* target) {
+                         return bubbles ? target->hasEventListener(eventTypeAtom) : (target->m_eventListenerMap != nullptr && target->m_eventListenerMap->containsCapturing(eventTypeAtom));
+                       });
+    JS_FreeAtom(context->ctx(), eventTypeAtom);
+
+    if (!hasListener) {
+      delete nativeEvent;
+      return;
+    }
+  }
+
+  // Events of frozen pages are held until they resume.
+  if (UNLIKELY(context->isFrozen())) {
+    context->frozenTasks()->enqueueEvent(context, eventTargetInstance, nativeEvent, isCustomEvent == 1);
+    return;
+  }
+
+  DocumentInstance* document = context->document();
+  if (EventCoalescer::isCoalescable(nativeEventType)) {
+    document->ensureEventCoalescer()->enqueue(eventTargetInstance, nativeEvent, isCustomEvent == 1);
+    return;
+  }
+
+  // Events from dart are input of the user, posted tasks of lower lanes wait for a continuation.
+  EventLoopScheduler::TaskScope scope(context, TaskLane::input);
+
+  // Dispatch continuous events arrived before this one first, listeners should observe events in the order they arrived.
+  if (document->eventCoalescer() != nullptr) {
+    document->eventCoalescer()->flush();
+  }
+
+  EventInstance* eventInstance = Event::buildEventInstance(nativeEventType, context, nativeEvent, isCustomEvent == 1);
   eventInstance->setTarget(eventTargetInstance);
   eventTargetInstance->dispatchEvent(eventInstance);
   JS_FreeValue(context->ctx(), eventInstance->jsObject);
@@ -6,6 +6,7 @@
 #ifndef KRAKENBRIDGE_EVENT_TARGET_H
 #define KRAKENBRIDGE_EVENT_TARGET_H
 
+#include <unordered_map>
 #include "bindings/qjs/dom/event.h"
 #include "bindings/qjs/executing_context.h"
 #include "bindings/qjs/heap_hashmap.h"
@@ -28,6 +29,27 @@ class StyleDeclarationInstance;
 
 void bindEventTarget(ExecutionContext* context);
 
+// Describe how a property which is not defined on the instance itself should be resolved.
+// EventTarget classes cache the handler by atom, so the exotic property hooks never need to convert atoms into strings.
+struct EventTargetPropertyHandler {
+  enum class Kind : uint8_t {
+    // Legacy "onEvent" attribute APIs, eg: element.onclick.
+    EventHandlerAttribute,
+    // Expando properties only visible to javascript, eg: names start with underscore.
+    PrivateExpando,
+    // Expando properties, which are also forwarded to dart when the owner is a plugin element.
+    Expando,
+  };
+  Kind kind{Kind::Expando};
+  // Set when this property was found on the prototype chain of the class.
+  // Prototypes are mutable from javascript, so this flag is verified again when the lookup failed.
+  bool onPrototype{false};
+  // The event type atom without "on" prefix for EventHandlerAttribute, eg: "click" for "onclick".
+  JSAtom eventType{JS_ATOM_NULL};
+  // Set when the handler did not fit in the class cache, the caller owns eventType then.
+  bool ownsEventType{false};
+};
+
 class EventTarget : public HostClass {
  public:
   static JSClassID kEventTargetClassId;
@@ -35,6 +57,7 @@ class EventTarget : public HostClass {
   EventTarget() = delete;
   explicit EventTarget(ExecutionContext* context, const char* name);
   explicit EventTarget(ExecutionContext* context);
+  ~EventTarget() override;
 
   static JSClassID classId();
   static JSClassID classId(JSValue& value);
@@ -49,6 +72,11 @@ class EventTarget : public HostClass {
   DEFINE_PROTOTYPE_FUNCTION(addEventListener, 3);
   DEFINE_PROTOTYPE_FUNCTION(removeEventListener, 2);
   DEFINE_PROTOTYPE_FUNCTION(dispatchEvent, 1);
+
+  EventTargetPropertyHandler resolvePropertyHandler(JSAtom atom);
+  void setPropertyOnPrototype(JSAtom atom, bool onPrototype);
+
+  std::unordered_map<JSAtom, EventTargetPropertyHandler> m_propertyHandlers;
   friend EventTargetInstance;
 };
 
@@ -83,9 +111,9 @@ class EventHandlerMap : public HeapHashMap<JSAtom> {
 class EventTargetInstance : public Instance {
  public:
   EventTargetInstance() = delete;
-  explicit EventTargetInstance(EventTarget* eventTarget, JSClassID classId, JSClassExoticMethods& exoticMethods, std::string name);
-  explicit EventTargetInstance(EventTarget* eventTarget, JSClassID classId, std::string name);
-  explicit EventTargetInstance(EventTarget* eventTarget, JSClassID classId, std::string name, int64_t eventTargetId);
+  explicit EventTargetInstance(EventTarget* eventTarget, JSClassID classId, JSClassExoticMethods& exoticMethods, const char* name);
+  explicit EventTargetInstance(EventTarget* eventTarget, JSClassID classId, const char* name);
+  explicit EventTargetInstance(EventTarget* eventTarget, JSClassID classId, const char* name, int64_t eventTargetId);
   ~EventTargetInstance();
 
   virtual bool dispatchEvent(EventInstance* event);
@@ -95,22 +123,31 @@ class EventTargetInstance : public Instance {
   JSValue callNativeMethods(const char* method, int32_t argc, NativeValue* argv);
   JSValue getNativeProperty(const char* prop);
 
-  NativeEventTarget* nativeEventTarget{new NativeEventTarget(this)};
+  NativeEventTarget nativeEventTarget{this};
 
  protected:
   int32_t m_eventTargetId;
+  // Plugin elements forward unknown properties to dart, this is decided by tagName when element created.
+  bool m_isJavaScriptExtensionElement{false};
+  // Most of eventTargets never have listeners or expando properties, so the maps below are created at first use.
+  // Use ensureXXX() to get a writable map, read paths should check for nullptr.
+
   // EventListener handlers registered with addEventListener API.
   // https://dom.spec.whatwg.org/#concept-event-listener
-  EventListenerMap m_eventListenerMap{m_ctx};
+  std::unique_ptr<EventListenerMap> m_eventListenerMap;
 
   // EventListener handlers registered with DOM attributes API.
   // https://html.spec.whatwg.org/C/#event-handler-attributes
-  EventHandlerMap m_eventHandlerMap{m_ctx};
+  std::unique_ptr<EventHandlerMap> m_eventHandlerMap;
 
   // When javascript code set a property on EventTarget instance, EventTarget::setProperty callback will be called when
   // property are not defined by Object.defineProperty or setProperty.
   // We store there values in here.
-  EventTargetProperties m_properties{m_ctx};
+  std::unique_ptr<EventTargetProperties> m_properties;
+
+  EventListenerMap* ensureEventListenerMap();
+  EventHandlerMap* ensureEventHandlerMap();
+  EventTargetProperties* ensureProperties();
 
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
   static void copyNodeProperties(EventTargetInstance* newNode, EventTargetInstance* referenceNode);
@@ -121,13 +158,30 @@ class EventTargetInstance : public Instance {
   static int deleteProperty(JSContext* ctx, JSValueConst obj, JSAtom prop);
 
   // Used for legacy "onEvent" attribute APIs.
-  void setAttributesEventHandler(JSString* p, JSValue value);
-  JSValue getAttributesEventHandler(JSString* p);
+  void setAttributesEventHandler(JSAtom eventType, JSValue value);
+  JSValue getAttributesEventHandler(JSAtom eventType);
+
+  // Return true when the instance is kept for reuse instead of being deleted at finalization.
+  virtual bool recycle() { return false; }
+
+  // Events from dart are dropped without creating event objects when no target of the propagation path listens to them.
+  // Return true to receive events of the type anyway, such as image releasing itself after loaded.
+  virtual bool hasDefaultEventHandler(NativeString* eventType) { return false; }
 
  private:
-  bool internalDispatchEvent(EventInstance* eventInstance);
+  // Collect targets of the propagation path, from this to window. Ancestors are collected for events which don't
+  // bubble too, their capturing listeners are still invoked.
+  // https://dom.spec.whatwg.org/#concept-event-path
+  void collectEventPath(std::vector<EventTargetInstance*>& path);
+  bool hasEventListener(JSAtom eventType) const;
+  // Listeners which may call preventDefault(), event handler attributes are never passive.
+  bool hasNonPassiveEventListener(JSAtom eventType) const;
+  // Send addEvent to dart for the first listener of eventType, or when listeners turned to be all passive or not.
+  void didChangeEventListeners(JSAtom eventType, bool wasListening, bool wasNonPassive);
+  bool internalDispatchEvent(EventInstance* eventInstance, EventInstance::Phase phase);
   static void finalize(JSRuntime* rt, JSValue val);
   friend EventTarget;
+  friend NativeEventTarget;
   friend StyleDeclarationInstance;
 };
 
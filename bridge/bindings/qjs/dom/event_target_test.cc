@@ -3,6 +3,7 @@
  * Author: Kraken Team.
  */
 
+#include "element.h"
 #include "event_target.h"
 #include "gtest/gtest.h"
 #include "kraken_test_env.h"
@@ -83,6 +84,57 @@ TEST(EventTarget, propertyEventHandler) {
   EXPECT_EQ(logCalled, true);
 }
 
+TEST(EventTarget, prototypePropertiesDefinedAfterAccess) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "undefined 1 2 3 1");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "let before = div.polyfilled;"
+      "div.expando = 1;"
+      "Object.defineProperty(Element.prototype, 'polyfilled', { get() { return 2; }, configurable: true });"
+      "let value = 0;"
+      "Object.defineProperty(Element.prototype, 'expando', { get() { return 3; }, set(v) { value = v; }, configurable: true });"
+      "div.expando = 1;"
+      "let polyfilled = div.polyfilled;"
+      "let expando = div.expando;"
+      "delete Element.prototype.expando;"
+      "console.log(before, value, polyfilled, expando, div.expando);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(EventTarget, eventHandlerAttributesBeyondPropertyHandlerCache) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "true 1 true");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "for (let i = 0; i < 5000; i ++) { div['onevent' + i] = null; }"
+      "let count = 0;"
+      "div.oncustom = function() { count++; };"
+      "div.dispatchEvent(new Event('custom'));"
+      "console.log(typeof div.oncustom === 'function', count, 'oncustom' in div);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
 TEST(EventTarget, setUnExpectedAttributeEventHandler) {
   bool static errorCalled = false;
   bool static logCalled = false;
@@ -216,6 +268,8 @@ TEST(EventTarget, dispatchEventOnGC) {
 {
 // Wrap div in a block scope will be freed by GC
 let div = document.createElement('div');
+// Make a reference cycle, so div is released by GC instead of reference counting.
+div.self = div;
 }
 window.onclick = () => {console.log(1234);}
 
@@ -276,3 +330,272 @@ TEST(EventTarget, shouldKeepAtom) {
   bridge->evaluateScript(code3.c_str(), code3.size(), "internal://", 0);
   EXPECT_EQ(logCalled, true);
 }
+
+TEST(EventTarget, idAllocatorReusesSlotsSafely) {
+  using foundation::EventTargetIdAllocator;
+
+  EventTargetIdAllocator allocator;
+  const size_t liveCount = 4096;
+  std::vector<int32_t> live;
+  // Live id of each slot, -1 when the slot is free.
+  std::vector<int32_t> ownerOfSlot;
+  int32_t failures = 0;
+
+  for (int32_t cycle = 0; cycle < 4000000; cycle++) {
+    int32_t id = allocator.allocate();
+    int32_t index = EventTargetIdAllocator::indexOf(id);
+    if (ownerOfSlot.size() <= index)
+      ownerOfSlot.resize(index + 1, -1);
+    // A slot is never handed out twice while alive, and ids are never negative.
+    if (id < 0 || ownerOfSlot[index] != -1)
+      failures++;
+    ownerOfSlot[index] = id;
+
+    if (live.size() < liveCount) {
+      live.push_back(id);
+      continue;
+    }
+    size_t victim = cycle % liveCount;
+    int32_t disposed = live[victim];
+    allocator.free(disposed);
+    ownerOfSlot[EventTargetIdAllocator::indexOf(disposed)] = -1;
+    // Stale ids are never live again, even after their slot is reused.
+    if (allocator.isLive(disposed))
+      failures++;
+    live[victim] = id;
+  }
+
+  EXPECT_EQ(failures, 0);
+  // Ids stay dense, slots are bounded by the peak of live targets.
+  EXPECT_LE(allocator.slotCount(), liveCount + EventTargetIdAllocator::kMinimumFreeSlots + 1);
+}
+
+TEST(EventTarget, reuseIdsOfDisposedEventTargets) {
+  bool static errorCalled = false;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  size_t slotCount = context->eventTargetIds()->slotCount();
+
+  std::string code = "for (let i = 0; i < 50000; i ++) { let div = document.createElement('div'); div.appendChild(document.createTextNode('')); }";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  JS_RunGC(context->runtime());
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_LE(context->eventTargetIds()->slotCount(), slotCount + 2 * foundation::EventTargetIdAllocator::kMinimumFreeSlots);
+}
+
+TEST(EventTarget, bubbleThroughPathComputedAtDispatch) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "child,parent,body,html,document,window");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code = R"(
+let parent = document.createElement('div');
+let child = document.createElement('div');
+parent.appendChild(child);
+document.body.appendChild(parent);
+let order = [];
+function listen(target, name) { target.addEventListener('touchmove', () => order.push(name)); }
+// Removing the child while dispatching does not change the targets of this dispatch.
+child.addEventListener('touchmove', () => parent.removeChild(child));
+listen(child, 'child');
+listen(parent, 'parent');
+listen(document.body, 'body');
+listen(document.documentElement, 'html');
+listen(document, 'document');
+listen(window, 'window');
+parent.addEventListener('click', () => order.push('click'));
+child.dispatchEvent(new CustomEvent('touchmove', { bubbles: true }));
+
+document.body.addEventListener('scroll', (e) => e.stopPropagation());
+listen(document, 'stopped');
+document.body.dispatchEvent(new CustomEvent('scroll', { bubbles: true }));
+console.log(order.join(','));
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(EventTarget, dispatchNativeEventToListenedTargets) {
+  using namespace kraken::binding::qjs;
+
+  bool static errorCalled = false;
+  static int logCount = 0;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "click");
+    logCount++;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { errorCalled = true; });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var listened = document.createElement('div');
+listened.onclick = (e) => console.log(e.type);
+var quiet = document.createElement('div');
+document.body.appendChild(listened);
+document.body.appendChild(quiet);
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  JSValue listened = JS_GetPropertyStr(context->ctx(), context->global(), "listened");
+  JSValue quiet = JS_GetPropertyStr(context->ctx(), context->global(), "quiet");
+  // Events without listeners on the propagation path are dropped before an event object is created.
+  TEST_dispatchEvent(context->getContextId(), static_cast<EventTargetInstance*>(JS_GetOpaque(quiet, Element::classId())), "click");
+  TEST_dispatchEvent(context->getContextId(), static_cast<EventTargetInstance*>(JS_GetOpaque(listened, Element::classId())), "touchmove");
+  TEST_dispatchEvent(context->getContextId(), static_cast<EventTargetInstance*>(JS_GetOpaque(listened, Element::classId())), "click");
+  JS_FreeValue(context->ctx(), listened);
+  JS_FreeValue(context->ctx(), quiet);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCount, 1);
+}
+
+TEST(EventTarget, coalesceContinuousEventsUntilNextFrame) {
+  using namespace kraken::binding::qjs;
+
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "a:scroll:2:true,a:micro,b:touchmove:1:true,a:click,a:scroll:1:true,a:micro");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { errorCalled = true; });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var a = document.createElement('div');
+var b = document.createElement('div');
+document.body.appendChild(a);
+document.body.appendChild(b);
+var order = [];
+function record(e, name) {
+  let coalesced = e.getCoalescedEvents();
+  order.push(name + ':' + e.type + ':' + coalesced.length + ':' + coalesced.every(c => c.target === e.target && c.type === e.type));
+}
+a.addEventListener('scroll', e => {
+  record(e, 'a');
+  Promise.resolve().then(() => order.push('a:micro'));
+});
+b.addEventListener('touchmove', e => record(e, 'b'));
+a.addEventListener('click', e => order.push('a:click'));
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  JSValue aValue = JS_GetPropertyStr(context->ctx(), context->global(), "a");
+  JSValue bValue = JS_GetPropertyStr(context->ctx(), context->global(), "b");
+  auto* a = static_cast<EventTargetInstance*>(JS_GetOpaque(aValue, Element::classId()));
+  auto* b = static_cast<EventTargetInstance*>(JS_GetOpaque(bValue, Element::classId()));
+  int32_t contextId = context->getContextId();
+
+  TEST_dispatchEvent(contextId, a, "scroll");
+  TEST_dispatchEvent(contextId, b, "touchmove");
+  TEST_dispatchEvent(contextId, a, "scroll");
+  TEST_dispatchEvent(contextId, b, "touchmove");
+  TEST_dispatchEvent(contextId, a, "scroll");
+  // Discrete events dispatch pending continuous events first.
+  TEST_dispatchEvent(contextId, a, "click");
+
+  // Continuous events wait for the next frame.
+  TEST_dispatchEvent(contextId, a, "scroll");
+  TEST_dispatchEvent(contextId, a, "scroll");
+  TEST_runLoop(context);
+
+  // Pending events are released with the page.
+  TEST_dispatchEvent(contextId, b, "touchmove");
+
+  JS_FreeValue(context->ctx(), aValue);
+  JS_FreeValue(context->ctx(), bValue);
+
+  std::string check = "console.log(order.join(','))";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(EventTarget, captureOnceAndPassiveListeners) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "capture:1,targetCapture:2,target:2,once,capture:1,targetCapture:2,target:2,bubble:3 false true 0");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code = R"(
+let parent = document.createElement('div');
+let child = document.createElement('div');
+parent.appendChild(child);
+document.body.appendChild(parent);
+let order = [];
+let bubble = e => order.push('bubble:' + e.eventPhase);
+parent.addEventListener('focus', e => order.push('capture:' + e.eventPhase), true);
+parent.addEventListener('focus', bubble);
+child.addEventListener('focus', e => order.push('target:' + e.eventPhase));
+child.addEventListener('focus', e => order.push('targetCapture:' + e.eventPhase), { capture: true });
+child.addEventListener('focus', e => order.push('once'), { once: true });
+// Listeners of ancestors only capture events which don't bubble.
+child.dispatchEvent(new CustomEvent('focus'));
+parent.removeEventListener('focus', bubble, true);
+child.dispatchEvent(new CustomEvent('focus', { bubbles: true }));
+
+let passive = new CustomEvent('touchmove', { cancelable: true });
+child.addEventListener('touchmove', e => e.preventDefault(), { passive: true });
+child.dispatchEvent(passive);
+let active = new CustomEvent('touchmove', { cancelable: true });
+child.addEventListener('touchmove', e => e.preventDefault());
+child.dispatchEvent(active);
+console.log(order.join(','), passive.defaultPrevented, active.defaultPrevented, active.eventPhase);
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(EventTarget, notifyDartWhetherListenersArePassive) {
+  using namespace kraken::binding::qjs;
+
+  bool static errorCalled = false;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { errorCalled = true; });
+  auto context = bridge->getContext();
+  std::string code = R"(
+let div = document.createElement('div');
+let active = e => e.preventDefault();
+div.addEventListener('touchmove', () => {}, { passive: true });
+div.addEventListener('touchmove', () => {}, { passive: true });
+div.addEventListener('touchmove', active);
+div.removeEventListener('touchmove', active);
+div.ontouchmove = () => {};
+let span = document.createElement('span');
+span.addEventListener('touchstart', active);
+span.removeEventListener('touchstart', active);
+span.addEventListener('touchstart', () => {}, { passive: true });
+)";
+  context->uiCommandBuffer()->clear();
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  // Only the first listener and changes of passive state are sent to dart, removing the last listener counts as passive.
+  std::string passiveStates;
+  UICommandItem* commands = context->uiCommandBuffer()->data();
+  for (int64_t i = 0; i < context->uiCommandBuffer()->size(); i++) {
+    if (commands[i].type == UICommand::addEvent) {
+      EXPECT_EQ(commands[i].args_02_length, 1);
+      passiveStates += static_cast<char>(reinterpret_cast<const uint16_t*>(commands[i].string_02)[0]);
+    }
+  }
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(passiveStates, "1010011");
+}
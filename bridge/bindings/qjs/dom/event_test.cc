@@ -23,3 +23,20 @@ TEST(MouseEvent, init) {
   EXPECT_EQ(errorCalled, false);
   EXPECT_EQ(logCalled, true);
 }
+
+TEST(TouchEvent, touchListsAreCreatedOnce) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "true true 0");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { errorCalled = true; });
+  const char* code =
+      "let touchEvent = new TouchEvent('touchmove');"
+      "console.log(touchEvent.touches === touchEvent.touches, touchEvent.changedTouches === touchEvent.changedTouches, touchEvent.targetTouches.length);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
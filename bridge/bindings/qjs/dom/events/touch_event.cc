@@ -14,13 +14,32 @@ void bindTouchEvent(ExecutionContext* context) {
   context->defineGlobalProperty("TouchEvent", constructor->jsObject);
 }
 
-TouchList::TouchList(ExecutionContext* context, NativeTouch** touches, int64_t length) : ExoticHostObject(context, "TouchList"), m_touches(touches), _length(length) {}
+TouchList::TouchList(ExecutionContext* context, NativeTouch** touches, int64_t length)
+    : ExoticHostObject(context, "TouchList"), m_touches(touches), _length(length), m_touchObjects(length, JS_NULL) {}
+
+TouchList::~TouchList() {
+  for (JSValue touch : m_touchObjects) {
+    JS_FreeValueRT(ExecutionContext::runtime(), touch);
+  }
+}
+
+void TouchList::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  for (JSValue touch : m_touchObjects) {
+    JS_MarkValue(rt, touch, mark_func);
+  }
+}
 
 JSValue TouchList::getProperty(JSContext* ctx, JSValue obj, JSAtom atom, JSValue receiver) {
   std::string key = jsAtomToStdString(ctx, atom);
   if (isNumberIndex(key)) {
     size_t index = std::stoi(key);
-    return (new Touch(m_context, m_touches[index]))->jsObject;
+    if (index >= _length)
+      return JS_UNDEFINED;
+
+    if (JS_IsNull(m_touchObjects[index])) {
+      m_touchObjects[index] = (new Touch(m_context, m_touches[index]))->jsObject;
+    }
+    return JS_DupValue(ctx, m_touchObjects[index]);
   }
 
   return JS_NULL;
@@ -209,25 +228,29 @@ JSValue TouchEvent::instanceConstructor(JSContext* ctx, JSValue func_obj, JSValu
   auto event = new TouchEventInstance(this, reinterpret_cast<NativeEvent*>(nativeEvent));
   return event->jsObject;
 }
+static JSValue ensureTouchList(TouchEventInstance* event, JSValue& touchList, NativeTouch** touches, int64_t length) {
+  if (JS_IsNull(touchList)) {
+    touchList = (new TouchList(event->context(), touches, length))->jsObject;
+  }
+  return JS_DupValue(event->context()->ctx(), touchList);
+}
+
 IMPL_PROPERTY_GETTER(TouchEvent, touches)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* event = static_cast<TouchEventInstance*>(JS_GetOpaque(this_val, Event::kEventClassID));
   auto* nativeEvent = reinterpret_cast<NativeTouchEvent*>(event->nativeEvent);
-  auto* touchList = new TouchList(event->m_context, nativeEvent->touches, nativeEvent->touchLength);
-  return touchList->jsObject;
+  return ensureTouchList(event, event->m_touches, nativeEvent->touches, nativeEvent->touchLength);
 }
 
 IMPL_PROPERTY_GETTER(TouchEvent, targetTouches)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* event = static_cast<TouchEventInstance*>(JS_GetOpaque(this_val, Event::kEventClassID));
   auto* nativeEvent = reinterpret_cast<NativeTouchEvent*>(event->nativeEvent);
-  auto* targetTouchList = new TouchList(event->m_context, nativeEvent->targetTouches, nativeEvent->targetTouchesLength);
-  return targetTouchList->jsObject;
+  return ensureTouchList(event, event->m_targetTouches, nativeEvent->targetTouches, nativeEvent->targetTouchesLength);
 }
 
 IMPL_PROPERTY_GETTER(TouchEvent, changedTouches)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* event = static_cast<TouchEventInstance*>(JS_GetOpaque(this_val, Event::kEventClassID));
   auto* nativeEvent = reinterpret_cast<NativeTouchEvent*>(event->nativeEvent);
-  auto* changedTouchList = new TouchList(event->m_context, nativeEvent->changedTouches, nativeEvent->changedTouchesLength);
-  return changedTouchList->jsObject;
+  return ensureTouchList(event, event->m_changedTouches, nativeEvent->changedTouches, nativeEvent->changedTouchesLength);
 }
 
 IMPL_PROPERTY_GETTER(TouchEvent, altKey)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
@@ -256,4 +279,17 @@ IMPL_PROPERTY_GETTER(TouchEvent, shiftKey)(JSContext* ctx, JSValue this_val, int
 
 TouchEventInstance::TouchEventInstance(TouchEvent* event, NativeEvent* nativeEvent) : EventInstance(event, nativeEvent) {}
 
+TouchEventInstance::~TouchEventInstance() {
+  JS_FreeValueRT(ExecutionContext::runtime(), m_touches);
+  JS_FreeValueRT(ExecutionContext::runtime(), m_targetTouches);
+  JS_FreeValueRT(ExecutionContext::runtime(), m_changedTouches);
+}
+
+void TouchEventInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  EventInstance::trace(rt, val, mark_func);
+  JS_MarkValue(rt, m_touches, mark_func);
+  JS_MarkValue(rt, m_targetTouches, mark_func);
+  JS_MarkValue(rt, m_changedTouches, mark_func);
+}
+
 }  // namespace kraken::binding::qjs
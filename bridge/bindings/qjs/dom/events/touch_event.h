@@ -58,14 +58,20 @@ class TouchList : public ExoticHostObject {
  public:
   TouchList() = delete;
   explicit TouchList(ExecutionContext* context, NativeTouch** touches, int64_t length);
+  ~TouchList() override;
 
   JSValue getProperty(JSContext* ctx, JSValueConst obj, JSAtom atom, JSValueConst receiver);
   int setProperty(JSContext* ctx, JSValueConst obj, JSAtom atom, JSValueConst value, JSValueConst receiver, int flags);
 
+ protected:
+  void trace(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func) override;
+
  private:
   DEFINE_PROPERTY(length);
   NativeTouch** m_touches{nullptr};
   int64_t _length;
+  // Touch objects are created at first access by index.
+  std::vector<JSValue> m_touchObjects;
 };
 
 struct NativeTouchEvent {
@@ -108,8 +114,16 @@ class TouchEventInstance : public EventInstance {
  public:
   TouchEventInstance() = delete;
   explicit TouchEventInstance(TouchEvent* event, NativeEvent* nativeEvent);
+  ~TouchEventInstance() override;
+
+ protected:
+  void trace(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func) override;
 
  private:
+  // TouchLists are created at first access, most listeners only read the coordinates of changedTouches.
+  JSValue m_touches{JS_NULL};
+  JSValue m_targetTouches{JS_NULL};
+  JSValue m_changedTouches{JS_NULL};
   friend TouchEvent;
 };
 
@@ -4,6 +4,7 @@
  */
 
 #include "frame_request_callback_collection.h"
+#include <algorithm>
 
 namespace kraken::binding::qjs {
 
@@ -42,23 +43,48 @@ void FrameCallback::dispose() const {
 }
 
 void FrameRequestCallbackCollection::registerFrameCallback(uint32_t callbackId, FrameCallback* frameCallback) {
-  m_frameCallbacks[callbackId] = frameCallback;
+  frameCallback->setCallbackId(callbackId);
+  m_frameCallbacks.emplace_back(frameCallback);
 }
 
 void FrameRequestCallbackCollection::cancelFrameCallback(uint32_t callbackId) {
-  if (m_frameCallbacks.count(callbackId) == 0)
+  auto it = std::find_if(m_frameCallbacks.begin(), m_frameCallbacks.end(), [callbackId](FrameCallback* callback) { return callback->callbackId() == callbackId; });
+  if (it != m_frameCallbacks.end()) {
+    // Push this callback to abandoned list to mark this callback is deprecated.
+    m_abandonedCallbacks.emplace_back(*it);
+    m_frameCallbacks.erase(it);
     return;
-  FrameCallback* callback = m_frameCallbacks[callbackId];
+  }
+
+  // Callbacks of the current frame are skipped when cancelled by an earlier one.
+  for (FrameCallback* callback : m_callbacksToInvoke) {
+    if (callback->callbackId() == callbackId) {
+      callback->setIsCancelled(true);
+      return;
+    }
+  }
+}
 
-  // Push this timer to abandoned list to mark this timer is deprecated.
-  m_abandonedCallbacks.emplace_back(callback);
+void FrameRequestCallbackCollection::executeFrameCallbacks(double highResTimeStamp) {
+  m_callbacksToInvoke.swap(m_frameCallbacks);
+  for (size_t i = 0; i < m_callbacksToInvoke.size(); i++) {
+    FrameCallback* callback = m_callbacksToInvoke[i];
+    if (!callback->isCancelled()) {
+      callback->fire(highResTimeStamp);
+    }
+  }
 
-  m_frameCallbacks.erase(callbackId);
+  // Fired callbacks are freed at the next GC.
+  m_abandonedCallbacks.insert(m_abandonedCallbacks.end(), m_callbacksToInvoke.begin(), m_callbacksToInvoke.end());
+  m_callbacksToInvoke.clear();
 }
 
 void FrameRequestCallbackCollection::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
   for (auto& callback : m_frameCallbacks) {
-    JS_MarkValue(rt, callback.second->toQuickJS(), mark_func);
+    JS_MarkValue(rt, callback->toQuickJS(), mark_func);
+  }
+  for (auto& callback : m_callbacksToInvoke) {
+    JS_MarkValue(rt, callback->toQuickJS(), mark_func);
   }
 
   // Recycle all abandoned callbacks.
@@ -20,6 +20,11 @@ class FrameCallback : public GarbageCollected<FrameCallback> {
 
   void fire(double highResTimeStamp);
 
+  FORCE_INLINE uint32_t callbackId() const { return m_callbackId; }
+  FORCE_INLINE void setCallbackId(uint32_t callbackId) { m_callbackId = callbackId; }
+  FORCE_INLINE bool isCancelled() const { return m_isCancelled; }
+  FORCE_INLINE void setIsCancelled(bool isCancelled) { m_isCancelled = isCancelled; }
+
   [[nodiscard]] FORCE_INLINE const char* getHumanReadableName() const override { return "FrameCallback"; }
 
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const override;
@@ -27,7 +32,8 @@ class FrameCallback : public GarbageCollected<FrameCallback> {
 
  private:
   JSValue m_callback{JS_NULL};
-  int32_t m_callbackId{-1};
+  uint32_t m_callbackId{0};
+  bool m_isCancelled{false};
 };
 
 class FrameRequestCallbackCollection final {
@@ -35,9 +41,16 @@ class FrameRequestCallbackCollection final {
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func);
   void registerFrameCallback(uint32_t callbackId, FrameCallback* frameCallback);
   void cancelFrameCallback(uint32_t callbackId);
+  // Run the callbacks registered before this frame in the order they were registered, callbacks registered by them
+  // wait for the next frame.
+  // https://html.spec.whatwg.org/multipage/imagebitmap-and-animations.html#run-the-animation-frame-callbacks
+  void executeFrameCallbacks(double highResTimeStamp);
+  FORCE_INLINE bool isEmpty() const { return m_frameCallbacks.empty(); }
 
  private:
-  std::unordered_map<uint32_t, FrameCallback*> m_frameCallbacks;
+  std::vector<FrameCallback*> m_frameCallbacks;
+  // Callbacks of the frame being serviced.
+  std::vector<FrameCallback*> m_callbacksToInvoke;
   std::vector<FrameCallback*> m_abandonedCallbacks;
 };
 
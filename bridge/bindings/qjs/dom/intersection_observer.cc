@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "intersection_observer.h"
+#include <algorithm>
+#include <sstream>
+#include "bindings/qjs/dom/events/.gen/intersection_change.h"
+#include "bindings/qjs/qjs_patch.h"
+#include "document.h"
+#include "element.h"
+#include "kraken_bridge.h"
+
+namespace kraken::binding::qjs {
+
+std::once_flag kIntersectionObserverInitFlag;
+
+void bindIntersectionObserver(ExecutionContext* context) {
+  auto* constructor = IntersectionObserver::instance(context);
+  context->defineGlobalProperty("IntersectionObserver", constructor->jsObject);
+}
+
+JSClassID IntersectionObserver::kIntersectionObserverClassId{0};
+
+IntersectionObserver::IntersectionObserver(ExecutionContext* context) : HostClass(context, "IntersectionObserver") {
+  std::call_once(kIntersectionObserverInitFlag, []() { JS_NewClassID(&kIntersectionObserverClassId); });
+}
+
+// Accept one to four lengths in px or %, and expand them to four like the margin property.
+static bool parseRootMargin(const std::string& value, std::string& rootMargin) {
+  std::vector<std::string> sides;
+  std::istringstream stream(value);
+  std::string token;
+  while (stream >> token) {
+    size_t unitStart = token.find_first_not_of("+-.0123456789");
+    std::string number = token.substr(0, unitStart);
+    std::string unit = unitStart == std::string::npos ? "" : token.substr(unitStart);
+    if (number.empty() || number.find_first_of("0123456789") == std::string::npos)
+      return false;
+    if (unit.empty()) {
+      // Only zero may omit the unit.
+      if (std::stod(number) != 0)
+        return false;
+      unit = "px";
+    } else if (unit != "px" && unit != "%") {
+      return false;
+    }
+    sides.emplace_back(number + unit);
+  }
+
+  if (sides.empty() || sides.size() > 4)
+    return false;
+  if (sides.size() < 2)
+    sides.emplace_back(sides[0]);
+  if (sides.size() < 3)
+    sides.emplace_back(sides[0]);
+  if (sides.size() < 4)
+    sides.emplace_back(sides[1]);
+
+  rootMargin = sides[0] + " " + sides[1] + " " + sides[2] + " " + sides[3];
+  return true;
+}
+
+JSValue IntersectionObserver::instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue this_val, int argc, JSValue* argv) {
+  if (argc < 1 || !JS_IsFunction(ctx, argv[0])) {
+    return JS_ThrowTypeError(ctx, "Failed to construct 'IntersectionObserver': parameter 1 is not of type 'Function'.");
+  }
+
+  std::vector<double> thresholds;
+  std::string rootMargin = "0px 0px 0px 0px";
+  JSValue options = argc > 1 ? argv[1] : JS_UNDEFINED;
+
+  if (JS_IsObject(options)) {
+    JSValue root = JS_GetPropertyStr(ctx, options, "root");
+    bool hasRoot = !JS_IsNull(root) && !JS_IsUndefined(root);
+    JS_FreeValue(ctx, root);
+    // Intersections are computed by dart against the viewport only.
+    if (hasRoot) {
+      return JS_ThrowTypeError(ctx, "Failed to construct 'IntersectionObserver': only the implicit root is supported.");
+    }
+
+    JSValue rootMarginValue = JS_GetPropertyStr(ctx, options, "rootMargin");
+    if (!JS_IsUndefined(rootMarginValue)) {
+      std::string value = jsValueToStdString(ctx, rootMarginValue);
+      if (!parseRootMargin(value, rootMargin)) {
+        JS_FreeValue(ctx, rootMarginValue);
+        return JS_ThrowSyntaxError(ctx, "Failed to construct 'IntersectionObserver': rootMargin must be specified in pixels or percent.");
+      }
+    }
+    JS_FreeValue(ctx, rootMarginValue);
+
+    JSValue thresholdValue = JS_GetPropertyStr(ctx, options, "threshold");
+    if (JS_IsArray(ctx, thresholdValue)) {
+      int32_t length = arrayGetLength(ctx, thresholdValue);
+      for (int32_t i = 0; i < length; i++) {
+        JSValue item = JS_GetPropertyUint32(ctx, thresholdValue, i);
+        double threshold;
+        JS_ToFloat64(ctx, &threshold, item);
+        JS_FreeValue(ctx, item);
+        thresholds.emplace_back(threshold);
+      }
+    } else if (!JS_IsUndefined(thresholdValue)) {
+      double threshold;
+      JS_ToFloat64(ctx, &threshold, thresholdValue);
+      thresholds.emplace_back(threshold);
+    }
+    JS_FreeValue(ctx, thresholdValue);
+  }
+
+  for (double threshold : thresholds) {
+    // NaN fails both comparisons.
+    if (!(threshold >= 0 && threshold <= 1)) {
+      return JS_ThrowRangeError(ctx, "Failed to construct 'IntersectionObserver': Threshold values must be numbers between 0 and 1");
+    }
+  }
+  if (thresholds.empty()) {
+    thresholds.emplace_back(0);
+  }
+  std::sort(thresholds.begin(), thresholds.end());
+
+  auto* observer = new IntersectionObserverInstance(this, argv[0], std::move(thresholds), std::move(rootMargin));
+  return observer->jsObject;
+}
+
+static IntersectionObserverInstance* thisObserver(JSValue this_val) {
+  return static_cast<IntersectionObserverInstance*>(JS_GetOpaque(this_val, IntersectionObserver::kIntersectionObserverClassId));
+}
+
+IMPL_PROPERTY_GETTER(IntersectionObserver, root)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  return JS_NULL;
+}
+
+IMPL_PROPERTY_GETTER(IntersectionObserver, rootMargin)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr)
+    return JS_UNDEFINED;
+  return JS_NewString(ctx, observer->m_rootMargin.c_str());
+}
+
+IMPL_PROPERTY_GETTER(IntersectionObserver, thresholds)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr)
+    return JS_UNDEFINED;
+  JSValue thresholds = JS_NewArray(ctx);
+  for (uint32_t i = 0; i < observer->m_thresholds.size(); i++) {
+    JS_SetPropertyUint32(ctx, thresholds, i, JS_NewFloat64(ctx, observer->m_thresholds[i]));
+  }
+  return thresholds;
+}
+
+static ElementInstance* targetElement(int argc, JSValue* argv) {
+  if (argc < 1)
+    return nullptr;
+  return static_cast<ElementInstance*>(JS_GetOpaque(argv[0], Element::classId()));
+}
+
+JSValue IntersectionObserver::observe(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'IntersectionObserver': this is not an IntersectionObserver object.");
+  }
+  ElementInstance* element = targetElement(argc, argv);
+  if (element == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'IntersectionObserver': parameter 1 is not of type 'Element'.");
+  }
+  observer->observe(element);
+  return JS_UNDEFINED;
+}
+
+JSValue IntersectionObserver::unobserve(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'unobserve' on 'IntersectionObserver': this is not an IntersectionObserver object.");
+  }
+  ElementInstance* element = targetElement(argc, argv);
+  if (element == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'unobserve' on 'IntersectionObserver': parameter 1 is not of type 'Element'.");
+  }
+  observer->unobserve(element);
+  return JS_UNDEFINED;
+}
+
+JSValue IntersectionObserver::disconnect(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'disconnect' on 'IntersectionObserver': this is not an IntersectionObserver object.");
+  }
+  observer->disconnect();
+  return JS_UNDEFINED;
+}
+
+JSValue IntersectionObserver::takeRecords(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'takeRecords' on 'IntersectionObserver': this is not an IntersectionObserver object.");
+  }
+  return observer->takeRecords();
+}
+
+IntersectionObserverInstance::IntersectionObserverInstance(IntersectionObserver* intersectionObserver, JSValue callback, std::vector<double>&& thresholds, std::string&& rootMargin)
+    : Instance(intersectionObserver, "IntersectionObserver", nullptr, IntersectionObserver::kIntersectionObserverClassId, finalize),
+      m_callback(JS_DupValue(m_ctx, callback)),
+      m_thresholds(std::move(thresholds)),
+      m_rootMargin(std::move(rootMargin)) {}
+
+IntersectionObserverInstance::~IntersectionObserverInstance() {
+  JSRuntime* rt = ExecutionContext::runtime();
+  // Registrations keep this observer alive, so it is only collected with registrations left when the GC frees it
+  // together with the elements observed. Unlink it from them, their references go with the cycle.
+  for (ElementInstance* element : m_targets) {
+    unregister(element);
+  }
+  for (JSValue entry : m_entries) {
+    JS_FreeValueRT(rt, entry);
+  }
+  JS_FreeValueRT(rt, m_callback);
+}
+
+void IntersectionObserverInstance::observe(ElementInstance* element) {
+  auto& registrations = m_context->m_intersectionObserverRegistrations[element];
+  element->setNodeFlag(NodeInstance::NodeFlag::IsIntersectionObserved);
+  if (std::any_of(registrations.begin(), registrations.end(), [this](const IntersectionObserverRegistration& registration) { return registration.observer == this; }))
+    return;
+
+  // The registration keeps the observer alive until it is dropped.
+  registrations.push_back({this});
+  JS_DupValue(m_ctx, jsObject);
+  m_targets.push_back(element);
+  updateRegistration(element);
+}
+
+void IntersectionObserverInstance::unobserve(ElementInstance* element) {
+  auto it = std::find(m_targets.begin(), m_targets.end(), element);
+  if (it == m_targets.end())
+    return;
+  m_targets.erase(it);
+
+  unregister(element);
+  updateRegistration(element);
+  JS_FreeValue(m_ctx, jsObject);
+}
+
+void IntersectionObserverInstance::unregister(ElementInstance* element) {
+  auto& observedElementRegistrations = m_context->m_intersectionObserverRegistrations;
+  auto it = observedElementRegistrations.find(element);
+  auto& registrations = it->second;
+  registrations.erase(std::remove_if(registrations.begin(), registrations.end(), [this](const IntersectionObserverRegistration& registration) { return registration.observer == this; }),
+                      registrations.end());
+  if (registrations.empty()) {
+    observedElementRegistrations.erase(it);
+    element->removeNodeFlag(NodeInstance::NodeFlag::IsIntersectionObserved);
+  }
+}
+
+void IntersectionObserverInstance::disconnect() {
+  // Keep this alive while the references from elements are released.
+  JS_DupValue(m_ctx, jsObject);
+  while (!m_targets.empty()) {
+    unobserve(m_targets.back());
+  }
+  JS_FreeValue(m_ctx, jsObject);
+}
+
+JSValue IntersectionObserverInstance::takeRecords() {
+  JSValue entries = JS_NewArray(m_ctx);
+  for (uint32_t i = 0; i < m_entries.size(); i++) {
+    JS_SetPropertyUint32(m_ctx, entries, i, m_entries[i]);
+  }
+  m_entries.clear();
+  return entries;
+}
+
+std::vector<IntersectionObserverRegistration>* IntersectionObserverInstance::registrationsOf(const ElementInstance* element) {
+  auto& observedElementRegistrations = element->context()->m_intersectionObserverRegistrations;
+  auto it = observedElementRegistrations.find(element);
+  return it != observedElementRegistrations.end() ? &it->second : nullptr;
+}
+
+void IntersectionObserverInstance::clearRegistrations(ElementInstance* element) {
+  auto& observedElementRegistrations = element->context()->m_intersectionObserverRegistrations;
+  auto it = observedElementRegistrations.find(element);
+  if (it == observedElementRegistrations.end())
+    return;
+
+  std::vector<IntersectionObserverRegistration> registrations = std::move(it->second);
+  observedElementRegistrations.erase(it);
+  element->removeNodeFlag(NodeInstance::NodeFlag::IsIntersectionObserved);
+  for (auto& registration : registrations) {
+    IntersectionObserverInstance* observer = registration.observer;
+    observer->m_targets.erase(std::remove(observer->m_targets.begin(), observer->m_targets.end(), element), observer->m_targets.end());
+    // The element does not touch the observer after this, releasing the last reference may finalize it.
+    JS_FreeValueRT(ExecutionContext::runtime(), observer->jsObject);
+  }
+}
+
+void IntersectionObserverInstance::traceRegistrations(const ElementInstance* element, JSRuntime* rt, JS_MarkFunc* mark_func) {
+  auto* registrations = registrationsOf(element);
+  if (registrations == nullptr)
+    return;
+  for (auto& registration : *registrations) {
+    JS_MarkValue(rt, registration.observer->jsObject, mark_func);
+  }
+}
+
+void IntersectionObserverInstance::updateRegistration(ElementInstance* element) {
+  auto* registrations = registrationsOf(element);
+  foundation::UICommandBuffer* commandBuffer = element->context()->uiCommandBuffer();
+  if (registrations == nullptr) {
+    commandBuffer->addCommand(element->eventTargetId(), UICommand::unobserveIntersection, nullptr);
+    return;
+  }
+
+  // Dart computes one intersection for each element, it reports when any threshold of the observers is crossed.
+  // Observers of the same element are expected to agree on rootMargin, the first one is used.
+  std::vector<double> thresholds;
+  for (auto& registration : *registrations) {
+    thresholds.insert(thresholds.end(), registration.observer->m_thresholds.begin(), registration.observer->m_thresholds.end());
+  }
+  std::sort(thresholds.begin(), thresholds.end());
+  thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+
+  std::ostringstream thresholdList;
+  for (size_t i = 0; i < thresholds.size(); i++) {
+    if (i > 0) {
+      thresholdList << ',';
+    }
+    thresholdList << thresholds[i];
+  }
+
+  std::unique_ptr<NativeString> args_01 = stringToNativeString(thresholdList.str());
+  std::unique_ptr<NativeString> args_02 = stringToNativeString(registrations->front().observer->m_rootMargin);
+  commandBuffer->addCommand(element->eventTargetId(), UICommand::observeIntersection, *args_01, *args_02, nullptr);
+}
+
+void IntersectionObserverInstance::queueEntries(ElementInstance* target, NativeEvent* nativeEvent) {
+  auto* registrations = target->hasNodeFlag(NodeInstance::NodeFlag::IsIntersectionObserved) ? registrationsOf(target) : nullptr;
+  if (registrations == nullptr)
+    return;
+
+  double intersectionRatio = reinterpret_cast<NativeIntersectionChangeEvent*>(nativeEvent)->intersectionRatio;
+  bool isIntersecting = intersectionRatio > 0;
+  ExecutionContext* context = target->context();
+  JSContext* ctx = context->ctx();
+  double time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - context->timeOrigin).count() / 1000.0;
+
+  for (auto& registration : *registrations) {
+    IntersectionObserverInstance* observer = registration.observer;
+    const std::vector<double>& thresholds = observer->m_thresholds;
+    auto thresholdIndex = static_cast<int32_t>(std::upper_bound(thresholds.begin(), thresholds.end(), intersectionRatio) - thresholds.begin());
+    if (thresholdIndex == registration.previousThresholdIndex && isIntersecting == registration.previousIsIntersecting)
+      continue;
+    registration.previousThresholdIndex = thresholdIndex;
+    registration.previousIsIntersecting = isIntersecting;
+
+    // https://w3c.github.io/IntersectionObserver/#intersection-observer-entry
+    JSValue entry = JS_NewObject(ctx);
+    JS_SetPropertyStr(ctx, entry, "time", JS_NewFloat64(ctx, time));
+    JS_SetPropertyStr(ctx, entry, "target", JS_DupValue(ctx, target->jsObject));
+    JS_SetPropertyStr(ctx, entry, "intersectionRatio", JS_NewFloat64(ctx, intersectionRatio));
+    JS_SetPropertyStr(ctx, entry, "isIntersecting", JS_NewBool(ctx, isIntersecting));
+    JS_SetPropertyStr(ctx, entry, "rootBounds", JS_NULL);
+    observer->enqueueEntry(entry);
+  }
+}
+
+void IntersectionObserverInstance::enqueueEntry(JSValue entry) {
+  m_entries.push_back(entry);
+  if (m_entries.size() > 1)
+    return;
+
+  // The first entry since last delivery, request a frame unless there is one already.
+  DocumentInstance* document = m_context->document();
+  if (document->m_pendingIntersectionObservers.empty()) {
+    JSValue callback = JS_NewCFunction(m_ctx, deliverEntries, "deliverIntersectionObserverEntries", 1);
+    auto* frameCallback = makeGarbageCollected<FrameCallback>(callback)->initialize(m_ctx, &FrameCallback::classId);
+    document->requestAnimationFrame(frameCallback);
+  }
+  document->m_pendingIntersectionObservers.push_back(JS_DupValue(m_ctx, jsObject));
+}
+
+JSValue IntersectionObserverInstance::deliverEntries(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+  if (!context->isValid())
+    return JS_NULL;
+
+  // Entries queued by callbacks are delivered at the next frame.
+  std::vector<JSValue> observers;
+  observers.swap(context->document()->m_pendingIntersectionObservers);
+  for (JSValue observerValue : observers) {
+    auto* observer = thisObserver(observerValue);
+    // Entries may have been taken by takeRecords().
+    if (!observer->m_entries.empty()) {
+      JSValue entries = observer->takeRecords();
+      JSValue arguments[] = {entries, observerValue};
+      JSValue returnValue = JS_Call(ctx, observer->m_callback, observerValue, 2, arguments);
+      context->handleException(&returnValue);
+      JS_FreeValue(ctx, returnValue);
+      JS_FreeValue(ctx, entries);
+    }
+    JS_FreeValue(ctx, observerValue);
+  }
+  return JS_NULL;
+}
+
+void IntersectionObserverInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  JS_MarkValue(rt, m_callback, mark_func);
+  for (JSValue entry : m_entries) {
+    JS_MarkValue(rt, entry, mark_func);
+  }
+}
+
+void IntersectionObserverInstance::finalize(JSRuntime* rt, JSValue val) {
+  auto* observer = thisObserver(val);
+  delete observer;
+}
+
+}  // namespace kraken::binding::qjs
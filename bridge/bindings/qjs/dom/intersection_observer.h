@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_INTERSECTION_OBSERVER_H
+#define KRAKENBRIDGE_INTERSECTION_OBSERVER_H
+
+#include <string>
+#include <vector>
+#include "bindings/qjs/host_class.h"
+#include "event.h"
+
+namespace kraken::binding::qjs {
+
+void bindIntersectionObserver(ExecutionContext* context);
+
+class ElementInstance;
+class IntersectionObserverInstance;
+
+// An element observed by an observer, kept in the side table of observed elements. Each registration keeps a
+// reference to its observer, released when it is dropped.
+// https://w3c.github.io/IntersectionObserver/#intersectionobserverregistration
+struct IntersectionObserverRegistration {
+  IntersectionObserverInstance* observer;
+  int32_t previousThresholdIndex{-1};
+  bool previousIsIntersecting{false};
+};
+
+class IntersectionObserver : public HostClass {
+ public:
+  static JSClassID kIntersectionObserverClassId;
+  IntersectionObserver() = delete;
+  explicit IntersectionObserver(ExecutionContext* context);
+
+  JSValue instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue this_val, int argc, JSValue* argv) override;
+
+  OBJECT_INSTANCE(IntersectionObserver);
+
+  static JSValue observe(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue unobserve(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue disconnect(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue takeRecords(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+
+ private:
+  DEFINE_PROTOTYPE_READONLY_PROPERTY(root);
+  DEFINE_PROTOTYPE_READONLY_PROPERTY(rootMargin);
+  DEFINE_PROTOTYPE_READONLY_PROPERTY(thresholds);
+
+  DEFINE_PROTOTYPE_FUNCTION(observe, 1);
+  DEFINE_PROTOTYPE_FUNCTION(unobserve, 1);
+  DEFINE_PROTOTYPE_FUNCTION(disconnect, 0);
+  DEFINE_PROTOTYPE_FUNCTION(takeRecords, 0);
+};
+
+// Dart computes intersections of observed elements for the viewport and reports them with intersectionchange
+// events. Events of elements observed by IntersectionObservers are consumed natively: entries crossing a threshold
+// are collected for the current frame and delivered to each observer as one array in one callback.
+class IntersectionObserverInstance : public Instance {
+ public:
+  IntersectionObserverInstance() = delete;
+  explicit IntersectionObserverInstance(IntersectionObserver* intersectionObserver, JSValue callback, std::vector<double>&& thresholds, std::string&& rootMargin);
+  ~IntersectionObserverInstance() override;
+
+  // Queue entries for an intersectionchange event of target, to the observers whose threshold is crossed.
+  // https://w3c.github.io/IntersectionObserver/#update-intersection-observations-algo
+  static void queueEntries(ElementInstance* target, NativeEvent* nativeEvent);
+
+  // Registrations of elements flagged IsIntersectionObserved, elements which are never observed have no entry.
+  static std::vector<IntersectionObserverRegistration>* registrationsOf(const ElementInstance* element);
+  // Drop all registrations of element, called when the element is being destroyed or recycled.
+  static void clearRegistrations(ElementInstance* element);
+  static void traceRegistrations(const ElementInstance* element, JSRuntime* rt, JS_MarkFunc* mark_func);
+
+ private:
+  void observe(ElementInstance* element);
+  void unobserve(ElementInstance* element);
+  void disconnect();
+  JSValue takeRecords();
+  // Remove the registration of element from the side table, the caller releases the reference it kept.
+  void unregister(ElementInstance* element);
+  void enqueueEntry(JSValue entry);
+  // Send thresholds and rootMargin of all observers of element to dart in one command, or stop observing.
+  static void updateRegistration(ElementInstance* element);
+  static JSValue deliverEntries(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
+  static void finalize(JSRuntime* rt, JSValue val);
+
+  JSValue m_callback{JS_NULL};
+  // Sorted values in [0, 1].
+  std::vector<double> m_thresholds;
+  // Four lengths in px or %, serialized as "top right bottom left".
+  std::string m_rootMargin;
+  std::vector<JSValue> m_entries;
+  std::vector<ElementInstance*> m_targets;
+  friend IntersectionObserver;
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_INTERSECTION_OBSERVER_H
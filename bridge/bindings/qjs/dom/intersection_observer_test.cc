@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "bindings/qjs/dom/events/.gen/intersection_change.h"
+#include "element.h"
+#include "gtest/gtest.h"
+#include "kraken_test_env.h"
+#include "page.h"
+
+using namespace kraken::binding::qjs;
+
+static void dispatchIntersectionChange(ExecutionContext* context, const char* name, double intersectionRatio) {
+  JSValue value = JS_GetPropertyStr(context->ctx(), context->global(), name);
+  auto* element = static_cast<ElementInstance*>(JS_GetOpaque(value, Element::classId()));
+  NativeString* eventType = stringToNativeString("intersectionchange").release();
+
+  auto* nativeEvent = new NativeIntersectionChangeEvent();
+#if ANDROID_32_BIT
+  nativeEvent->nativeEvent.type = reinterpret_cast<int64_t>(eventType);
+#else
+  nativeEvent->nativeEvent.type = eventType;
+#endif
+  nativeEvent->intersectionRatio = intersectionRatio;
+  RawEvent rawEvent{reinterpret_cast<uint64_t*>(nativeEvent)};
+  NativeEventTarget::dispatchEventImpl(context->getContextId(), &element->nativeEventTarget, eventType, &rawEvent, false);
+  JS_FreeValue(context->ctx(), value);
+}
+
+TEST(IntersectionObserver, batchEntriesOfFrame) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "1 2 true 0.6 true false 0 true 0 true");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var a = document.createElement('div');
+var b = document.createElement('div');
+var c = document.createElement('div');
+var calls = [];
+var observer = new IntersectionObserver((entries, o) => {
+  calls.push([entries.length, entries[0].target === a, entries[0].intersectionRatio, entries[0].isIntersecting,
+    entries[1].isIntersecting, entries[1].intersectionRatio, o === observer]);
+}, { threshold: [0.5, 0] });
+observer.observe(a);
+observer.observe(b);
+observer.observe(c);
+observer.unobserve(c);
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  dispatchIntersectionChange(context, "a", 0.6);
+  dispatchIntersectionChange(context, "b", 0);
+  // No threshold crossed.
+  dispatchIntersectionChange(context, "a", 0.7);
+  dispatchIntersectionChange(context, "c", 0.7);
+  TEST_runLoop(context);
+
+  // Disconnected observers receive nothing.
+  std::string disconnect = "observer.disconnect();";
+  bridge->evaluateScript(disconnect.c_str(), disconnect.size(), "vm://", 0);
+  dispatchIntersectionChange(context, "a", 0.2);
+  TEST_runLoop(context);
+
+  std::string check = "console.log(calls.length, calls[0].join(' '), observer.takeRecords().length, calls[0][6]);";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(IntersectionObserver, options) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "0px 0px 0px 0px 0 10px 5% 10px 5% 0,0.25,1 null RangeError SyntaxError");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code = R"(
+let defaults = new IntersectionObserver(() => {});
+let observer = new IntersectionObserver(() => {}, { rootMargin: '10px 5%', threshold: [1, 0, 0.25] });
+let errorName = (options) => {
+  try {
+    new IntersectionObserver(() => {}, options);
+  } catch (e) {
+    return e.name;
+  }
+};
+console.log(defaults.rootMargin, defaults.thresholds.join(','), observer.rootMargin, observer.thresholds.join(','), observer.root,
+  errorName({ threshold: 2 }), errorName({ rootMargin: '10em' }));
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(IntersectionObserver, observedElementsKeepObserverAlive) {
+  bool static errorCalled = false;
+  static std::vector<std::string> logs;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var first = document.createElement('div');
+var second = document.createElement('div');
+(function() {
+  let observer = new IntersectionObserver((entries) => console.log(entries.length, entries[0].target === second));
+  observer.observe(first);
+  observer.observe(second);
+})();
+// Dropping one of the observed elements leaves the observer registered on the other one.
+first = null;
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  JS_RunGC(ExecutionContext::runtime());
+
+  dispatchIntersectionChange(context, "second", 0.5);
+  TEST_runLoop(context);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logs.size(), 1);
+  EXPECT_STREQ(logs[0].c_str(), "1 true");
+}
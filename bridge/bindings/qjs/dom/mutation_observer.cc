@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "mutation_observer.h"
+#include <algorithm>
+#include "bindings/qjs/qjs_patch.h"
+#include "document.h"
+#include "node.h"
+
+namespace kraken::binding::qjs {
+
+std::once_flag kMutationObserverInitFlag;
+
+void bindMutationObserver(ExecutionContext* context) {
+  auto* constructor = MutationObserver::instance(context);
+  context->defineGlobalProperty("MutationObserver", constructor->jsObject);
+}
+
+JSClassID MutationObserver::kMutationObserverClassId{0};
+
+MutationObserver::MutationObserver(ExecutionContext* context) : HostClass(context, "MutationObserver") {
+  std::call_once(kMutationObserverInitFlag, []() { JS_NewClassID(&kMutationObserverClassId); });
+}
+
+JSValue MutationObserver::instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue this_val, int argc, JSValue* argv) {
+  if (argc < 1 || !JS_IsFunction(ctx, argv[0])) {
+    return JS_ThrowTypeError(ctx, "Failed to construct 'MutationObserver': parameter 1 is not of type 'Function'.");
+  }
+
+  auto* observer = new MutationObserverInstance(this, argv[0]);
+  return observer->jsObject;
+}
+
+static bool readOption(JSContext* ctx, JSValue options, const char* name, bool* present) {
+  JSAtom key = JS_NewAtom(ctx, name);
+  JSValue value = JS_GetProperty(ctx, options, key);
+  JS_FreeAtom(ctx, key);
+  *present = !JS_IsUndefined(value);
+  bool result = JS_ToBool(ctx, value);
+  JS_FreeValue(ctx, value);
+  return result;
+}
+
+JSValue MutationObserver::observe(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = static_cast<MutationObserverInstance*>(JS_GetOpaque(this_val, MutationObserver::kMutationObserverClassId));
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'MutationObserver': this is not a MutationObserver object.");
+  }
+
+  JSValue nodeValue = argc > 0 ? argv[0] : JS_UNDEFINED;
+  auto* node = static_cast<NodeInstance*>(JS_GetOpaque(nodeValue, Node::classId(nodeValue)));
+  if (node == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'MutationObserver': parameter 1 is not of type 'Node'.");
+  }
+
+  JSValue optionsValue = argc > 1 ? argv[1] : JS_UNDEFINED;
+  if (!JS_IsObject(optionsValue)) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'MutationObserver': The options object must set at least one of 'attributes', 'characterData', or 'childList' to true.");
+  }
+
+  // https://dom.spec.whatwg.org/#dom-mutationobserver-observe
+  MutationObserverOptions options;
+  bool hasAttributes, hasCharacterData, hasAttributeOldValue, hasCharacterDataOldValue, present;
+  options.childList = readOption(ctx, optionsValue, "childList", &present);
+  options.attributes = readOption(ctx, optionsValue, "attributes", &hasAttributes);
+  options.characterData = readOption(ctx, optionsValue, "characterData", &hasCharacterData);
+  options.subtree = readOption(ctx, optionsValue, "subtree", &present);
+  options.attributeOldValue = readOption(ctx, optionsValue, "attributeOldValue", &hasAttributeOldValue);
+  options.characterDataOldValue = readOption(ctx, optionsValue, "characterDataOldValue", &hasCharacterDataOldValue);
+
+  JSValue attributeFilter = JS_GetPropertyStr(ctx, optionsValue, "attributeFilter");
+  bool hasAttributeFilter = JS_IsArray(ctx, attributeFilter);
+  if (hasAttributeFilter) {
+    int32_t length = arrayGetLength(ctx, attributeFilter);
+    for (int32_t i = 0; i < length; i++) {
+      JSValue name = JS_GetPropertyUint32(ctx, attributeFilter, i);
+      options.attributeFilter.emplace_back(jsValueToStdString(ctx, name));
+      JS_FreeValue(ctx, name);
+    }
+  }
+  JS_FreeValue(ctx, attributeFilter);
+
+  if ((hasAttributeOldValue || hasAttributeFilter) && !hasAttributes) {
+    options.attributes = true;
+  }
+  if (hasCharacterDataOldValue && !hasCharacterData) {
+    options.characterData = true;
+  }
+
+  if (!options.childList && !options.attributes && !options.characterData) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'MutationObserver': The options object must set at least one of 'attributes', 'characterData', or 'childList' to true.");
+  }
+  if (options.attributeOldValue && !options.attributes) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'MutationObserver': The options object may only set 'attributeOldValue' to true when 'attributes' is true or not present.");
+  }
+  if (hasAttributeFilter && !options.attributes) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'MutationObserver': The options object may only set 'attributeFilter' when 'attributes' is true or not present.");
+  }
+  if (options.characterDataOldValue && !options.characterData) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'MutationObserver': The options object may only set 'characterDataOldValue' to true when 'characterData' is true or not present.");
+  }
+
+  observer->observe(node, std::move(options));
+  return JS_UNDEFINED;
+}
+
+JSValue MutationObserver::disconnect(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = static_cast<MutationObserverInstance*>(JS_GetOpaque(this_val, MutationObserver::kMutationObserverClassId));
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'disconnect' on 'MutationObserver': this is not a MutationObserver object.");
+  }
+  observer->disconnect();
+  return JS_UNDEFINED;
+}
+
+JSValue MutationObserver::takeRecords(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = static_cast<MutationObserverInstance*>(JS_GetOpaque(this_val, MutationObserver::kMutationObserverClassId));
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'takeRecords' on 'MutationObserver': this is not a MutationObserver object.");
+  }
+  return observer->takeRecords();
+}
+
+MutationObserverInstance::MutationObserverInstance(MutationObserver* mutationObserver, JSValue callback)
+    : Instance(mutationObserver, "MutationObserver", nullptr, MutationObserver::kMutationObserverClassId, finalize), m_callback(JS_DupValue(m_ctx, callback)) {}
+
+MutationObserverInstance::~MutationObserverInstance() {
+  JSRuntime* rt = ExecutionContext::runtime();
+  // Registrations keep this observer alive, so it is only collected with registrations left when the GC frees it
+  // together with the nodes observed. Unlink it from them, their references go with the cycle.
+  for (NodeInstance* node : m_observedNodes) {
+    unregister(node);
+  }
+  for (JSValue record : m_records) {
+    JS_FreeValueRT(rt, record);
+  }
+  JS_FreeValueRT(rt, m_callback);
+}
+
+void MutationObserverInstance::observe(NodeInstance* node, MutationObserverOptions&& options) {
+  auto& registrations = m_context->m_mutationObserverRegistrations[node];
+  node->setNodeFlag(NodeInstance::NodeFlag::IsObserved);
+
+  // Observing a node again replaces the options.
+  for (auto& registration : registrations) {
+    if (registration.observer == this) {
+      registration.options = std::move(options);
+      return;
+    }
+  }
+
+  // The registration keeps the observer alive until it is dropped.
+  registrations.push_back({this, std::move(options)});
+  JS_DupValue(m_ctx, jsObject);
+  m_observedNodes.push_back(node);
+}
+
+void MutationObserverInstance::unregister(NodeInstance* node) {
+  auto& observedNodeRegistrations = m_context->m_mutationObserverRegistrations;
+  auto it = observedNodeRegistrations.find(node);
+  auto& registrations = it->second;
+  registrations.erase(std::remove_if(registrations.begin(), registrations.end(), [this](const MutationObserverRegistration& registration) { return registration.observer == this; }),
+                      registrations.end());
+  if (registrations.empty()) {
+    observedNodeRegistrations.erase(it);
+    node->removeNodeFlag(NodeInstance::NodeFlag::IsObserved);
+  }
+}
+
+void MutationObserverInstance::disconnect() {
+  std::vector<NodeInstance*> nodes;
+  nodes.swap(m_observedNodes);
+  for (NodeInstance* node : nodes) {
+    unregister(node);
+    JS_FreeValue(m_ctx, jsObject);
+  }
+
+  for (JSValue record : m_records) {
+    JS_FreeValue(m_ctx, record);
+  }
+  m_records.clear();
+}
+
+JSValue MutationObserverInstance::takeRecords() {
+  JSValue records = JS_NewArray(m_ctx);
+  for (uint32_t i = 0; i < m_records.size(); i++) {
+    JS_SetPropertyUint32(m_ctx, records, i, m_records[i]);
+  }
+  m_records.clear();
+  return records;
+}
+
+std::vector<MutationObserverRegistration>* MutationObserverInstance::registrationsOf(const NodeInstance* node) {
+  auto& observedNodeRegistrations = node->context()->m_mutationObserverRegistrations;
+  auto it = observedNodeRegistrations.find(node);
+  return it != observedNodeRegistrations.end() ? &it->second : nullptr;
+}
+
+void MutationObserverInstance::clearRegistrations(NodeInstance* node) {
+  auto& observedNodeRegistrations = node->context()->m_mutationObserverRegistrations;
+  auto it = observedNodeRegistrations.find(node);
+  if (it == observedNodeRegistrations.end())
+    return;
+
+  std::vector<MutationObserverRegistration> registrations = std::move(it->second);
+  observedNodeRegistrations.erase(it);
+  node->removeNodeFlag(NodeInstance::NodeFlag::IsObserved);
+  for (auto& registration : registrations) {
+    MutationObserverInstance* observer = registration.observer;
+    observer->m_observedNodes.erase(std::remove(observer->m_observedNodes.begin(), observer->m_observedNodes.end(), node), observer->m_observedNodes.end());
+    // The node does not touch the observer after this, releasing the last reference may finalize it.
+    JS_FreeValueRT(ExecutionContext::runtime(), observer->jsObject);
+  }
+}
+
+void MutationObserverInstance::traceRegistrations(const NodeInstance* node, JSRuntime* rt, JS_MarkFunc* mark_func) {
+  auto* registrations = registrationsOf(node);
+  if (registrations == nullptr)
+    return;
+  for (auto& registration : *registrations) {
+    JS_MarkValue(rt, registration.observer->jsObject, mark_func);
+  }
+}
+
+void MutationObserverInstance::enqueueRecord(JSValue record) {
+  m_records.push_back(record);
+  if (m_records.size() > 1)
+    return;
+
+  // The first record since last delivery, schedule a microtask unless there is one already.
+  DocumentInstance* document = m_context->document();
+  if (document->m_pendingMutationObservers.empty()) {
+    JS_EnqueueJob(m_ctx, notifyMutationObservers, 0, nullptr);
+  }
+  document->m_pendingMutationObservers.push_back(JS_DupValue(m_ctx, jsObject));
+}
+
+JSValue MutationObserverInstance::notifyMutationObservers(JSContext* ctx, int argc, JSValueConst* argv) {
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
+  if (!context->isValid())
+    return JS_UNDEFINED;
+
+  // Records queued by callbacks are delivered in the next microtask.
+  std::vector<JSValue> observers;
+  observers.swap(context->document()->m_pendingMutationObservers);
+  for (JSValue observerValue : observers) {
+    auto* observer = static_cast<MutationObserverInstance*>(JS_GetOpaque(observerValue, MutationObserver::kMutationObserverClassId));
+    // Records may have been taken by takeRecords() or disconnect().
+    if (!observer->m_records.empty()) {
+      JSValue records = observer->takeRecords();
+      JSValue arguments[] = {records, observerValue};
+      JSValue returnValue = JS_Call(ctx, observer->m_callback, observerValue, 2, arguments);
+      context->handleException(&returnValue);
+      JS_FreeValue(ctx, returnValue);
+      JS_FreeValue(ctx, records);
+    }
+    JS_FreeValue(ctx, observerValue);
+  }
+  return JS_UNDEFINED;
+}
+
+static JSValue nodesToArray(JSContext* ctx, const std::vector<NodeInstance*>& nodes) {
+  JSValue array = JS_NewArray(ctx);
+  for (uint32_t i = 0; i < nodes.size(); i++) {
+    JS_SetPropertyUint32(ctx, array, i, JS_DupValue(ctx, nodes[i]->jsObject));
+  }
+  return array;
+}
+
+static JSValue nodeOrNull(JSContext* ctx, NodeInstance* node) {
+  return node != nullptr ? JS_DupValue(ctx, node->jsObject) : JS_NULL;
+}
+
+// https://dom.spec.whatwg.org/#interface-mutationrecord
+static JSValue createRecord(JSContext* ctx, MutationType type, NodeInstance* target, const ChildListMutation* mutation, const std::string* attributeName, JSValue oldValue) {
+  static const char* typeNames[] = {"childList", "attributes", "characterData"};
+  static const std::vector<NodeInstance*> noNodes;
+
+  JSValue record = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, record, "type", JS_NewString(ctx, typeNames[static_cast<int>(type)]));
+  JS_SetPropertyStr(ctx, record, "target", JS_DupValue(ctx, target->jsObject));
+  JS_SetPropertyStr(ctx, record, "addedNodes", nodesToArray(ctx, mutation != nullptr ? mutation->addedNodes : noNodes));
+  JS_SetPropertyStr(ctx, record, "removedNodes", nodesToArray(ctx, mutation != nullptr ? mutation->removedNodes : noNodes));
+  JS_SetPropertyStr(ctx, record, "previousSibling", nodeOrNull(ctx, mutation != nullptr ? mutation->previousSibling : nullptr));
+  JS_SetPropertyStr(ctx, record, "nextSibling", nodeOrNull(ctx, mutation != nullptr ? mutation->nextSibling : nullptr));
+  JS_SetPropertyStr(ctx, record, "attributeName", attributeName != nullptr ? JS_NewString(ctx, attributeName->c_str()) : JS_NULL);
+  JS_SetPropertyStr(ctx, record, "attributeNamespace", JS_NULL);
+  JS_SetPropertyStr(ctx, record, "oldValue", JS_DupValue(ctx, oldValue));
+  return record;
+}
+
+void MutationObserverInstance::queueRecord(MutationType type, NodeInstance* target, const ChildListMutation* mutation, const std::string* attributeName, const std::function<JSValue()>* getOldValue) {
+  // Observers interested in the mutation, with whether they want the old value.
+  std::vector<std::pair<MutationObserverInstance*, bool>> interestedObservers;
+
+  NodeInstance* node = target;
+  while (node != nullptr) {
+    auto* registrations = node->hasNodeFlag(NodeInstance::NodeFlag::IsObserved) ? registrationsOf(node) : nullptr;
+    if (registrations != nullptr) {
+      for (auto& registration : *registrations) {
+        const MutationObserverOptions& options = registration.options;
+        if (node != target && !options.subtree)
+          continue;
+        if (type == MutationType::childList && !options.childList)
+          continue;
+        if (type == MutationType::characterData && !options.characterData)
+          continue;
+        if (type == MutationType::attributes &&
+            (!options.attributes || (!options.attributeFilter.empty() && std::find(options.attributeFilter.begin(), options.attributeFilter.end(), *attributeName) == options.attributeFilter.end())))
+          continue;
+
+        bool withOldValue = (type == MutationType::attributes && options.attributeOldValue) || (type == MutationType::characterData && options.characterDataOldValue);
+        auto it = std::find_if(interestedObservers.begin(), interestedObservers.end(), [&registration](auto& interested) { return interested.first == registration.observer; });
+        if (it == interestedObservers.end()) {
+          interestedObservers.emplace_back(registration.observer, withOldValue);
+        } else {
+          it->second |= withOldValue;
+        }
+      }
+    }
+    node = static_cast<NodeInstance*>(JS_GetOpaque(node->parentNode, Node::classId(node->parentNode)));
+  }
+
+  JSContext* ctx = target->context()->ctx();
+  JSValue oldValue = JS_NULL;
+  bool hasOldValue = false;
+  for (auto& interested : interestedObservers) {
+    if (interested.second && getOldValue != nullptr && !hasOldValue) {
+      oldValue = (*getOldValue)();
+      hasOldValue = true;
+    }
+    interested.first->enqueueRecord(createRecord(ctx, type, target, mutation, attributeName, interested.second ? oldValue : JS_NULL));
+  }
+  JS_FreeValue(ctx, oldValue);
+}
+
+void MutationObserverInstance::queueChildListRecord(NodeInstance* target, const ChildListMutation& mutation) {
+  queueRecord(MutationType::childList, target, &mutation, nullptr, nullptr);
+}
+
+void MutationObserverInstance::queueAttributeRecord(NodeInstance* target, const std::string& name, JSValue oldValue) {
+  JSContext* ctx = target->context()->ctx();
+  std::function<JSValue()> getOldValue = [ctx, oldValue]() { return JS_DupValue(ctx, oldValue); };
+  queueRecord(MutationType::attributes, target, nullptr, &name, &getOldValue);
+}
+
+void MutationObserverInstance::queueAttributeRecord(NodeInstance* target, const std::string& name, const std::function<JSValue()>& getOldValue) {
+  queueRecord(MutationType::attributes, target, nullptr, &name, &getOldValue);
+}
+
+void MutationObserverInstance::queueCharacterDataRecord(NodeInstance* target, JSValue oldValue) {
+  JSContext* ctx = target->context()->ctx();
+  std::function<JSValue()> getOldValue = [ctx, oldValue]() { return JS_DupValue(ctx, oldValue); };
+  queueRecord(MutationType::characterData, target, nullptr, nullptr, &getOldValue);
+}
+
+void MutationObserverInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  JS_MarkValue(rt, m_callback, mark_func);
+  for (JSValue record : m_records) {
+    JS_MarkValue(rt, record, mark_func);
+  }
+}
+
+void MutationObserverInstance::finalize(JSRuntime* rt, JSValue val) {
+  auto* observer = static_cast<MutationObserverInstance*>(JS_GetOpaque(val, MutationObserver::kMutationObserverClassId));
+  delete observer;
+}
+
+}  // namespace kraken::binding::qjs
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_MUTATION_OBSERVER_H
+#define KRAKENBRIDGE_MUTATION_OBSERVER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "bindings/qjs/host_class.h"
+
+namespace kraken::binding::qjs {
+
+void bindMutationObserver(ExecutionContext* context);
+
+class NodeInstance;
+class MutationObserverInstance;
+
+// https://dom.spec.whatwg.org/#dictdef-mutationobserverinit
+struct MutationObserverOptions {
+  bool childList{false};
+  bool attributes{false};
+  bool characterData{false};
+  bool subtree{false};
+  bool attributeOldValue{false};
+  bool characterDataOldValue{false};
+  // Empty for all attributes.
+  std::vector<std::string> attributeFilter;
+};
+
+// A node observed by an observer, kept in the side table of observed nodes. Each registration keeps a reference to
+// its observer, released when it is dropped.
+// https://dom.spec.whatwg.org/#registered-observer
+struct MutationObserverRegistration {
+  MutationObserverInstance* observer;
+  MutationObserverOptions options;
+};
+
+// Nodes and parent nodes changed by a childList mutation. Siblings are the children around the changed ones.
+struct ChildListMutation {
+  std::vector<NodeInstance*> addedNodes;
+  std::vector<NodeInstance*> removedNodes;
+  NodeInstance* previousSibling{nullptr};
+  NodeInstance* nextSibling{nullptr};
+};
+
+enum class MutationType { childList, attributes, characterData };
+
+class MutationObserver : public HostClass {
+ public:
+  static JSClassID kMutationObserverClassId;
+  MutationObserver() = delete;
+  explicit MutationObserver(ExecutionContext* context);
+
+  JSValue instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue this_val, int argc, JSValue* argv) override;
+
+  OBJECT_INSTANCE(MutationObserver);
+
+  static JSValue observe(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue disconnect(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue takeRecords(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+
+ private:
+  DEFINE_PROTOTYPE_FUNCTION(observe, 2);
+  DEFINE_PROTOTYPE_FUNCTION(disconnect, 0);
+  DEFINE_PROTOTYPE_FUNCTION(takeRecords, 0);
+};
+
+class MutationObserverInstance : public Instance {
+ public:
+  MutationObserverInstance() = delete;
+  explicit MutationObserverInstance(MutationObserver* mutationObserver, JSValue callback);
+  ~MutationObserverInstance() override;
+
+  // Queue records to the observers registered on target and its ancestors. Only called when the document of
+  // target has observers, mutations of documents without observers cost nothing more than that check.
+  // https://dom.spec.whatwg.org/#queueing-a-mutation-record
+  static void queueChildListRecord(NodeInstance* target, const ChildListMutation& mutation);
+  static void queueAttributeRecord(NodeInstance* target, const std::string& name, JSValue oldValue);
+  // The old value is only built when an observer asks for it, getOldValue returns a new reference.
+  static void queueAttributeRecord(NodeInstance* target, const std::string& name, const std::function<JSValue()>& getOldValue);
+  static void queueCharacterDataRecord(NodeInstance* target, JSValue oldValue);
+
+  // Invoke callbacks of observers with pending records, once for each microtask checkpoint.
+  // https://dom.spec.whatwg.org/#notify-mutation-observers
+  static JSValue notifyMutationObservers(JSContext* ctx, int argc, JSValueConst* argv);
+
+  // Registrations of nodes flagged IsObserved, nodes which are never observed have no entry.
+  static std::vector<MutationObserverRegistration>* registrationsOf(const NodeInstance* node);
+  // Drop all registrations of node, called when the node is being destroyed or recycled.
+  static void clearRegistrations(NodeInstance* node);
+  static void traceRegistrations(const NodeInstance* node, JSRuntime* rt, JS_MarkFunc* mark_func);
+
+ private:
+  void observe(NodeInstance* node, MutationObserverOptions&& options);
+  void disconnect();
+  JSValue takeRecords();
+  // Remove the registration of node from the side table, the caller releases the reference it kept.
+  void unregister(NodeInstance* node);
+  void enqueueRecord(JSValue record);
+  static void queueRecord(MutationType type, NodeInstance* target, const ChildListMutation* mutation, const std::string* attributeName, const std::function<JSValue()>* getOldValue);
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
+  static void finalize(JSRuntime* rt, JSValue val);
+
+  JSValue m_callback{JS_NULL};
+  std::vector<JSValue> m_records;
+  std::vector<NodeInstance*> m_observedNodes;
+  friend MutationObserver;
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_MUTATION_OBSERVER_H
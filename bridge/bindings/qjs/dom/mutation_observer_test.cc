@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "gtest/gtest.h"
+#include "kraken_test_env.h"
+#include "page.h"
+
+TEST(MutationObserver, childList) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "1 3 childList 2 0 true null true 1 true true");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "let first = document.createElement('span');"
+      "let second = document.createElement('span');"
+      "let calls = 0;"
+      "new MutationObserver((records, observer) => {"
+      "  calls++;"
+      "  let added = records[0];"
+      "  let removed = records[2];"
+      "  console.log(calls, records.length, added.type, added.addedNodes.length + records[1].addedNodes.length, added.removedNodes.length,"
+      "    records[1].previousSibling === first, added.previousSibling, removed.target === div, removed.removedNodes.length,"
+      "    removed.removedNodes[0] === first, removed.nextSibling === second);"
+      "}).observe(div, { childList: true });"
+      "div.appendChild(first);"
+      "div.appendChild(second);"
+      "div.removeChild(first);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(MutationObserver, attributesWithOldValue) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "3 attributes id null id a class null");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "new MutationObserver((records) => {"
+      "  console.log(records.length, records[0].type, records[0].attributeName, records[0].oldValue, records[1].attributeName,"
+      "    records[1].oldValue, records[2].attributeName, records[2].oldValue);"
+      "}).observe(div, { attributeOldValue: true, attributeFilter: ['id', 'class'] });"
+      "div.setAttribute('id', 'a');"
+      "div.setAttribute('title', 'ignored');"
+      "div.removeAttribute('id');"
+      "div.className = 'b';";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(MutationObserver, characterData) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "2 characterData true 1234 abc");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let text = document.createTextNode('1234');"
+      "new MutationObserver((records) => {"
+      "  console.log(records.length, records[0].type, records[0].target === text, records[0].oldValue, records[1].oldValue);"
+      "}).observe(text, { characterDataOldValue: true });"
+      "text.data = 'abc';"
+      "text.data = 'def';";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(MutationObserver, subtree) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "subtree: 3 true attributes characterData 0");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let root = document.createElement('div');"
+      "let child = document.createElement('div');"
+      "root.appendChild(child);"
+      "let shallowRecords = 0;"
+      "new MutationObserver((records) => { shallowRecords += records.length; }).observe(root, { childList: true, attributes: true });"
+      "new MutationObserver((records, observer) => {"
+      "  console.log('subtree:', records.length, records[0].target === child, records[1].type, records[2].type, shallowRecords);"
+      "  observer.disconnect();"
+      "}).observe(root, { childList: true, attributes: true, characterData: true, subtree: true });"
+      "child.appendChild(document.createTextNode('x'));"
+      "child.style.color = 'red';"
+      "child.firstChild.data = 'y';";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(MutationObserver, takeRecordsAndDisconnect) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "1 0");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "let observer = new MutationObserver(() => { console.log('should not be called'); });"
+      "observer.observe(div, { childList: true });"
+      "div.appendChild(document.createElement('span'));"
+      "let taken = observer.takeRecords();"
+      "div.appendChild(document.createElement('span'));"
+      "observer.disconnect();"
+      "div.appendChild(document.createElement('span'));"
+      "console.log(taken.length, observer.takeRecords().length);";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(MutationObserver, styleOldValueAndParsedAttributes) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "2 style color: red; width: 10px; title null");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  const char* code =
+      "let div = document.createElement('div');"
+      "div.style.width = '10px';"
+      "div.style.color = 'red';"
+      "let container = document.createElement('div');"
+      "new MutationObserver((records) => {"
+      "  console.log(records.length, records[0].attributeName, records[0].oldValue, records[1].attributeName, records[1].oldValue);"
+      "}).observe(div, { attributeOldValue: true });"
+      "new MutationObserver(() => {}).observe(div, { attributes: true });"
+      "let otherObserver = new MutationObserver((records) => {"
+      "  records.forEach((record) => { if (record.type != 'childList') console.log('unexpected', record.type); });"
+      "});"
+      "otherObserver.observe(container, { childList: true, attributes: true, subtree: true });"
+      "div.style.height = '20px';"
+      "div.setAttribute('title', 'a');"
+      "container.innerHTML = '<p class=\"a\" style=\"color: red\"></p>';";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(MutationObserver, observedNodesKeepObserverAlive) {
+  bool static errorCalled = false;
+  static std::vector<std::string> logs;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code =
+      "var first = document.createElement('div');"
+      "var second = document.createElement('div');"
+      "(function() {"
+      "  let observer = new MutationObserver((records) => { console.log(records.length); });"
+      "  observer.observe(first, { childList: true });"
+      "  observer.observe(second, { childList: true });"
+      "})();"
+      // Dropping one of the observed nodes leaves the observer registered on the other one.
+      "first = null;";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  JS_RunGC(ExecutionContext::runtime());
+
+  std::string check = "second.appendChild(document.createElement('p'));";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logs.size(), 1);
+  EXPECT_STREQ(logs[0].c_str(), "1");
+}
@@ -9,7 +9,9 @@
 #include "document.h"
 #include "document_fragment.h"
 #include "element.h"
+#include "elements/template_element.h"
 #include "kraken_bridge.h"
+#include "mutation_observer.h"
 #include "text_node.h"
 
 namespace kraken::binding::qjs {
@@ -52,29 +54,13 @@ JSValue Node::cloneNode(JSContext* ctx, JSValue this_val, int argc, JSValue* arg
   }
   bool deep = JS_ToBool(ctx, deepValue);
 
-  if (selfInstance->nodeType == NodeType::ELEMENT_NODE) {
-    JSValue newElement = copyNodeValue(ctx, selfInstance);
-    auto newElementInstance = static_cast<NodeInstance*>(JS_GetOpaque(newElement, Node::classId(newElement)));
+  // Records are collected for every clone, scripts may change childNodes without going through the DOM methods, so
+  // records kept from a previous clone could only be trusted after a walk as long as collecting them again.
+  std::vector<NodeCloneRecord> records;
+  collectCloneRecords(selfInstance, -1, false, deep, records);
+  NodeInstance* newNode = cloneNodeTree(selfInstance->m_context, records);
 
-    if (deep) {
-      traverseCloneNode(ctx, selfInstance, newElementInstance);
-    }
-    return newElementInstance->jsObject;
-  } else if (selfInstance->nodeType == NodeType::TEXT_NODE) {
-    auto textNode = static_cast<TextNodeInstance*>(selfInstance);
-    JSValue newTextNode = copyNodeValue(ctx, static_cast<NodeInstance*>(textNode));
-    return newTextNode;
-  } else if (selfInstance->nodeType == NodeType::DOCUMENT_FRAGMENT_NODE) {
-    JSValue newFragment = JS_CallConstructor(ctx, DocumentFragment::instance(selfInstance->m_context)->jsObject, 0, nullptr);
-    auto* newFragmentInstance = static_cast<NodeInstance*>(JS_GetOpaque(newFragment, Node::classId(newFragment)));
-
-    if (deep) {
-      traverseCloneNode(ctx, selfInstance, newFragmentInstance);
-    }
-
-    return newFragment;
-  }
-  return JS_NULL;
+  return newNode != nullptr ? newNode->jsObject : JS_NULL;
 }
 
 JSValue Node::appendChild(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
@@ -102,15 +88,7 @@ JSValue Node::appendChild(JSContext* ctx, JSValue this_val, int argc, JSValue* a
   }
 
   if (nodeInstance->hasNodeFlag(NodeInstance::NodeFlag::IsDocumentFragment)) {
-    size_t len = arrayGetLength(ctx, nodeInstance->childNodes);
-    for (int i = 0; i < len; i++) {
-      JSValue n = JS_GetPropertyUint32(ctx, nodeInstance->childNodes, i);
-      auto* node = static_cast<NodeInstance*>(JS_GetOpaque(n, Node::classId(n)));
-      selfInstance->internalAppendChild(node);
-      JS_FreeValue(ctx, n);
-    }
-
-    JS_SetPropertyStr(ctx, nodeInstance->childNodes, "length", JS_NewUint32(ctx, 0));
+    selfInstance->internalInsertFragmentChildren(nodeInstance, nullptr);
   } else {
     selfInstance->ensureDetached(nodeInstance);
     selfInstance->internalAppendChild(nodeInstance);
@@ -173,19 +151,26 @@ JSValue Node::insertBefore(JSContext* ctx, JSValue this_val, int argc, JSValue*
   }
 
   if (nodeInstance->hasNodeFlag(NodeInstance::NodeFlag::IsDocumentFragment)) {
-    size_t len = arrayGetLength(ctx, nodeInstance->childNodes);
-    for (int i = 0; i < len; i++) {
-      JSValue n = JS_GetPropertyUint32(ctx, nodeInstance->childNodes, i);
-      auto* node = static_cast<NodeInstance*>(JS_GetOpaque(n, Node::classId(n)));
-      selfInstance->internalInsertBefore(node, referenceInstance);
-      JS_FreeValue(ctx, n);
+    JSValue result = selfInstance->internalInsertFragmentChildren(nodeInstance, referenceInstance);
+    if (JS_IsException(result)) {
+      return result;
     }
-
-    // Clear fragment childNodes reference.
-    JS_SetPropertyStr(ctx, nodeInstance->childNodes, "length", JS_NewUint32(ctx, 0));
   } else {
+    // Validated before the node is detached, a failed insertion would leave it without a parent but still connected.
+    if (referenceInstance != nullptr && JS_VALUE_GET_PTR(referenceInstance->parentNode) != JS_VALUE_GET_PTR(selfInstance->jsObject)) {
+      return JS_ThrowTypeError(ctx, "Failed to execute 'insertBefore' on 'Node': reference node is not a child of this node.");
+    }
+    // Inserting a node before itself inserts it before its next sibling.
+    if (referenceInstance == nodeInstance) {
+      referenceInstance = selfInstance->childAt(arrayFindIdx(ctx, selfInstance->childNodes, nodeInstance->jsObject) + 1);
+    }
+
     selfInstance->ensureDetached(nodeInstance);
-    selfInstance->internalInsertBefore(nodeInstance, referenceInstance);
+    JSValue result = selfInstance->internalInsertBefore(nodeInstance, referenceInstance);
+    if (JS_IsException(result)) {
+      nodeInstance->_notifyNodeRemoved(selfInstance);
+      return result;
+    }
   }
 
   return JS_NULL;
@@ -220,77 +205,119 @@ JSValue Node::replaceChild(JSContext* ctx, JSValue this_val, int argc, JSValue*
   }
 
   if (newChildInstance->hasNodeFlag(NodeInstance::NodeFlag::IsDocumentFragment)) {
-    size_t len = arrayGetLength(ctx, newChildInstance->childNodes);
-    for (int i = 0; i < len; i++) {
-      JSValue n = JS_GetPropertyUint32(ctx, newChildInstance->childNodes, i);
-      auto* node = static_cast<NodeInstance*>(JS_GetOpaque(n, Node::classId(n)));
-      selfInstance->internalInsertBefore(node, oldChildInstance);
-      JS_FreeValue(ctx, n);
-    }
+    selfInstance->internalInsertFragmentChildren(newChildInstance, oldChildInstance);
     selfInstance->internalRemoveChild(oldChildInstance);
-    // Clear fragment childNodes reference.
-    JS_SetPropertyStr(ctx, newChildInstance->childNodes, "length", JS_NewUint32(ctx, 0));
-  } else {
+  } else if (newChildInstance != oldChildInstance) {
     selfInstance->ensureDetached(newChildInstance);
-    selfInstance->internalReplaceChild(newChildInstance, oldChildInstance);
+    JSValue result = selfInstance->internalReplaceChild(newChildInstance, oldChildInstance);
+    if (JS_IsException(result)) {
+      newChildInstance->_notifyNodeRemoved(selfInstance);
+      return result;
+    }
   }
   return JS_DupValue(ctx, oldChildInstance->jsObject);
 }
 
-void Node::traverseCloneNode(JSContext* ctx, NodeInstance* baseNode, NodeInstance* targetNode) {
-  int32_t len = arrayGetLength(ctx, baseNode->childNodes);
-  for (int i = 0; i < len; i++) {
-    JSValue n = JS_GetPropertyUint32(ctx, baseNode->childNodes, i);
-    auto* node = static_cast<NodeInstance*>(JS_GetOpaque(n, Node::classId(n)));
-    JSValue newNode = copyNodeValue(ctx, node);
-    auto newNodeInstance = static_cast<NodeInstance*>(JS_GetOpaque(newNode, Node::classId(newNode)));
-    targetNode->ensureDetached(newNodeInstance);
-    targetNode->internalAppendChild(newNodeInstance);
-    // element node needs recursive child nodes.
-    if (node->nodeType == NodeType::ELEMENT_NODE) {
-      traverseCloneNode(ctx, node, newNodeInstance);
-    }
-    JS_FreeValue(ctx, newNode);
-    JS_FreeValue(ctx, n);
+void Node::collectCloneRecords(NodeInstance* node, int32_t parentIndex, bool inTemplateContent, bool deep, std::vector<NodeCloneRecord>& records) {
+  auto index = static_cast<int32_t>(records.size());
+  records.push_back({node, parentIndex, inTemplateContent});
+  if (!deep)
+    return;
+
+  auto collectChild = [index, &records](bool inTemplateContent) {
+    return [index, inTemplateContent, &records](NodeInstance* child) {
+      if (child->nodeType == NodeType::ELEMENT_NODE || child->nodeType == NodeType::TEXT_NODE || child->nodeType == NodeType::COMMENT_NODE) {
+        collectCloneRecords(child, index, inTemplateContent, true, records);
+      }
+    };
+  };
+
+  node->forEachChild(collectChild(false));
+  if (node->hasNodeFlag(NodeInstance::NodeFlag::IsTemplateElement)) {
+    static_cast<TemplateElementInstance*>(node)->content()->forEachChild(collectChild(true));
   }
 }
 
-JSValue Node::copyNodeValue(JSContext* ctx, NodeInstance* node) {
-  if (node->nodeType == NodeType::ELEMENT_NODE) {
-    auto* element = reinterpret_cast<ElementInstance*>(node);
+NodeInstance* Node::cloneNodeTree(ExecutionContext* context, const std::vector<NodeCloneRecord>& records) {
+  JSContext* ctx = context->ctx();
+  Element* elementConstructor = Element::instance(context);
 
-    /* createElement */
-    std::string tagName = element->getRegisteredTagName();
-    JSValue tagNameValue = JS_NewString(element->m_ctx, tagName.c_str());
-    JSValue arguments[] = {tagNameValue};
-    JSValue newElementValue = JS_CallConstructor(element->context()->ctx(), Element::instance(element->context())->jsObject, 1, arguments);
-    JS_FreeValue(ctx, tagNameValue);
+  NodeInstance* root = copyNode(records[0].node, elementConstructor);
+  if (root == nullptr)
+    return nullptr;
 
-    auto* newElement = static_cast<ElementInstance*>(JS_GetOpaque(newElementValue, Node::classId(newElementValue)));
+  std::vector<NodeInstance*> clones;
+  clones.reserve(records.size());
+  clones.emplace_back(root);
 
-    /* copy attributes */
-    newElement->m_attributes->copyWith(element->m_attributes);
+  // Every new node is created with its own createXXX command, the structure and the element styles and properties
+  // which are copied from the source nodes are described by one cloneNodeTree command.
+  std::string cloneMap = std::to_string(records[0].node->m_eventTargetId) + ':' + std::to_string(root->m_eventTargetId);
 
-    /* copy style */
-    newElement->m_style->copyWith(element->m_style);
+  for (size_t i = 1; i < records.size(); i++) {
+    const NodeCloneRecord& record = records[i];
+    NodeInstance* clone = copyNode(record.node, elementConstructor);
+    NodeInstance* parent = clones[record.parentIndex];
+    if (record.inTemplateContent) {
+      parent = static_cast<TemplateElementInstance*>(parent)->content();
+    }
 
-    /* copy properties */
-    ElementInstance::copyNodeProperties(newElement, element);
+    // New nodes are never connected, so there is nothing to notify about insertion.
+    JSValue* children;
+    uint32_t count;
+    uint32_t index = JS_GetFastArray(parent->childNodes, &children, &count) ? count : arrayGetLength(ctx, parent->childNodes);
+    // childNodes takes over the reference of the new node.
+    JS_SetPropertyUint32(ctx, parent->childNodes, index, clone->jsObject);
+    clone->setParentNode(parent);
+    clones.emplace_back(clone);
 
-    std::string newNodeEventTargetId = std::to_string(newElement->m_eventTargetId);
-    std::unique_ptr<NativeString> args_01 = stringToNativeString(newNodeEventTargetId);
-    element->m_context->uiCommandBuffer()->addCommand(element->m_eventTargetId, UICommand::cloneNode, *args_01, nullptr);
+    cloneMap += ',';
+    cloneMap += std::to_string(record.node->m_eventTargetId);
+    cloneMap += ':';
+    cloneMap += std::to_string(clone->m_eventTargetId);
+    cloneMap += ':';
+    cloneMap += std::to_string(parent->m_eventTargetId);
+  }
+
+  std::unique_ptr<NativeString> args_01 = stringToNativeString(cloneMap);
+  context->uiCommandBuffer()->addCommand(records[0].node->m_eventTargetId, UICommand::cloneNodeTree, *args_01, nullptr);
+
+  return root;
+}
+
+NodeInstance* Node::copyNode(NodeInstance* node, Element* elementConstructor) {
+  if (node->nodeType == NodeType::ELEMENT_NODE) {
+    auto* element = static_cast<ElementInstance*>(node);
+    auto* constructor = static_cast<Element*>(element->prototype());
+
+    ElementInstance* newElement;
+    if (constructor == elementConstructor) {
+      newElement = new ElementInstance(constructor, element->m_tagName, true);
+    } else {
+      // Registered elements construct their own instance with a fixed tag name.
+      JSValue instance = constructor->instanceConstructor(node->m_ctx, constructor->jsObject, constructor->jsObject, 0, nullptr);
+      newElement = static_cast<ElementInstance*>(JS_GetOpaque(instance, Element::classId()));
+    }
 
-    return newElement->jsObject;
-  } else if (node->nodeType == TEXT_NODE) {
-    auto* textNode = reinterpret_cast<TextNodeInstance*>(node);
-    JSValue textContent = textNode->internalGetTextContent();
-    JSValue arguments[] = {textContent};
-    JSValue result = JS_CallConstructor(ctx, TextNode::instance(textNode->m_context)->jsObject, 1, arguments);
-    JS_FreeValue(ctx, textContent);
-    return result;
+    newElement->attributes()->copyWith(element->attributes());
+    if (element->hasNodeFlag(NodeInstance::NodeFlag::HasIdAttribute)) {
+      newElement->setNodeFlag(NodeInstance::NodeFlag::HasIdAttribute);
+      newElement->setNodeFlag(NodeInstance::NodeFlag::SubtreeHasIdAttribute);
+    }
+    if (element->style() != nullptr) {
+      newElement->ensureStyle()->copyWith(element->style());
+    }
+    ElementInstance::copyNodeProperties(newElement, element);
+    return newElement;
+  } else if (node->nodeType == NodeType::TEXT_NODE) {
+    auto* textNode = static_cast<TextNodeInstance*>(node);
+    return new TextNodeInstance(static_cast<TextNode*>(textNode->prototype()), textNode->m_data);
+  } else if (node->nodeType == NodeType::COMMENT_NODE) {
+    return new CommentInstance(static_cast<Comment*>(node->prototype()));
+  } else if (node->nodeType == NodeType::DOCUMENT_FRAGMENT_NODE) {
+    return new DocumentFragmentInstance(static_cast<DocumentFragment*>(node->prototype()));
   }
-  return JS_NULL;
+  return nullptr;
 }
 
 IMPL_PROPERTY_GETTER(Node, isConnected)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
@@ -337,6 +364,11 @@ IMPL_PROPERTY_GETTER(Node, nodeType)(JSContext* ctx, JSValue this_val, int argc,
   return JS_NewUint32(ctx, nodeInstance->nodeType);
 }
 
+IMPL_PROPERTY_GETTER(Node, childNodes)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* nodeInstance = static_cast<NodeInstance*>(JS_GetOpaque(this_val, Node::classId(this_val)));
+  return JS_DupValue(ctx, nodeInstance->childNodes);
+}
+
 IMPL_PROPERTY_GETTER(Node, textContent)(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
   auto* nodeInstance = static_cast<NodeInstance*>(JS_GetOpaque(this_val, Node::classId(this_val)));
   return nodeInstance->internalGetTextContent();
@@ -348,16 +380,7 @@ IMPL_PROPERTY_SETTER(Node, textContent)(JSContext* ctx, JSValue this_val, int ar
 }
 
 bool NodeInstance::isConnected() {
-  bool _isConnected = this == document();
-  auto parent = static_cast<NodeInstance*>(JS_GetOpaque(parentNode, Node::classId(parentNode)));
-
-  while (parent != nullptr && !_isConnected) {
-    _isConnected = parent == document();
-    JSValue parentParentNode = parent->parentNode;
-    parent = static_cast<NodeInstance*>(JS_GetOpaque(parentParentNode, Node::classId(parentParentNode)));
-  }
-
-  return _isConnected;
+  return hasNodeFlag(NodeFlag::IsConnected);
 }
 DocumentInstance* NodeInstance::ownerDocument() {
   if (nodeType == NodeType::DOCUMENT_NODE) {
@@ -414,11 +437,16 @@ NodeInstance* NodeInstance::nextSibling() {
   return nullptr;
 }
 void NodeInstance::internalAppendChild(NodeInstance* node) {
+  NodeInstance* previousSibling = UNLIKELY(m_context->hasMutationObservers()) ? childAt(arrayGetLength(m_ctx, childNodes) - 1) : nullptr;
   arrayPushValue(m_ctx, childNodes, node->jsObject);
   node->setParentNode(this);
 
   node->_notifyNodeInsert(this);
 
+  if (UNLIKELY(m_context->hasMutationObservers())) {
+    MutationObserverInstance::queueChildListRecord(this, {{node}, {}, previousSibling, nullptr});
+  }
+
   std::string nodeEventTargetId = std::to_string(node->m_eventTargetId);
   std::string position = std::string("beforeend");
 
@@ -435,6 +463,8 @@ void NodeInstance::internalRemove() {
 }
 void NodeInstance::internalClearChild() {
   int32_t len = arrayGetLength(m_ctx, childNodes);
+  bool hasMutationObservers = m_context->hasMutationObservers();
+  ChildListMutation mutation;
 
   for (int i = 0; i < len; i++) {
     JSValue v = JS_GetPropertyUint32(m_ctx, childNodes, i);
@@ -442,15 +472,26 @@ void NodeInstance::internalClearChild() {
     node->removeParentNode();
     node->_notifyNodeRemoved(this);
     node->m_context->uiCommandBuffer()->addCommand(node->m_eventTargetId, UICommand::removeNode, nullptr);
+    if (UNLIKELY(hasMutationObservers)) {
+      mutation.removedNodes.emplace_back(node);
+    }
     JS_FreeValue(m_ctx, v);
   }
 
+  // Queue before childNodes releases the removed nodes.
+  if (UNLIKELY(hasMutationObservers) && len > 0) {
+    MutationObserverInstance::queueChildListRecord(this, mutation);
+  }
+
   JS_SetPropertyStr(m_ctx, childNodes, "length", JS_NewUint32(m_ctx, 0));
 }
 NodeInstance* NodeInstance::internalRemoveChild(NodeInstance* node) {
   int32_t idx = arrayFindIdx(m_ctx, childNodes, node->jsObject);
 
   if (idx != -1) {
+    if (UNLIKELY(m_context->hasMutationObservers())) {
+      MutationObserverInstance::queueChildListRecord(this, {{}, {node}, childAt(idx - 1), childAt(idx + 1)});
+    }
     arraySpliceValue(m_ctx, childNodes, idx, 1);
     node->removeParentNode();
     node->_notifyNodeRemoved(this);
@@ -477,10 +518,15 @@ JSValue NodeInstance::internalInsertBefore(NodeInstance* node, NodeInstance* ref
         return JS_ThrowTypeError(m_ctx, "Failed to execute 'insertBefore' on 'Node': reference node is not a child of this node.");
       }
 
+      NodeInstance* previousSibling = UNLIKELY(m_context->hasMutationObservers()) ? parent->childAt(idx - 1) : nullptr;
       arrayInsert(m_ctx, parentChildNodes, idx, node->jsObject);
       node->setParentNode(parent);
       node->_notifyNodeInsert(parent);
 
+      if (UNLIKELY(m_context->hasMutationObservers())) {
+        MutationObserverInstance::queueChildListRecord(parent, {{node}, {}, previousSibling, referenceNode});
+      }
+
       std::string nodeEventTargetId = std::to_string(node->m_eventTargetId);
       std::string position = std::string("beforebegin");
 
@@ -493,6 +539,77 @@ JSValue NodeInstance::internalInsertBefore(NodeInstance* node, NodeInstance* ref
 
   return JS_NULL;
 }
+JSValue NodeInstance::internalInsertFragmentChildren(NodeInstance* fragment, NodeInstance* referenceNode) {
+  uint32_t start;
+  if (referenceNode == nullptr) {
+    start = arrayGetLength(m_ctx, childNodes);
+  } else {
+    int32_t idx = JS_VALUE_GET_PTR(referenceNode->parentNode) == JS_VALUE_GET_PTR(jsObject) ? arrayFindIdx(m_ctx, childNodes, referenceNode->jsObject) : -1;
+    if (idx == -1) {
+      return JS_ThrowTypeError(m_ctx, "Failed to execute 'insertBefore' on 'Node': reference node is not a child of this node.");
+    }
+    start = idx;
+  }
+
+  // Fragment childNodes are only truncated after every child had been moved, so its storage can be borrowed.
+  JSValue* children;
+  uint32_t count;
+  std::vector<JSValue> copiedChildren;
+  if (fragment == this || !JS_GetFastArray(fragment->childNodes, &children, &count)) {
+    count = arrayGetLength(m_ctx, fragment->childNodes);
+    copiedChildren.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      copiedChildren.emplace_back(JS_GetPropertyUint32(m_ctx, fragment->childNodes, i));
+    }
+    children = copiedChildren.data();
+  }
+
+  if (count == 0)
+    return JS_NULL;
+
+  NodeInstance* previousSibling = UNLIKELY(m_context->hasMutationObservers()) ? childAt(static_cast<int32_t>(start) - 1) : nullptr;
+  arrayInsertValues(m_ctx, childNodes, start, children, count);
+
+  std::string childIds;
+  for (uint32_t i = 0; i < count; i++) {
+    auto* node = static_cast<NodeInstance*>(JS_GetOpaque(children[i], Node::classId(children[i])));
+    node->setParentNode(this);
+    node->_notifyNodeInsert(this);
+    if (i > 0) {
+      childIds += ',';
+    }
+    childIds += std::to_string(node->m_eventTargetId);
+  }
+
+  // Children leave the fragment and join this node, queued while children are still borrowed.
+  if (UNLIKELY(m_context->hasMutationObservers())) {
+    ChildListMutation mutation;
+    for (uint32_t i = 0; i < count; i++) {
+      mutation.addedNodes.emplace_back(static_cast<NodeInstance*>(JS_GetOpaque(children[i], Node::classId(children[i]))));
+    }
+    if (fragment != this) {
+      MutationObserverInstance::queueChildListRecord(fragment, {{}, mutation.addedNodes, nullptr, nullptr});
+    }
+    mutation.previousSibling = previousSibling;
+    mutation.nextSibling = referenceNode;
+    MutationObserverInstance::queueChildListRecord(this, mutation);
+  }
+
+  for (auto& child : copiedChildren) {
+    JS_FreeValue(m_ctx, child);
+  }
+
+  // Clear fragment childNodes reference.
+  JS_SetPropertyStr(m_ctx, fragment->childNodes, "length", JS_NewUint32(m_ctx, 0));
+
+  std::unique_ptr<NativeString> args_01 = stringToNativeString(childIds);
+  std::unique_ptr<NativeString> args_02 = stringToNativeString(referenceNode == nullptr ? "beforeend" : "beforebegin");
+  int32_t targetId = referenceNode == nullptr ? m_eventTargetId : referenceNode->m_eventTargetId;
+  m_context->uiCommandBuffer()->addCommand(targetId, UICommand::insertAdjacentNodes, *args_01, *args_02, nullptr);
+
+  return JS_NULL;
+}
+
 JSValue NodeInstance::internalGetTextContent() {
   return JS_NULL;
 }
@@ -508,6 +625,9 @@ JSValue NodeInstance::internalReplaceChild(NodeInstance* newChild, NodeInstance*
 
   newChild->setParentNode(this);
 
+  if (UNLIKELY(m_context->hasMutationObservers())) {
+    MutationObserverInstance::queueChildListRecord(this, {{newChild}, {oldChild}, childAt(childIndex - 1), childAt(childIndex + 1)});
+  }
   arraySpliceValue(m_ctx, childNodes, childIndex, 1, newChild->jsObject);
 
   oldChild->_notifyNodeRemoved(this);
@@ -532,6 +652,9 @@ void NodeInstance::setParentNode(NodeInstance* parent) {
   }
 
   parentNode = JS_DupValue(m_ctx, parent->jsObject);
+  if (hasNodeFlag(NodeFlag::SubtreeHasIdAttribute)) {
+    parent->markSubtreeHasIdAttribute();
+  }
 }
 
 void NodeInstance::removeParentNode() {
@@ -542,7 +665,28 @@ void NodeInstance::removeParentNode() {
   parentNode = JS_NULL;
 }
 
-NodeInstance::~NodeInstance() {}
+NodeInstance::~NodeInstance() {
+  // JSContext may already been freed when instances are collected by the last GC of context.
+  JS_FreeValueRT(ExecutionContext::runtime(), childNodes);
+  // Nodes dropped from childNodes by scripts directly still refer to their parent.
+  JS_FreeValueRT(ExecutionContext::runtime(), parentNode);
+  clearMutationObserverRegistrations();
+}
+void NodeInstance::clearMutationObserverRegistrations() {
+  // Only observed nodes have registrations in the side table of the context.
+  if (hasNodeFlag(NodeFlag::IsObserved)) {
+    MutationObserverInstance::clearRegistrations(this);
+  }
+}
+NodeInstance* NodeInstance::childAt(int32_t index) {
+  if (index < 0 || index >= arrayGetLength(m_ctx, childNodes))
+    return nullptr;
+  // childNodes keeps the child alive, so the reference taken here can be released at once.
+  JSValue child = JS_GetPropertyUint32(m_ctx, childNodes, index);
+  auto* node = static_cast<NodeInstance*>(JS_GetOpaque(child, Node::classId(child)));
+  JS_FreeValue(m_ctx, child);
+  return node;
+}
 void NodeInstance::refer() {
   JS_DupValue(m_ctx, jsObject);
   list_add_tail(&nodeLink.link, &m_context->node_job_list);
@@ -551,15 +695,68 @@ void NodeInstance::unrefer() {
   list_del(&nodeLink.link);
   JS_FreeValue(m_ctx, jsObject);
 }
-void NodeInstance::_notifyNodeRemoved(NodeInstance* node) {}
-void NodeInstance::_notifyNodeInsert(NodeInstance* node) {}
+void NodeInstance::_notifyNodeRemoved(NodeInstance* node) {
+  if (isConnected()) {
+    setSubtreeConnected(false);
+  }
+}
+void NodeInstance::_notifyNodeInsert(NodeInstance* node) {
+  // Nodes detached by ensureDetached keep their state until they are inserted again, so moving a subtree within the
+  // document, or between detached trees, visits none of its nodes.
+  if (isConnected() != node->isConnected()) {
+    setSubtreeConnected(node->isConnected());
+  }
+}
+void NodeInstance::setSubtreeConnected(bool connected) {
+  if (connected) {
+    setNodeFlag(NodeFlag::IsConnected);
+  } else {
+    removeNodeFlag(NodeFlag::IsConnected);
+  }
+
+  // Subtrees without any id have nothing to register to the id map of document, only their flags change.
+  if (!hasNodeFlag(NodeFlag::SubtreeHasIdAttribute)) {
+    forEachChild([connected](NodeInstance* child) { child->setSubtreeConnected(connected); });
+    return;
+  }
+
+  bool subtreeHasId = hasNodeFlag(NodeFlag::HasIdAttribute);
+  if (subtreeHasId) {
+    auto* element = static_cast<ElementInstance*>(this);
+    if (connected) {
+      element->_notifyChildInsert();
+    } else {
+      element->_notifyChildRemoved();
+    }
+  }
+
+  forEachChild([connected, &subtreeHasId](NodeInstance* child) {
+    child->setSubtreeConnected(connected);
+    subtreeHasId = subtreeHasId || child->hasNodeFlag(NodeFlag::SubtreeHasIdAttribute);
+  });
+  // The summary is only set eagerly, subtrees whose ids are all gone clear it here.
+  if (!subtreeHasId) {
+    removeNodeFlag(NodeFlag::SubtreeHasIdAttribute);
+  }
+}
+void NodeInstance::markSubtreeHasIdAttribute() {
+  // Ancestors of a marked node are always marked, so the walk stops at the first one.
+  NodeInstance* node = this;
+  while (node != nullptr && !node->hasNodeFlag(NodeFlag::SubtreeHasIdAttribute)) {
+    node->setNodeFlag(NodeFlag::SubtreeHasIdAttribute);
+    node = static_cast<NodeInstance*>(JS_GetOpaque(node->parentNode, Node::classId(node->parentNode)));
+  }
+}
 void NodeInstance::ensureDetached(NodeInstance* node) {
   auto* nodeParent = static_cast<NodeInstance*>(JS_GetOpaque(node->parentNode, Node::classId(node->parentNode)));
 
   if (nodeParent != nullptr) {
     int32_t idx = arrayFindIdx(m_ctx, nodeParent->childNodes, node->jsObject);
     if (idx != -1) {
-      node->_notifyNodeRemoved(nodeParent);
+      if (UNLIKELY(m_context->hasMutationObservers())) {
+        MutationObserverInstance::queueChildListRecord(nodeParent, {{}, {node}, nodeParent->childAt(idx - 1), nodeParent->childAt(idx + 1)});
+      }
+      // The connected state is updated once the node is inserted again, callers drop it when the insertion fails.
       arraySpliceValue(m_ctx, nodeParent->childNodes, idx, 1);
       node->removeParentNode();
     }
@@ -572,6 +769,10 @@ void NodeInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
   // Should check object is already inited before gc mark.
   if (JS_IsObject(parentNode))
     JS_MarkValue(rt, parentNode, mark_func);
+  JS_MarkValue(rt, childNodes, mark_func);
+  if (hasNodeFlag(NodeFlag::IsObserved)) {
+    MutationObserverInstance::traceRegistrations(this, rt, mark_func);
+  }
 }
 
 }  // namespace kraken::binding::qjs
@@ -6,8 +6,8 @@
 #ifndef KRAKENBRIDGE_NODE_H
 #define KRAKENBRIDGE_NODE_H
 
-#include <set>
 #include <utility>
+#include <vector>
 
 #include "event_target.h"
 
@@ -18,9 +18,20 @@ void bindNode(ExecutionContext* context);
 enum NodeType { ELEMENT_NODE = 1, TEXT_NODE = 3, COMMENT_NODE = 8, DOCUMENT_NODE = 9, DOCUMENT_TYPE_NODE = 10, DOCUMENT_FRAGMENT_NODE = 11 };
 
 class NodeInstance;
+class Element;
 class ElementInstance;
 class DocumentInstance;
 class TextNodeInstance;
+class DocumentFragmentInstance;
+class MutationObserverInstance;
+
+// A node of a subtree flattened in tree order, so that the subtree can be cloned in one pass.
+struct NodeCloneRecord {
+  NodeInstance* node;
+  int32_t parentIndex;
+  // Children of a template element are cloned into the content of the new template.
+  bool inTemplateContent;
+};
 
 class Node : public EventTarget {
  public:
@@ -54,6 +65,7 @@ class Node : public EventTarget {
   DEFINE_PROTOTYPE_READONLY_PROPERTY(previousSibling);
   DEFINE_PROTOTYPE_READONLY_PROPERTY(nextSibling);
   DEFINE_PROTOTYPE_READONLY_PROPERTY(nodeType);
+  DEFINE_PROTOTYPE_READONLY_PROPERTY(childNodes);
 
   DEFINE_PROTOTYPE_FUNCTION(cloneNode, 1);
   DEFINE_PROTOTYPE_FUNCTION(appendChild, 1);
@@ -62,8 +74,9 @@ class Node : public EventTarget {
   DEFINE_PROTOTYPE_FUNCTION(insertBefore, 2);
   DEFINE_PROTOTYPE_FUNCTION(replaceChild, 2);
 
-  static void traverseCloneNode(JSContext* ctx, NodeInstance* baseNode, NodeInstance* targetNode);
-  static JSValue copyNodeValue(JSContext* ctx, NodeInstance* node);
+  static void collectCloneRecords(NodeInstance* node, int32_t parentIndex, bool inTemplateContent, bool deep, std::vector<NodeCloneRecord>& records);
+  static NodeInstance* cloneNodeTree(ExecutionContext* context, const std::vector<NodeCloneRecord>& records);
+  static NodeInstance* copyNode(NodeInstance* node, Element* elementConstructor);
   friend ElementInstance;
   friend TextNodeInstance;
 };
@@ -75,16 +88,16 @@ struct NodeJob {
 
 class NodeInstance : public EventTargetInstance {
  public:
-  enum class NodeFlag : uint32_t { IsDocumentFragment = 1 << 0, IsTemplateElement = 1 << 1 };
-  mutable std::set<NodeFlag> m_nodeFlags;
-  bool hasNodeFlag(NodeFlag flag) const { return m_nodeFlags.size() != 0 && m_nodeFlags.find(flag) != m_nodeFlags.end(); }
-  void setNodeFlag(NodeFlag flag) const { m_nodeFlags.insert(flag); }
-  void removeNodeFlag(NodeFlag flag) const { m_nodeFlags.erase(flag); }
+  enum class NodeFlag : uint32_t { IsDocumentFragment = 1 << 0, IsTemplateElement = 1 << 1, IsConnected = 1 << 2, HasIdAttribute = 1 << 3, IsRecyclable = 1 << 4, SubtreeHasIdAttribute = 1 << 5, IsObserved = 1 << 6, IsIntersectionObserved = 1 << 7, IsResizeObserved = 1 << 8 };
+  mutable uint32_t m_nodeFlags{0};
+  bool hasNodeFlag(NodeFlag flag) const { return (m_nodeFlags & static_cast<uint32_t>(flag)) != 0; }
+  void setNodeFlag(NodeFlag flag) const { m_nodeFlags |= static_cast<uint32_t>(flag); }
+  void removeNodeFlag(NodeFlag flag) const { m_nodeFlags &= ~static_cast<uint32_t>(flag); }
 
   NodeInstance() = delete;
-  explicit NodeInstance(Node* node, NodeType nodeType, JSClassID classId, std::string name)
-      : EventTargetInstance(node, classId, std::move(name)), m_document(m_context->document()), nodeType(nodeType) {}
-  explicit NodeInstance(Node* node, NodeType nodeType, JSClassID classId, JSClassExoticMethods& exoticMethods, std::string name)
+  explicit NodeInstance(Node* node, NodeType nodeType, JSClassID classId, const char* name)
+      : EventTargetInstance(node, classId, name), m_document(m_context->document()), nodeType(nodeType) {}
+  explicit NodeInstance(Node* node, NodeType nodeType, JSClassID classId, JSClassExoticMethods& exoticMethods, const char* name)
       : EventTargetInstance(node, classId, exoticMethods, name), m_document(m_context->document()), nodeType(nodeType) {}
   ~NodeInstance();
   bool isConnected();
@@ -98,6 +111,8 @@ class NodeInstance : public EventTargetInstance {
   void internalClearChild();
   NodeInstance* internalRemoveChild(NodeInstance* node);
   JSValue internalInsertBefore(NodeInstance* node, NodeInstance* referenceNode);
+  // Move all children of a DocumentFragment before referenceNode (or to the end when null) with one UI command.
+  JSValue internalInsertFragmentChildren(NodeInstance* fragment, NodeInstance* referenceNode);
   virtual JSValue internalGetTextContent();
   virtual void internalSetTextContent(JSValue content);
   JSValue internalReplaceChild(NodeInstance* newChild, NodeInstance* oldChild);
@@ -114,19 +129,45 @@ class NodeInstance : public EventTargetInstance {
   void unrefer();
   inline DocumentInstance* document() { return m_document; }
 
-  virtual void _notifyNodeRemoved(NodeInstance* node);
-  virtual void _notifyNodeInsert(NodeInstance* node);
+  void _notifyNodeRemoved(NodeInstance* node);
+  void _notifyNodeInsert(NodeInstance* node);
+
+  // Visit children in order. Fast arrays are read in place, so the visitor must not mutate childNodes.
+  template <typename Visitor>
+  void forEachChild(Visitor visitor) {
+    JSValue* children;
+    uint32_t count;
+    if (JS_GetFastArray(childNodes, &children, &count)) {
+      for (uint32_t i = 0; i < count; i++) {
+        visitor(static_cast<NodeInstance*>(JS_GetOpaque(children[i], Node::classId(children[i]))));
+      }
+      return;
+    }
+
+    int32_t len = arrayGetLength(m_ctx, childNodes);
+    for (int32_t i = 0; i < len; i++) {
+      JSValue child = JS_GetPropertyUint32(m_ctx, childNodes, i);
+      visitor(static_cast<NodeInstance*>(JS_GetOpaque(child, Node::classId(child))));
+      JS_FreeValue(m_ctx, child);
+    }
+  }
 
  protected:
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
 
  private:
   DocumentInstance* m_document{nullptr};
-  ObjectProperty m_childNodes{m_context, jsObject, "childNodes", childNodes};
   void ensureDetached(NodeInstance* node);
+  void setSubtreeConnected(bool connected);
+  // Marks this node and its ancestors as carrying an id in their subtree.
+  void markSubtreeHasIdAttribute();
+  void clearMutationObserverRegistrations();
+  // Child at index of childNodes without taking a reference, null when out of range.
+  NodeInstance* childAt(int32_t index);
   friend DocumentInstance;
   friend Node;
   friend ElementInstance;
+  friend MutationObserverInstance;
 };
 
 }  // namespace kraken::binding::qjs
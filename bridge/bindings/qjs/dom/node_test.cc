@@ -115,6 +115,32 @@ TEST(Node, ensureDetached) {
   EXPECT_EQ(logCalled, true);
 }
 
+TEST(Node, insertBeforeInvalidReferenceKeepsNode) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "TypeError true true true true");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) { errorCalled = true; });
+  const char* code =
+      "let div = document.createElement('div');"
+      "div.setAttribute('id', 'a');"
+      "let next = document.createElement('div');"
+      "document.body.appendChild(div);"
+      "document.body.appendChild(next);"
+      "let container = document.createElement('div');"
+      "let error;"
+      "try { container.insertBefore(div, document.createElement('span')); } catch (e) { error = e; }"
+      "document.body.insertBefore(div, div);"
+      "console.log(error.name, div.parentNode === document.body, div.isConnected, document.getElementById('a') === div,"
+      "  document.body.childNodes.indexOf(div) + 1 === document.body.childNodes.indexOf(next));";
+  bridge->evaluateScript(code, strlen(code), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
 TEST(Node, replaceBody) {
   bool static errorCalled = false;
   bool static logCalled = false;
@@ -212,3 +238,186 @@ console.log(
   EXPECT_EQ(errorCalled, false);
   EXPECT_EQ(logCalled, true);
 }
+
+TEST(Node, insertDocumentFragmentChildren) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "a,b,c,d,e,f,g 0 0 true true");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+function fragmentOf(names) {
+  let fragment = document.createDocumentFragment();
+  names.forEach(name => {
+    let div = document.createElement('div');
+    div.setAttribute('name', name);
+    fragment.appendChild(div);
+  });
+  return fragment;
+}
+
+let container = document.createElement('div');
+document.body.appendChild(container);
+let first = fragmentOf(['a', 'e']);
+container.appendChild(first);
+let second = fragmentOf(['b', 'c', 'd']);
+container.insertBefore(second, container.lastChild);
+let placeholder = document.createElement('div');
+container.appendChild(placeholder);
+container.replaceChild(fragmentOf(['f', 'g']), placeholder);
+
+let names = Array.from(container.childNodes).map(node => node.getAttribute('name'));
+console.log(names.join(','), first.childNodes.length, second.childNodes.length, container.firstChild.parentNode === container, placeholder.parentNode === null);
+)";
+  context->uiCommandBuffer()->clear();
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  // Each fragment is moved with one command carrying all of its children.
+  int insertAdjacentNodesCount = 0;
+  UICommandItem* commands = context->uiCommandBuffer()->data();
+  for (int64_t i = 0; i < context->uiCommandBuffer()->size(); i++) {
+    if (commands[i].type == UICommand::insertAdjacentNodes) {
+      insertAdjacentNodesCount++;
+    }
+  }
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+  EXPECT_EQ(insertAdjacentNodesCount, 3);
+}
+
+TEST(Node, cloneNodeTree) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "<div class=\"box\" style=\"width: 10px;\"><span>hello</span><img alt=\"a\"></img></div> true true 3 true true");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+let div = document.createElement('div');
+div.className = 'box';
+div.style.width = '10px';
+let span = document.createElement('span');
+span.appendChild(document.createTextNode('hello'));
+div.appendChild(span);
+let img = document.createElement('img');
+img.setAttribute('alt', 'a');
+div.appendChild(img);
+div.appendChild(document.createComment());
+document.body.appendChild(div);
+
+let clone = div.cloneNode(true);
+let detached = clone.parentNode === null;
+document.body.appendChild(clone);
+console.log(clone.outerHTML, clone.firstChild.parentNode === clone, clone.childNodes[1] instanceof HTMLImageElement,
+  clone.childNodes.length, detached, document.getElementsByClassName('box').length === 2);
+)";
+  context->uiCommandBuffer()->clear();
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  int cloneNodeTreeCount = 0;
+  UICommandItem* commands = context->uiCommandBuffer()->data();
+  for (int64_t i = 0; i < context->uiCommandBuffer()->size(); i++) {
+    EXPECT_NE(commands[i].type, UICommand::cloneNode);
+    if (commands[i].type == UICommand::cloneNodeTree) {
+      cloneNodeTreeCount++;
+    }
+  }
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+  EXPECT_EQ(cloneNodeTreeCount, 1);
+}
+
+TEST(Node, cloneTemplateContentAfterChange) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    EXPECT_STREQ(message.c_str(), "<p>1</p> <p>2</p><b>3</b> <i>4</i> <template><u>5</u></template>");
+    logCalled = true;
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code = R"(
+function html(fragment) {
+  let div = document.createElement('div');
+  div.appendChild(fragment);
+  return div.innerHTML;
+}
+
+function element(tagName, text) {
+  let node = document.createElement(tagName);
+  node.appendChild(document.createTextNode(text));
+  return node;
+}
+
+let template = document.createElement('template');
+template.content.appendChild(element('p', '1'));
+let first = html(template.content.cloneNode(true));
+
+template.content.firstChild.firstChild.textContent = '2';
+template.content.appendChild(element('b', '3'));
+let second = html(template.content.cloneNode(true));
+
+template.content.removeChild(template.content.firstChild);
+template.content.replaceChild(element('i', '4'), template.content.firstChild);
+let third = html(template.content.cloneNode(true));
+
+let inner = document.createElement('template');
+inner.content.appendChild(element('u', '5'));
+template.content.replaceChild(inner, template.content.firstChild);
+let nested = template.content.cloneNode(true).firstChild;
+console.log(first, second, third, nested.outerHTML);
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(Node, cloneTemplateContentAfterChildNodesChange) {
+  bool static errorCalled = false;
+  static std::vector<std::string> logs;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  std::string code = R"(
+function html(fragment) {
+  let div = document.createElement('div');
+  div.appendChild(fragment);
+  return div.innerHTML;
+}
+
+var template = document.createElement('template');
+template.content.appendChild(document.createElement('p'));
+template.content.appendChild(document.createElement('b'));
+console.log(html(template.content.cloneNode(true)));
+// Removed without the DOM methods, the node is freed by the next GC.
+template.content.childNodes.pop();
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  JS_RunGC(ExecutionContext::runtime());
+
+  std::string check = "console.log(html(template.content.cloneNode(true)));";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logs.size(), 2);
+  EXPECT_STREQ(logs[0].c_str(), "<p></p><b></b>");
+  EXPECT_STREQ(logs[1].c_str(), "<p></p>");
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "resize_observer.h"
+#include <algorithm>
+#include "bindings/qjs/qjs_patch.h"
+#include "element.h"
+
+namespace kraken::binding::qjs {
+
+std::once_flag kResizeObserverInitFlag;
+
+void bindResizeObserver(ExecutionContext* context) {
+  auto* constructor = ResizeObserver::instance(context);
+  context->defineGlobalProperty("ResizeObserver", constructor->jsObject);
+}
+
+JSClassID ResizeObserver::kResizeObserverClassId{0};
+
+ResizeObserver::ResizeObserver(ExecutionContext* context) : HostClass(context, "ResizeObserver") {
+  std::call_once(kResizeObserverInitFlag, []() { JS_NewClassID(&kResizeObserverClassId); });
+}
+
+JSValue ResizeObserver::instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue this_val, int argc, JSValue* argv) {
+  if (argc < 1 || !JS_IsFunction(ctx, argv[0])) {
+    return JS_ThrowTypeError(ctx, "Failed to construct 'ResizeObserver': parameter 1 is not of type 'Function'.");
+  }
+
+  auto* observer = new ResizeObserverInstance(this, argv[0]);
+  return observer->jsObject;
+}
+
+static ResizeObserverInstance* thisObserver(JSValue this_val) {
+  return static_cast<ResizeObserverInstance*>(JS_GetOpaque(this_val, ResizeObserver::kResizeObserverClassId));
+}
+
+static ElementInstance* targetElement(int argc, JSValue* argv) {
+  if (argc < 1)
+    return nullptr;
+  return static_cast<ElementInstance*>(JS_GetOpaque(argv[0], Element::classId()));
+}
+
+JSValue ResizeObserver::observe(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'ResizeObserver': this is not a ResizeObserver object.");
+  }
+  ElementInstance* element = targetElement(argc, argv);
+  if (element == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'ResizeObserver': parameter 1 is not of type 'Element'.");
+  }
+
+  ResizeObserverBoxOptions box = ResizeObserverBoxOptions::contentBox;
+  JSValue options = argc > 1 ? argv[1] : JS_UNDEFINED;
+  if (JS_IsObject(options)) {
+    JSValue boxValue = JS_GetPropertyStr(ctx, options, "box");
+    if (!JS_IsUndefined(boxValue)) {
+      std::string value = jsValueToStdString(ctx, boxValue);
+      if (value == "border-box") {
+        box = ResizeObserverBoxOptions::borderBox;
+      } else if (value != "content-box") {
+        // Dart reports sizes in logical pixels, device-pixel-content-box is not supported.
+        JS_FreeValue(ctx, boxValue);
+        return JS_ThrowTypeError(ctx, "Failed to execute 'observe' on 'ResizeObserver': The provided value '%s' is not a supported value of type 'ResizeObserverBoxOptions'.", value.c_str());
+      }
+    }
+    JS_FreeValue(ctx, boxValue);
+  }
+
+  observer->observe(element, box);
+  return JS_UNDEFINED;
+}
+
+JSValue ResizeObserver::unobserve(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'unobserve' on 'ResizeObserver': this is not a ResizeObserver object.");
+  }
+  ElementInstance* element = targetElement(argc, argv);
+  if (element == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'unobserve' on 'ResizeObserver': parameter 1 is not of type 'Element'.");
+  }
+  observer->unobserve(element);
+  return JS_UNDEFINED;
+}
+
+JSValue ResizeObserver::disconnect(JSContext* ctx, JSValue this_val, int argc, JSValue* argv) {
+  auto* observer = thisObserver(this_val);
+  if (observer == nullptr) {
+    return JS_ThrowTypeError(ctx, "Failed to execute 'disconnect' on 'ResizeObserver': this is not a ResizeObserver object.");
+  }
+  observer->disconnect();
+  return JS_UNDEFINED;
+}
+
+ResizeObserverInstance::ResizeObserverInstance(ResizeObserver* resizeObserver, JSValue callback)
+    : Instance(resizeObserver, "ResizeObserver", nullptr, ResizeObserver::kResizeObserverClassId, finalize), m_callback(JS_DupValue(m_ctx, callback)) {}
+
+ResizeObserverInstance::~ResizeObserverInstance() {
+  // Registrations keep this observer alive, so it is only collected with registrations left when the GC frees it
+  // together with the elements observed. Unlink it from them, their references go with the cycle.
+  for (ElementInstance* element : m_targets) {
+    unregister(element);
+  }
+  JS_FreeValueRT(ExecutionContext::runtime(), m_callback);
+}
+
+void ResizeObserverInstance::observe(ElementInstance* element, ResizeObserverBoxOptions box) {
+  ResizeObservedElement& observed = m_context->m_resizeObservedElements[element->eventTargetId()];
+  auto& registrations = observed.registrations;
+  // Observing again replaces the observation, which starts over from a zero size.
+  auto it = std::find_if(registrations.begin(), registrations.end(), [this](const ResizeObserverRegistration& registration) { return registration.observer == this; });
+  if (it != registrations.end()) {
+    *it = {this, box};
+  } else {
+    // The registration keeps the observer alive until it is dropped.
+    registrations.push_back({this, box});
+    JS_DupValue(m_ctx, jsObject);
+    m_targets.push_back(element);
+    if (registrations.size() == 1) {
+      observed.element = element;
+      element->setNodeFlag(NodeInstance::NodeFlag::IsResizeObserved);
+    }
+  }
+
+  // Dart measures each element once for all of its observers, and only reports sizes which changed. Observing makes
+  // it report the current size on the next frame, registrations which already saw that size skip it.
+  m_context->uiCommandBuffer()->addCommand(element->eventTargetId(), UICommand::observeResize, nullptr);
+}
+
+void ResizeObserverInstance::unobserve(ElementInstance* element) {
+  auto it = std::find(m_targets.begin(), m_targets.end(), element);
+  if (it == m_targets.end())
+    return;
+  m_targets.erase(it);
+
+  unregister(element);
+  if (!element->hasNodeFlag(NodeInstance::NodeFlag::IsResizeObserved)) {
+    m_context->uiCommandBuffer()->addCommand(element->eventTargetId(), UICommand::unobserveResize, nullptr);
+  }
+  JS_FreeValue(m_ctx, jsObject);
+}
+
+void ResizeObserverInstance::unregister(ElementInstance* element) {
+  auto& observedElements = m_context->m_resizeObservedElements;
+  auto it = observedElements.find(element->eventTargetId());
+  auto& registrations = it->second.registrations;
+  registrations.erase(std::remove_if(registrations.begin(), registrations.end(), [this](const ResizeObserverRegistration& registration) { return registration.observer == this; }),
+                      registrations.end());
+  if (registrations.empty()) {
+    observedElements.erase(it);
+    element->removeNodeFlag(NodeInstance::NodeFlag::IsResizeObserved);
+  }
+}
+
+void ResizeObserverInstance::disconnect() {
+  // Keep this alive while the references from elements are released.
+  JS_DupValue(m_ctx, jsObject);
+  while (!m_targets.empty()) {
+    unobserve(m_targets.back());
+  }
+  JS_FreeValue(m_ctx, jsObject);
+}
+
+void ResizeObserverInstance::clearRegistrations(ElementInstance* element) {
+  auto& observedElements = element->context()->m_resizeObservedElements;
+  auto it = observedElements.find(element->eventTargetId());
+  if (it == observedElements.end())
+    return;
+
+  std::vector<ResizeObserverRegistration> registrations = std::move(it->second.registrations);
+  observedElements.erase(it);
+  element->removeNodeFlag(NodeInstance::NodeFlag::IsResizeObserved);
+  for (auto& registration : registrations) {
+    ResizeObserverInstance* observer = registration.observer;
+    observer->m_targets.erase(std::remove(observer->m_targets.begin(), observer->m_targets.end(), element), observer->m_targets.end());
+    // The element does not touch the observer after this, releasing the last reference may finalize it.
+    JS_FreeValueRT(ExecutionContext::runtime(), observer->jsObject);
+  }
+}
+
+void ResizeObserverInstance::traceRegistrations(const ElementInstance* element, JSRuntime* rt, JS_MarkFunc* mark_func) {
+  auto& observedElements = element->context()->m_resizeObservedElements;
+  auto it = observedElements.find(element->eventTargetId());
+  if (it == observedElements.end())
+    return;
+  for (auto& registration : it->second.registrations) {
+    JS_MarkValue(rt, registration.observer->jsObject, mark_func);
+  }
+}
+
+static JSValue newResizeObserverSize(JSContext* ctx, double inlineSize, double blockSize) {
+  // https://drafts.csswg.org/resize-observer/#resizeobserversize
+  JSValue size = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, size, "inlineSize", JS_NewFloat64(ctx, inlineSize));
+  JS_SetPropertyStr(ctx, size, "blockSize", JS_NewFloat64(ctx, blockSize));
+  JSValue sizes = JS_NewArray(ctx);
+  JS_SetPropertyUint32(ctx, sizes, 0, size);
+  return sizes;
+}
+
+static JSValue newContentRect(JSContext* ctx, NativeResizeObservation& observation) {
+  JSValue rect = JS_NewObject(ctx);
+  JS_SetPropertyStr(ctx, rect, "x", JS_NewFloat64(ctx, observation.contentX));
+  JS_SetPropertyStr(ctx, rect, "y", JS_NewFloat64(ctx, observation.contentY));
+  JS_SetPropertyStr(ctx, rect, "width", JS_NewFloat64(ctx, observation.contentWidth));
+  JS_SetPropertyStr(ctx, rect, "height", JS_NewFloat64(ctx, observation.contentHeight));
+  JS_SetPropertyStr(ctx, rect, "top", JS_NewFloat64(ctx, observation.contentY));
+  JS_SetPropertyStr(ctx, rect, "right", JS_NewFloat64(ctx, observation.contentX + observation.contentWidth));
+  JS_SetPropertyStr(ctx, rect, "bottom", JS_NewFloat64(ctx, observation.contentY + observation.contentHeight));
+  JS_SetPropertyStr(ctx, rect, "left", JS_NewFloat64(ctx, observation.contentX));
+  return rect;
+}
+
+void ResizeObserverInstance::deliverObservations(ExecutionContext* context, NativeResizeObservation* observations, int32_t length) {
+  JSContext* ctx = context->ctx();
+  // Observers with entries in the order they first became active, each holding its observer alive.
+  std::vector<std::pair<JSValue, JSValue>> activeObservers;
+
+  for (int32_t i = 0; i < length; i++) {
+    NativeResizeObservation& observation = observations[i];
+    // Elements may have been unobserved or disposed after dart measured them.
+    auto it = context->m_resizeObservedElements.find(observation.targetId);
+    if (it == context->m_resizeObservedElements.end())
+      continue;
+    ElementInstance* element = it->second.element;
+    // Keep the element and its observers alive while entries are allocated.
+    JSValue target = JS_DupValue(ctx, element->jsObject);
+
+    JSValue entry = JS_NULL;
+    for (auto& registration : it->second.registrations) {
+      bool isBorderBox = registration.box == ResizeObserverBoxOptions::borderBox;
+      double inlineSize = isBorderBox ? observation.borderBoxWidth : observation.contentWidth;
+      double blockSize = isBorderBox ? observation.borderBoxHeight : observation.contentHeight;
+      if (inlineSize == registration.lastReportedInlineSize && blockSize == registration.lastReportedBlockSize)
+        continue;
+      registration.lastReportedInlineSize = inlineSize;
+      registration.lastReportedBlockSize = blockSize;
+
+      // https://drafts.csswg.org/resize-observer/#resize-observer-entry-interface
+      if (JS_IsNull(entry)) {
+        entry = JS_NewObject(ctx);
+        JS_SetPropertyStr(ctx, entry, "target", JS_DupValue(ctx, target));
+        JS_SetPropertyStr(ctx, entry, "contentRect", newContentRect(ctx, observation));
+        JS_SetPropertyStr(ctx, entry, "borderBoxSize", newResizeObserverSize(ctx, observation.borderBoxWidth, observation.borderBoxHeight));
+        JS_SetPropertyStr(ctx, entry, "contentBoxSize", newResizeObserverSize(ctx, observation.contentWidth, observation.contentHeight));
+      }
+
+      ResizeObserverInstance* observer = registration.observer;
+      auto active = std::find_if(activeObservers.begin(), activeObservers.end(), [observer](const std::pair<JSValue, JSValue>& item) { return thisObserver(item.first) == observer; });
+      if (active == activeObservers.end()) {
+        activeObservers.emplace_back(JS_DupValue(ctx, observer->jsObject), JS_NewArray(ctx));
+        active = activeObservers.end() - 1;
+      }
+      JS_SetPropertyUint32(ctx, active->second, arrayGetLength(ctx, active->second), JS_DupValue(ctx, entry));
+    }
+
+    JS_FreeValue(ctx, entry);
+    JS_FreeValue(ctx, target);
+  }
+
+  // Entries are built before any callback runs, so callbacks see the sizes of this frame only.
+  for (auto& [observerValue, entries] : activeObservers) {
+    auto* observer = thisObserver(observerValue);
+    JSValue arguments[] = {entries, observerValue};
+    JSValue returnValue = JS_Call(ctx, observer->m_callback, observerValue, 2, arguments);
+    context->handleException(&returnValue);
+    JS_FreeValue(ctx, returnValue);
+    JS_FreeValue(ctx, entries);
+    JS_FreeValue(ctx, observerValue);
+  }
+  context->drainPendingPromiseJobs();
+}
+
+void ResizeObserverInstance::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
+  JS_MarkValue(rt, m_callback, mark_func);
+}
+
+void ResizeObserverInstance::finalize(JSRuntime* rt, JSValue val) {
+  auto* observer = thisObserver(val);
+  delete observer;
+}
+
+}  // namespace kraken::binding::qjs
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_RESIZE_OBSERVER_H
+#define KRAKENBRIDGE_RESIZE_OBSERVER_H
+
+#include <vector>
+#include "bindings/qjs/host_class.h"
+#include "kraken_bridge.h"
+
+namespace kraken::binding::qjs {
+
+void bindResizeObserver(ExecutionContext* context);
+
+class ElementInstance;
+class ResizeObserverInstance;
+
+enum class ResizeObserverBoxOptions { contentBox, borderBox };
+
+// An element observed by an observer. Each registration keeps a reference to its observer, released when it is
+// dropped.
+// https://drafts.csswg.org/resize-observer/#resize-observation-interface
+struct ResizeObserverRegistration {
+  ResizeObserverInstance* observer;
+  ResizeObserverBoxOptions box{ResizeObserverBoxOptions::contentBox};
+  double lastReportedInlineSize{0};
+  double lastReportedBlockSize{0};
+};
+
+// Registrations of an element, kept in the side table of observed elements.
+struct ResizeObservedElement {
+  ElementInstance* element{nullptr};
+  std::vector<ResizeObserverRegistration> registrations;
+};
+
+class ResizeObserver : public HostClass {
+ public:
+  static JSClassID kResizeObserverClassId;
+  ResizeObserver() = delete;
+  explicit ResizeObserver(ExecutionContext* context);
+
+  JSValue instanceConstructor(JSContext* ctx, JSValue func_obj, JSValue this_val, int argc, JSValue* argv) override;
+
+  OBJECT_INSTANCE(ResizeObserver);
+
+  static JSValue observe(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue unobserve(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+  static JSValue disconnect(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv);
+
+ private:
+  DEFINE_PROTOTYPE_FUNCTION(observe, 1);
+  DEFINE_PROTOTYPE_FUNCTION(unobserve, 1);
+  DEFINE_PROTOTYPE_FUNCTION(disconnect, 0);
+};
+
+// Dart measures elements observed by ResizeObservers after layout, and reports the ones whose size changed in one
+// batch per frame. Nothing is read back from dart when an observer is called, so observers never flush layout.
+class ResizeObserverInstance : public Instance {
+ public:
+  ResizeObserverInstance() = delete;
+  explicit ResizeObserverInstance(ResizeObserver* resizeObserver, JSValue callback);
+  ~ResizeObserverInstance() override;
+
+  // Build entries for the reported sizes and call each observer once with all of its entries.
+  // https://drafts.csswg.org/resize-observer/#broadcast-active-resize-observations
+  static void deliverObservations(ExecutionContext* context, NativeResizeObservation* observations, int32_t length);
+
+  // Drop all registrations of element, called when the element is being destroyed or recycled.
+  static void clearRegistrations(ElementInstance* element);
+  static void traceRegistrations(const ElementInstance* element, JSRuntime* rt, JS_MarkFunc* mark_func);
+
+ private:
+  void observe(ElementInstance* element, ResizeObserverBoxOptions box);
+  void unobserve(ElementInstance* element);
+  void disconnect();
+  // Remove the registration of element from the side table, the caller releases the reference it kept.
+  void unregister(ElementInstance* element);
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
+  static void finalize(JSRuntime* rt, JSValue val);
+
+  JSValue m_callback{JS_NULL};
+  std::vector<ElementInstance*> m_targets;
+  friend ResizeObserver;
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_RESIZE_OBSERVER_H
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "element.h"
+#include "gtest/gtest.h"
+#include "kraken_test_env.h"
+#include "page.h"
+
+using namespace kraken::binding::qjs;
+
+static int32_t eventTargetIdOf(ExecutionContext* context, const char* name) {
+  JSValue value = JS_GetPropertyStr(context->ctx(), context->global(), name);
+  auto* element = static_cast<ElementInstance*>(JS_GetOpaque(value, Element::classId()));
+  int32_t eventTargetId = element->eventTargetId();
+  JS_FreeValue(context->ctx(), value);
+  return eventTargetId;
+}
+
+TEST(ResizeObserver, batchObservationsOfFrame) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "1 2 true 100 50 5 5 110 60 true 1 110 1 112");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var a = document.createElement('div');
+var b = document.createElement('div');
+var calls = [];
+var borderCalls = [];
+var observer = new ResizeObserver((entries, o) => {
+  let rect = entries[0].contentRect;
+  calls.push([entries.length, entries[0].target === a, rect.width, rect.height, rect.x, rect.top,
+    entries[0].borderBoxSize[0].inlineSize, entries[0].borderBoxSize[0].blockSize, o === observer]);
+});
+var borderObserver = new ResizeObserver((entries) => {
+  borderCalls.push(entries.length, entries[0].borderBoxSize[0].inlineSize);
+});
+observer.observe(a);
+observer.observe(b);
+borderObserver.observe(a, { box: 'border-box' });
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  int32_t a = eventTargetIdOf(context, "a");
+  int32_t b = eventTargetIdOf(context, "b");
+  NativeResizeObservation observations[] = {{a, 5, 5, 100, 50, 110, 60}, {b, 0, 0, 10, 10, 10, 10}};
+  bridge->dispatchResizeObservations(observations, 2);
+
+  // Only the border box changed, content box observers are not notified.
+  NativeResizeObservation borderChanged[] = {{a, 6, 6, 100, 50, 112, 62}};
+  std::string unobserve = "observer.unobserve(b);";
+  bridge->evaluateScript(unobserve.c_str(), unobserve.size(), "vm://", 0);
+  bridge->dispatchResizeObservations(borderChanged, 1);
+  // Unobserved elements are ignored.
+  NativeResizeObservation unobserved[] = {{b, 0, 0, 20, 20, 20, 20}};
+  bridge->dispatchResizeObservations(unobserved, 1);
+
+  std::string check = "console.log(calls.length, calls[0].join(' '), borderCalls.join(' '));";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(ResizeObserver, observeAgainReportsCurrentSize) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "first:100,first:100,second:100,first:100 4");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var a = document.createElement('div');
+var calls = [];
+var first = new ResizeObserver((entries) => calls.push('first:' + entries[0].borderBoxSize[0].inlineSize));
+var second = new ResizeObserver((entries) => calls.push('second:' + entries[0].borderBoxSize[0].inlineSize));
+first.observe(a, { box: 'border-box' });
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  int32_t a = eventTargetIdOf(context, "a");
+  NativeResizeObservation observations[] = {{a, 0, 0, 100, 50, 100, 50}};
+  bridge->dispatchResizeObservations(observations, 1);
+
+  // Each observe asks dart to report the element again, observers which already saw the size skip it.
+  context->uiCommandBuffer()->clear();
+  std::string observeAgain = "second.observe(a, { box: 'border-box' }); first.observe(a);";
+  bridge->evaluateScript(observeAgain.c_str(), observeAgain.size(), "vm://", 0);
+  int observeCommands = 0;
+  UICommandItem* commands = context->uiCommandBuffer()->data();
+  for (int64_t i = 0; i < context->uiCommandBuffer()->size(); i++) {
+    if (commands[i].type == UICommand::observeResize)
+      observeCommands++;
+  }
+  EXPECT_EQ(observeCommands, 2);
+  bridge->dispatchResizeObservations(observations, 1);
+
+  // Observing again starts over from a zero size, only that observer is notified of the unchanged size.
+  std::string reobserve = "first.observe(a, { box: 'border-box' });";
+  bridge->evaluateScript(reobserve.c_str(), reobserve.size(), "vm://", 0);
+  bridge->dispatchResizeObservations(observations, 1);
+
+  std::string check = "console.log(calls.join(), calls.length);";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(ResizeObserver, skipZeroSizeAndInvalidBox) {
+  bool static errorCalled = false;
+  bool static logCalled = false;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) {
+    logCalled = true;
+    EXPECT_STREQ(message.c_str(), "0 TypeError TypeError");
+  };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var a = document.createElement('div');
+var calls = 0;
+var observer = new ResizeObserver(() => { calls++; });
+observer.observe(a);
+var errorName = (fn) => {
+  try {
+    fn();
+  } catch (e) {
+    return e.name;
+  }
+};
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  // Elements not rendered yet are reported with zero sizes, observations start from zero.
+  NativeResizeObservation observations[] = {{eventTargetIdOf(context, "a"), 0, 0, 0, 0, 0, 0}};
+  bridge->dispatchResizeObservations(observations, 1);
+
+  std::string check = "console.log(calls, errorName(() => observer.observe(a, { box: 'device-pixel-content-box' })), errorName(() => new ResizeObserver()));";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logCalled, true);
+}
+
+TEST(ResizeObserver, observedElementsKeepObserverAlive) {
+  bool static errorCalled = false;
+  static std::vector<std::string> logs;
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto context = bridge->getContext();
+  std::string code = R"(
+var first = document.createElement('div');
+var second = document.createElement('div');
+(function() {
+  let observer = new ResizeObserver((entries) => console.log(entries.length, entries[0].target === second));
+  observer.observe(first);
+  observer.observe(second);
+})();
+// Dropping one of the observed elements leaves the observer registered on the other one.
+first = null;
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+  JS_RunGC(ExecutionContext::runtime());
+
+  NativeResizeObservation observations[] = {{eventTargetIdOf(context, "second"), 0, 0, 10, 10, 10, 10}};
+  bridge->dispatchResizeObservations(observations, 1);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logs.size(), 1);
+  EXPECT_STREQ(logs[0].c_str(), "1 true");
+}
@@ -5,6 +5,7 @@
 
 #include "script_animation_controller.h"
 #include "dart_methods.h"
+#include "document.h"
 #include "frame_request_callback_collection.h"
 
 #if UNIT_TEST
@@ -25,41 +26,71 @@ ScriptAnimationController* ScriptAnimationController::initialize(JSContext* ctx,
   return GarbageCollected::initialize(ctx, classId);
 }
 
-static void handleRAFTransientCallback(void* ptr, int32_t contextId, double highResTimeStamp, const char* errmsg) {
-  auto* frameCallback = static_cast<FrameCallback*>(ptr);
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(frameCallback->ctx()));
+static void handleAnimationFrameCallback(void* ptr, int32_t contextId, double highResTimeStamp, const char* errmsg) {
+  auto* context = static_cast<ExecutionContext*>(ptr);
 
+  if (!checkPage(contextId, context))
+    return;
   if (!context->isValid())
     return;
 
   if (errmsg != nullptr) {
-    JSValue exception = JS_ThrowTypeError(frameCallback->ctx(), "%s", errmsg);
+    JSValue exception = JS_ThrowTypeError(context->ctx(), "%s", errmsg);
     context->handleException(&exception);
     return;
   }
 
-  // Trigger callbacks.
-  frameCallback->fire(highResTimeStamp);
-
-  context->drainPendingPromiseJobs();
+  context->document()->scriptAnimationController()->serviceScriptedAnimations(highResTimeStamp);
 }
 
 uint32_t ScriptAnimationController::registerFrameCallback(FrameCallback* frameCallback) {
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(m_ctx));
-
-  uint32_t requestId = getDartMethod()->requestAnimationFrame(frameCallback, context->getContextId(), handleRAFTransientCallback);
+  uint32_t requestId = m_nextCallbackId++;
 
   // Register frame callback to collection.
   m_frameRequestCallbackCollection.registerFrameCallback(requestId, frameCallback);
+  scheduleAnimationFrame();
 
   return requestId;
 }
+
 void ScriptAnimationController::cancelFrameCallback(uint32_t callbackId) {
+  // The frame stays requested from dart, it runs nothing when every callback is cancelled.
+  m_frameRequestCallbackCollection.cancelFrameCallback(callbackId);
+}
+
+void ScriptAnimationController::serviceScriptedAnimations(double highResTimeStamp) {
+  m_isFrameRequested = false;
+
   auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(m_ctx));
+  // The frame was requested before the page was frozen, the callbacks wait for it to resume.
+  if (context->isFrozen())
+    return;
 
-  getDartMethod()->cancelAnimationFrame(context->getContextId(), callbackId);
+  EventLoopScheduler::TaskScope scope(context, TaskLane::animation);
+  // Trigger callbacks, with the same timestamp for all of them.
+  m_frameRequestCallbackCollection.executeFrameCallbacks(highResTimeStamp);
 
-  m_frameRequestCallbackCollection.cancelFrameCallback(callbackId);
+  context->drainPendingPromiseJobs();
+
+  // Send the changes of all callbacks to dart at once.
+  getDartMethod()->flushUICommand();
+}
+
+void ScriptAnimationController::resume() {
+  if (!m_frameRequestCallbackCollection.isEmpty()) {
+    scheduleAnimationFrame();
+  }
+}
+
+void ScriptAnimationController::scheduleAnimationFrame() {
+  if (m_isFrameRequested)
+    return;
+
+  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(m_ctx));
+  if (context->isFrozen())
+    return;
+  // `-1` represents some error occurred, try again with the next callback.
+  m_isFrameRequested = getDartMethod()->requestAnimationFrame(context, context->getContextId(), handleAnimationFrameCallback) != -1;
 }
 
 }  // namespace kraken::binding::qjs
@@ -20,6 +20,10 @@ class ScriptAnimationController : public GarbageCollected<ScriptAnimationControl
   // Animation frame callbacks are used for requestAnimationFrame().
   uint32_t registerFrameCallback(FrameCallback* frameCallback);
   void cancelFrameCallback(uint32_t callbackId);
+  // Run all the callbacks of this frame, called by the single frame callback requested from dart.
+  void serviceScriptedAnimations(double highResTimeStamp);
+  // Callbacks registered while the page is frozen are held, the frame is requested when it resumes.
+  void resume();
 
   [[nodiscard]] FORCE_INLINE const char* getHumanReadableName() const override { return "ScriptAnimationController"; }
 
@@ -27,7 +31,12 @@ class ScriptAnimationController : public GarbageCollected<ScriptAnimationControl
   void dispose() const override;
 
  private:
+  void scheduleAnimationFrame();
+
   FrameRequestCallbackCollection m_frameRequestCallbackCollection;
+  uint32_t m_nextCallbackId{1};
+  // Dart is asked for one frame callback at most, whatever the number of callbacks registered.
+  bool m_isFrameRequested{false};
 };
 
 }  // namespace kraken::binding::qjs
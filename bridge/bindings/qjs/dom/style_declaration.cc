@@ -4,8 +4,11 @@
  */
 
 #include "style_declaration.h"
+#include <map>
 #include "event_target.h"
 #include "kraken_bridge.h"
+#include "mutation_observer.h"
+#include "node.h"
 
 namespace kraken::binding::qjs {
 
@@ -120,6 +123,9 @@ StyleDeclarationInstance::~StyleDeclarationInstance() {}
 bool StyleDeclarationInstance::internalSetProperty(std::string& name, JSValue value) {
   name = parseJavaScriptCSSPropertyName(name);
 
+  if (UNLIKELY(m_context->hasMutationObservers())) {
+    queueStyleMutationRecord();
+  }
   properties[name] = jsValueToStdString(m_ctx, value);
 
   if (ownerEventTarget != nullptr) {
@@ -131,6 +137,28 @@ bool StyleDeclarationInstance::internalSetProperty(std::string& name, JSValue va
   return true;
 }
 
+void StyleDeclarationInstance::queueStyleMutationRecord() {
+  if (ownerEventTarget == nullptr)
+    return;
+  JSValue owner = ownerEventTarget->jsObject;
+  auto* node = static_cast<NodeInstance*>(JS_GetOpaque(owner, Node::classId(owner)));
+  if (node == nullptr)
+    return;
+
+  // Only serialized for observers asking for the old value, properties are sorted by name for a stable order.
+  MutationObserverInstance::queueAttributeRecord(node, "style", [this]() {
+    std::map<std::string, std::string> sortedProperties(properties.begin(), properties.end());
+    std::string cssText;
+    for (auto& property : sortedProperties) {
+      if (!cssText.empty()) {
+        cssText += ' ';
+      }
+      cssText += property.first + ": " + property.second + ";";
+    }
+    return JS_NewString(m_ctx, cssText.c_str());
+  });
+}
+
 void StyleDeclarationInstance::internalRemoveProperty(std::string& name) {
   name = parseJavaScriptCSSPropertyName(name);
 
@@ -138,6 +166,9 @@ void StyleDeclarationInstance::internalRemoveProperty(std::string& name) {
     return;
   }
 
+  if (UNLIKELY(m_context->hasMutationObservers())) {
+    queueStyleMutationRecord();
+  }
   properties.erase(name);
 
   if (ownerEventTarget != nullptr) {
@@ -157,21 +188,6 @@ JSValue StyleDeclarationInstance::internalGetPropertyValue(std::string& name) {
   return JS_NewString(m_ctx, "");
 }
 
-// TODO: add support for annotation CSS styleSheets.
-std::string StyleDeclarationInstance::toString() {
-  if (properties.empty())
-    return "";
-
-  std::string s;
-
-  for (auto& attr : properties) {
-    s += attr.first + ": " + attr.second + ";";
-  }
-
-  s += "\"";
-  return s;
-}
-
 void StyleDeclarationInstance::copyWith(StyleDeclarationInstance* instance) {
   for (auto& attr : instance->properties) {
     properties[attr.first] = attr.second;
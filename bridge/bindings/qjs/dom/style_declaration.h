@@ -11,6 +11,7 @@
 namespace kraken::binding::qjs {
 
 class EventTargetInstance;
+class HTMLSerializer;
 void bindCSSStyleDeclaration(ExecutionContext* context);
 
 template <typename CharacterType>
@@ -53,7 +54,6 @@ class StyleDeclarationInstance : public Instance {
   bool internalSetProperty(std::string& name, JSValue value);
   void internalRemoveProperty(std::string& name);
   JSValue internalGetPropertyValue(std::string& name);
-  std::string toString();
   void copyWith(StyleDeclarationInstance* instance);
 
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) override;
@@ -65,6 +65,8 @@ class StyleDeclarationInstance : public Instance {
   static int setProperty(JSContext* ctx, JSValueConst obj, JSAtom atom, JSValueConst value, JSValueConst receiver, int flags);
 
   static JSValue getProperty(JSContext* ctx, JSValueConst obj, JSAtom atom, JSValueConst receiver);
+  // Queue a "style" attribute MutationRecord on the owner node, with the declarations before the change as oldValue.
+  void queueStyleMutationRecord();
 
   static void finalize(JSRuntime* rt, JSValue val) {
     auto* instance = static_cast<StyleDeclarationInstance*>(JS_GetOpaque(val, CSSStyleDeclaration::kCSSStyleDeclarationClassId));
@@ -75,6 +77,7 @@ class StyleDeclarationInstance : public Instance {
 
   std::unordered_map<std::string, std::string> properties;
   friend EventTargetInstance;
+  friend HTMLSerializer;
 };
 
 }  // namespace kraken::binding::qjs
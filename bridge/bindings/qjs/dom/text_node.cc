@@ -6,6 +6,7 @@
 #include "text_node.h"
 #include "document.h"
 #include "kraken_bridge.h"
+#include "mutation_observer.h"
 
 namespace kraken::binding::qjs {
 
@@ -60,22 +61,24 @@ IMPL_PROPERTY_GETTER(TextNode, nodeName)(JSContext* ctx, JSValue this_val, int a
   return JS_NewString(ctx, "#text");
 }
 
-TextNodeInstance::TextNodeInstance(TextNode* textNode, JSValue text) : NodeInstance(textNode, NodeType::TEXT_NODE, TextNode::classId(), "TextNode") {
-  m_data = jsValueToStdString(m_ctx, text);
+TextNodeInstance::TextNodeInstance(TextNode* textNode, JSValue text) : TextNodeInstance(textNode, jsValueToStdString(textNode->context()->ctx(), text)) {}
+
+TextNodeInstance::TextNodeInstance(TextNode* textNode, std::string text) : NodeInstance(textNode, NodeType::TEXT_NODE, TextNode::classId(), "TextNode"), m_data(std::move(text)) {
   std::unique_ptr<NativeString> args_01 = stringToNativeString(m_data);
-  m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::createTextNode, *args_01, nativeEventTarget);
+  m_context->uiCommandBuffer()->addCommand(m_eventTargetId, UICommand::createTextNode, *args_01, &nativeEventTarget);
 }
 
 TextNodeInstance::~TextNodeInstance() {}
 
-std::string TextNodeInstance::toString() {
-  return m_data;
-}
-
 JSValue TextNodeInstance::internalGetTextContent() {
   return JS_NewString(m_ctx, m_data.c_str());
 }
 void TextNodeInstance::internalSetTextContent(JSValue content) {
+  if (UNLIKELY(m_context->hasMutationObservers())) {
+    JSValue oldValue = JS_NewString(m_ctx, m_data.c_str());
+    MutationObserverInstance::queueCharacterDataRecord(this, oldValue);
+    JS_FreeValue(m_ctx, oldValue);
+  }
   m_data = jsValueToStdString(m_ctx, content);
 
   std::string key = "data";
@@ -11,6 +11,7 @@
 namespace kraken::binding::qjs {
 
 class TextNodeInstance;
+class HTMLSerializer;
 
 void bindTextNode(ExecutionContext* context);
 
@@ -37,15 +38,15 @@ class TextNodeInstance : public NodeInstance {
  public:
   TextNodeInstance() = delete;
   explicit TextNodeInstance(TextNode* textNode, JSValue textData);
+  explicit TextNodeInstance(TextNode* textNode, std::string textData);
   ~TextNodeInstance();
 
-  std::string toString();
-
  private:
   JSValue internalGetTextContent() override;
   void internalSetTextContent(JSValue content) override;
   friend TextNode;
   friend Node;
+  friend HTMLSerializer;
 
   std::string m_data;
 };
@@ -7,8 +7,12 @@
 #include "bindings/qjs/bom/timer.h"
 #include "bindings/qjs/bom/window.h"
 #include "bindings/qjs/dom/document.h"
+#include "bindings/qjs/dom/intersection_observer.h"
+#include "bindings/qjs/dom/mutation_observer.h"
+#include "bindings/qjs/dom/resize_observer.h"
 #include "bindings/qjs/module_manager.h"
 #include "bom/dom_timer_coordinator.h"
+#include "dart_methods.h"
 #include "garbage_collected.h"
 #include "kraken_bridge.h"
 #include "qjs_patch.h"
@@ -62,6 +66,8 @@ ExecutionContext::ExecutionContext(int32_t contextId, const JSExceptionHandler&
 
   if (m_runtime == nullptr) {
     m_runtime = JS_NewRuntime();
+    // Scripts of pages with a time budget are interrupted once they run past it.
+    JS_SetInterruptHandler(m_runtime, EventLoopScheduler::handleInterrupt, nullptr);
   }
   // Avoid stack overflow when running in multiple threads.
   JS_UpdateStackTop(m_runtime);
@@ -87,6 +93,9 @@ ExecutionContext::~ExecutionContext() {
   valid_contexts[contextId] = false;
   ctxInvalid_ = true;
 
+  // Events queued by a frozen page are dropped with it.
+  m_frozenTasks.reset();
+
   // Manual free nodes bound by each other.
   {
     struct list_head *el, *el1;
@@ -143,12 +152,21 @@ ExecutionContext::~ExecutionContext() {
     assert_m(false, "Unhandled exception found when dispose JSContext.");
   }
 
+  // Jobs left by this context would run against a freed context in other pages.
+  JS_FreeContextPendingJobs(m_ctx);
+
   JS_FreeValue(m_ctx, globalObject);
   JS_FreeContext(m_ctx);
 
   // Run GC to clean up remaining objects about m_ctx;
   JS_RunGC(m_runtime);
 
+  // Nodes finalized with the context dropped their registrations, never keep entries a node of another page may
+  // match by address.
+  m_mutationObserverRegistrations.clear();
+  m_intersectionObserverRegistrations.clear();
+  m_resizeObservedElements.clear();
+
 #if DUMP_LEAKS
   if (--runningContexts == 0) {
     JS_FreeRuntime(m_runtime);
@@ -297,14 +315,15 @@ void ExecutionContext::dispatchErrorEventInternal(EventInstance* errorEvent) {
 
 void ExecutionContext::drainPendingPromiseJobs() {
   // should executing pending promise jobs.
-  JSContext* pctx;
-  int finished = JS_ExecutePendingJob(runtime(), &pctx);
-  while (finished != 0) {
-    finished = JS_ExecutePendingJob(runtime(), &pctx);
-    if (finished == -1) {
-      break;
-    }
-  }
+  // Only jobs of this context run, the checkpoint of a page never runs the promise reactions of another one.
+  JS_ExecuteContextPendingJobs(
+      m_ctx,
+      [](JSContext* ctx, void* opaque) {
+        // Jobs catch their own errors, only uncatchable ones such as interrupted scripts are left.
+        JSValue exception = JS_EXCEPTION;
+        static_cast<ExecutionContext*>(opaque)->handleException(&exception);
+      },
+      this);
 
   // Throw error when promise are not handled.
   m_rejectedPromise.process(this);
@@ -419,6 +438,69 @@ DOMTimerCoordinator* ExecutionContext::timers() {
   return &m_timers;
 }
 
+ScriptedIdleTaskController* ExecutionContext::idleTasks() {
+  return &m_idleTasks;
+}
+
+EventLoopScheduler* ExecutionContext::scheduler() {
+  return &m_scheduler;
+}
+
+static void dispatchLifecycleEvent(ExecutionContext* context, std::string eventType) {
+#if ANDROID_32_BIT
+  auto* nativeEvent = new NativeEvent{reinterpret_cast<int64_t>(stringToNativeString(eventType).release())};
+#else
+  auto* nativeEvent = new NativeEvent{stringToNativeString(eventType).release()};
+#endif
+  EventInstance* event = Event::buildEventInstance(eventType, context, nativeEvent, false);
+  event->setTarget(context->document());
+  context->document()->dispatchEvent(event);
+  JS_FreeValue(context->ctx(), event->jsObject);
+}
+
+void ExecutionContext::freeze() {
+  if (m_isFrozen)
+    return;
+
+  // Listeners of the freeze event still run in a page which is not frozen, to save their state.
+  {
+    EventLoopScheduler::TaskScope scope(this, TaskLane::normal);
+    dispatchLifecycleEvent(this, "freeze");
+  }
+
+  m_isFrozen = true;
+  if (m_frozenTasks == nullptr) {
+    m_frozenTasks = std::make_unique<FrozenTaskQueue>();
+  }
+  m_timers.freeze(this);
+}
+
+void ExecutionContext::resume() {
+  if (!m_isFrozen)
+    return;
+  m_isFrozen = false;
+
+  // Queued events are replayed before any held work, posted tasks run when this turn ends.
+  {
+    EventLoopScheduler::TaskScope scope(this, TaskLane::normal);
+    dispatchLifecycleEvent(this, "resume");
+    m_frozenTasks->replay(this);
+  }
+
+  if (!isValid())
+    return;
+
+  // Timers past their deadlines fire at the next wakeup, in order of their deadlines.
+  m_timers.resume(this);
+  m_document->scriptAnimationController()->resume();
+  m_idleTasks.resume(this);
+
+  // UI commands made while frozen were never read by dart.
+  if (m_commandBuffer.size() > 0) {
+    getDartMethod()->requestBatchUpdate(contextId);
+  }
+}
+
 std::unique_ptr<NativeString> jsValueToNativeString(JSContext* ctx, JSValue value) {
   bool isValueString = true;
   if (JS_IsNull(value)) {
@@ -520,6 +602,18 @@ void arrayInsert(JSContext* ctx, JSValue array, uint32_t start, JSValue targetVa
   JS_FreeValue(ctx, result);
 }
 
+void arrayInsertValues(JSContext* ctx, JSValue array, uint32_t start, JSValue* values, uint32_t count) {
+  JSValue spliceMethod = JS_GetPropertyStr(ctx, array, "splice");
+  std::vector<JSValue> arguments;
+  arguments.reserve(count + 2);
+  arguments.emplace_back(JS_NewUint32(ctx, start));
+  arguments.emplace_back(JS_NewUint32(ctx, 0));
+  arguments.insert(arguments.end(), values, values + count);
+  JSValue result = JS_Call(ctx, spliceMethod, array, arguments.size(), arguments.data());
+  JS_FreeValue(ctx, spliceMethod);
+  JS_FreeValue(ctx, result);
+}
+
 int32_t arrayGetLength(JSContext* ctx, JSValue array) {
   JSValue lenVal = JS_GetPropertyStr(ctx, array, "length");
   int32_t len;
@@ -557,6 +651,11 @@ JSValue objectGetKeys(JSContext* ctx, JSValue obj) {
 
 void ExecutionContext::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) {
   m_timers.trace(rt, JS_NULL, mark_func);
+  m_idleTasks.trace(rt, JS_NULL, mark_func);
+  m_scheduler.trace(rt, JS_NULL, mark_func);
+  if (m_frozenTasks != nullptr) {
+    m_frozenTasks->trace(rt, JS_NULL, mark_func);
+  }
 }
 
 }  // namespace kraken::binding::qjs
@@ -17,7 +17,11 @@
 #include <mutex>
 #include <unordered_map>
 #include "bindings/qjs/bom/dom_timer_coordinator.h"
+#include "bindings/qjs/bom/scheduler.h"
+#include "bindings/qjs/bom/scripted_idle_task_controller.h"
+#include "foundation/event_target_id_allocator.h"
 #include "foundation/ui_command_buffer.h"
+#include "frozen_task_queue.h"
 #include "garbage_collected.h"
 #include "js_context_macros.h"
 #include "kraken_foundation.h"
@@ -34,6 +38,14 @@ class WindowInstance;
 class DocumentInstance;
 class ExecutionContext;
 class EventInstance;
+class MutationObserverInstance;
+struct MutationObserverRegistration;
+struct IntersectionObserverRegistration;
+struct ResizeObservedElement;
+class NodeInstance;
+class IntersectionObserverInstance;
+class ResizeObserverInstance;
+class ElementInstance;
 struct DOMTimerCallbackContext;
 
 std::string jsAtomToStdString(JSContext* ctx, JSAtom atom);
@@ -96,9 +108,30 @@ class ExecutionContext {
   // not be used after the ExecutionContext is destroyed.
   DOMTimerCoordinator* timers();
 
+  // Gets the ScriptedIdleTaskController which keeps the callbacks of
+  // requestIdleCallback, owned by the ExecutionContext as well.
+  ScriptedIdleTaskController* idleTasks();
+
+  // Gets the EventLoopScheduler which every entry point from dart runs a turn of.
+  EventLoopScheduler* scheduler();
+
+  // Freezing a page holds its timers, animation frames, idle periods and posted tasks, and queues the events from
+  // dart until it resumes. The document receives a freeze event before, and a resume event after.
+  // https://wicg.github.io/page-lifecycle/
+  void freeze();
+  void resume();
+  FORCE_INLINE bool isFrozen() const { return m_isFrozen; };
+  // Events arrived while the page is frozen, only available when it has been frozen once.
+  FORCE_INLINE FrozenTaskQueue* frozenTasks() { return m_frozenTasks.get(); };
+
   FORCE_INLINE DocumentInstance* document() { return m_document; };
   FORCE_INLINE WindowInstance* window() { return m_window; }
   FORCE_INLINE foundation::UICommandBuffer* uiCommandBuffer() { return &m_commandBuffer; };
+  FORCE_INLINE foundation::EventTargetIdAllocator* eventTargetIds() { return &m_eventTargetIds; };
+  // Mutation points check this before building any MutationRecord.
+  FORCE_INLINE bool hasMutationObservers() const { return !m_mutationObserverRegistrations.empty(); };
+  // Dispatching of intersectionchange events checks this before looking for IntersectionObservers.
+  FORCE_INLINE bool hasIntersectionObservers() const { return !m_intersectionObserverRegistrations.empty(); };
 
   void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func);
 
@@ -137,12 +170,29 @@ class ExecutionContext {
   bool m_inDispatchErrorEvent_{false};
   friend WindowInstance;
   friend DocumentInstance;
+  friend MutationObserverInstance;
+  friend IntersectionObserverInstance;
+  friend ResizeObserverInstance;
   WindowInstance* m_window{nullptr};
   DocumentInstance* m_document{nullptr};
   DOMTimerCoordinator m_timers;
+  ScriptedIdleTaskController m_idleTasks;
+  EventLoopScheduler m_scheduler;
+  bool m_isFrozen{false};
+  std::unique_ptr<FrozenTaskQueue> m_frozenTasks;
   ExecutionContextGCTracker* m_gcTracker{nullptr};
   foundation::UICommandBuffer m_commandBuffer{contextId};
+  foundation::EventTargetIdAllocator m_eventTargetIds;
   RejectedPromises m_rejectedPromise;
+  // Registrations of the nodes observed by MutationObservers, only nodes flagged IsObserved have an entry. Kept here
+  // as observers may outlive the document on teardown.
+  std::unordered_map<const NodeInstance*, std::vector<MutationObserverRegistration>> m_mutationObserverRegistrations;
+  // Registrations of the elements observed by IntersectionObservers, only elements flagged IsIntersectionObserved have
+  // an entry.
+  std::unordered_map<const ElementInstance*, std::vector<IntersectionObserverRegistration>> m_intersectionObserverRegistrations;
+  // Elements observed by ResizeObservers with their registrations, by eventTargetId to resolve the sizes reported by
+  // dart. Only elements flagged IsResizeObserved have an entry.
+  std::unordered_map<int32_t, ResizeObservedElement> m_resizeObservedElements;
 };
 
 // The read object's method or properties via Proxy, we should redirect this_val from Proxy into target property of
@@ -276,6 +326,7 @@ std::string jsAtomToStdString(JSContext* ctx, JSAtom atom);
 // JS array operation utilities.
 void arrayPushValue(JSContext* ctx, JSValue array, JSValue val);
 void arrayInsert(JSContext* ctx, JSValue array, uint32_t start, JSValue targetValue);
+void arrayInsertValues(JSContext* ctx, JSValue array, uint32_t start, JSValue* values, uint32_t count);
 int32_t arrayGetLength(JSContext* ctx, JSValue array);
 int32_t arrayFindIdx(JSContext* ctx, JSValue array, JSValue target);
 void arraySpliceValue(JSContext* ctx, JSValue array, uint32_t start, uint32_t deleteCount);
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "frozen_task_queue.h"
+#include <cstring>
+#include "bindings/qjs/dom/event.h"
+#include "bindings/qjs/dom/event_target.h"
+#include "page.h"
+
+namespace kraken::binding::qjs {
+
+FrozenTaskQueue::~FrozenTaskQueue() {
+  for (auto& task : m_pendingTasks) {
+    freeTask(task);
+  }
+}
+
+void FrozenTaskQueue::freeTask(PendingTask& task) {
+  JSRuntime* rt = ExecutionContext::runtime();
+  delete task.latest;
+  for (NativeEvent* nativeEvent : task.coalesced) {
+    delete nativeEvent;
+  }
+  if (task.target != nullptr) {
+    JS_FreeAtomRT(rt, task.eventType);
+    JS_FreeValueRT(rt, task.target->jsObject);
+  }
+  if (task.moduleName != nullptr) {
+    task.moduleName->free();
+    delete task.moduleName;
+  }
+  if (task.extra != nullptr) {
+    task.extra->free();
+    delete task.extra;
+  }
+}
+
+void FrozenTaskQueue::enqueueEvent(ExecutionContext* context, EventTargetInstance* target, NativeEvent* nativeEvent, bool isCustomEvent) {
+  JSContext* ctx = context->ctx();
+#if ANDROID_32_BIT
+  auto* pType = reinterpret_cast<NativeString*>(nativeEvent->type);
+#else
+  auto* pType = nativeEvent->type;
+#endif
+  JSValue eventTypeValue = JS_NewUnicodeString(ExecutionContext::runtime(), ctx, pType->string, pType->length);
+  JSAtom eventType = JS_ValueToAtom(ctx, eventTypeValue);
+  JS_FreeValue(ctx, eventTypeValue);
+
+  // Only a repeat of the last event is coalesced, an event never replays ahead of one which arrived before it.
+  if (!m_pendingTasks.empty()) {
+    PendingTask& task = m_pendingTasks.back();
+    if (task.target == target && task.eventType == eventType) {
+      task.coalesced.push_back(task.latest);
+      task.latest = nativeEvent;
+      JS_FreeAtom(ctx, eventType);
+      return;
+    }
+  }
+
+  // Keep target alive until the event is dispatched.
+  JS_DupValue(ctx, target->jsObject);
+  m_pendingTasks.push_back({target, eventType, isCustomEvent, nativeEvent, {}, nullptr, "", nullptr});
+}
+
+void FrozenTaskQueue::enqueueModuleEvent(NativeString* moduleName, const char* eventType, NativeEvent* nativeEvent, NativeString* extra) {
+  std::string moduleEventType = eventType == nullptr ? "" : eventType;
+  NativeString* extraCopy = extra == nullptr ? nullptr : extra->clone();
+
+  if (!m_pendingTasks.empty()) {
+    PendingTask& task = m_pendingTasks.back();
+    if (task.target == nullptr && task.moduleEventType == moduleEventType && task.moduleName->length == moduleName->length &&
+        memcmp(task.moduleName->string, moduleName->string, moduleName->length * sizeof(uint16_t)) == 0) {
+      // Listeners of module events only need the latest state, earlier events are dropped.
+      delete task.latest;
+      task.latest = nativeEvent;
+      if (task.extra != nullptr) {
+        task.extra->free();
+        delete task.extra;
+      }
+      task.extra = extraCopy;
+      return;
+    }
+  }
+
+  m_pendingTasks.push_back({nullptr, JS_ATOM_NULL, false, nativeEvent, {}, moduleName->clone(), moduleEventType, extraCopy});
+}
+
+void FrozenTaskQueue::replay(ExecutionContext* context) {
+  if (m_pendingTasks.empty())
+    return;
+
+  std::vector<PendingTask> pendingTasks;
+  pendingTasks.swap(m_pendingTasks);
+
+  JSContext* ctx = context->ctx();
+  for (auto& task : pendingTasks) {
+    // Listeners may have disposed the page, the tasks left are dropped.
+    if (!context->isValid()) {
+      freeTask(task);
+      continue;
+    }
+
+    if (task.target != nullptr) {
+#if ANDROID_32_BIT
+      auto* pType = reinterpret_cast<NativeString*>(task.latest->type);
+#else
+      auto* pType = task.latest->type;
+#endif
+      EventInstance* event = Event::buildEventInstance(pType, context, task.latest, task.isCustomEvent);
+      event->setTarget(task.target);
+      event->setCoalescedNativeEvents(std::move(task.coalesced), task.isCustomEvent);
+      task.target->dispatchEvent(event);
+      JS_FreeValue(ctx, event->jsObject);
+    } else {
+      RawEvent rawEvent{reinterpret_cast<uint64_t*>(task.latest), 0};
+      auto* page = static_cast<KrakenPage*>(context->getOwner());
+      page->invokeModuleEvent(task.moduleName, task.moduleEventType.empty() ? nullptr : task.moduleEventType.c_str(), task.latest == nullptr ? nullptr : &rawEvent, task.extra);
+    }
+
+    // The event instances own the native events now.
+    task.latest = nullptr;
+    task.coalesced.clear();
+    freeTask(task);
+
+    // Executing pending async jobs, each event is a task of its own.
+    context->drainPendingPromiseJobs();
+  }
+}
+
+void FrozenTaskQueue::trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const {
+  for (auto& task : m_pendingTasks) {
+    if (task.target != nullptr) {
+      JS_MarkValue(rt, task.target->jsObject, mark_func);
+    }
+  }
+}
+
+}  // namespace kraken::binding::qjs
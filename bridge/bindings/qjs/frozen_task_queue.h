@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_BINDINGS_QJS_FROZEN_TASK_QUEUE_H_
+#define KRAKENBRIDGE_BINDINGS_QJS_FROZEN_TASK_QUEUE_H_
+
+#include <quickjs/quickjs.h>
+#include <string>
+#include <vector>
+
+struct NativeString;
+
+namespace kraken::binding::qjs {
+
+class ExecutionContext;
+class EventTargetInstance;
+struct NativeEvent;
+
+// Events from dart which arrive while the page is frozen, replayed in the order they arrived when it resumes.
+// Repeats of the last queued event are coalesced, only the latest one of a run of the same target and type is
+// dispatched, earlier DOM events are exposed by event.getCoalescedEvents().
+class FrozenTaskQueue {
+ public:
+  ~FrozenTaskQueue();
+
+  // Take over the native event until the page resumes.
+  void enqueueEvent(ExecutionContext* context, EventTargetInstance* target, NativeEvent* nativeEvent, bool isCustomEvent);
+  // Module events keep a copy of their module name and extra data, dart frees them once the call returns.
+  void enqueueModuleEvent(NativeString* moduleName, const char* eventType, NativeEvent* nativeEvent, NativeString* extra);
+  // Dispatch all pending events, events arrived during the replay go to a page which is not frozen any more.
+  void replay(ExecutionContext* context);
+
+  void trace(JSRuntime* rt, JSValue val, JS_MarkFunc* mark_func) const;
+
+ private:
+  struct PendingTask {
+    // Target of DOM events, nullptr for module events.
+    EventTargetInstance* target;
+    JSAtom eventType;
+    bool isCustomEvent;
+    NativeEvent* latest;
+    std::vector<NativeEvent*> coalesced;
+    NativeString* moduleName;
+    std::string moduleEventType;
+    NativeString* extra;
+  };
+
+  static void freeTask(PendingTask& task);
+
+  std::vector<PendingTask> m_pendingTasks;
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_BINDINGS_QJS_FROZEN_TASK_QUEUE_H_
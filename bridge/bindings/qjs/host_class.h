@@ -41,11 +41,13 @@ class HostClass {
     ///  };
     ///  JS_NewClass(runtime, sampleId, &def);
     ///  JSValue jsObject = JS_NewObjectClass(ctx, sampleId);
-    JSClassDef def{};
-    def.class_name = "HostClass";
-    def.finalizer = proxyFinalize;
-    def.call = proxyCall;
-    JS_NewClass(context->runtime(), ExecutionContext::kHostClassClassId, &def);
+    if (!JS_HasClassId(context->runtime(), ExecutionContext::kHostClassClassId)) {
+      JSClassDef def{};
+      def.class_name = "HostClass";
+      def.finalizer = proxyFinalize;
+      def.call = proxyCall;
+      JS_NewClass(context->runtime(), ExecutionContext::kHostClassClassId, &def);
+    }
     jsObject = JS_NewObjectClass(context->ctx(), ExecutionContext::kHostClassClassId);
     m_prototypeObject = JS_NewObject(m_ctx);
 
@@ -105,14 +107,17 @@ class HostClass {
 
 class Instance {
  public:
-  explicit Instance(HostClass* hostClass, std::string name, JSClassExoticMethods* exotic, JSClassID classId, JSClassFinalizer finalizer)
-      : m_context(hostClass->context()), m_hostClass(hostClass), m_name(std::move(name)), m_ctx(m_context->ctx()), m_contextId(hostClass->contextId()) {
-    JSClassDef def{};
-    def.class_name = m_name.c_str();
-    def.finalizer = finalizer;
-    def.exotic = exotic;
-    def.gc_mark = proxyGCMark;
-    int32_t success = JS_NewClass(m_context->runtime(), classId, &def);
+  explicit Instance(HostClass* hostClass, const char* name, JSClassExoticMethods* exotic, JSClassID classId, JSClassFinalizer finalizer)
+      : m_context(hostClass->context()), m_hostClass(hostClass), m_ctx(m_context->ctx()), m_contextId(hostClass->contextId()) {
+    // JSClassDef are shared by all instances of the same class in the runtime, only the first instance needs to register it.
+    if (!JS_HasClassId(m_context->runtime(), classId)) {
+      JSClassDef def{};
+      def.class_name = name;
+      def.finalizer = finalizer;
+      def.exotic = exotic;
+      def.gc_mark = proxyGCMark;
+      JS_NewClass(m_context->runtime(), classId, &def);
+    }
     jsObject = JS_NewObjectProtoClass(m_ctx, hostClass->m_prototypeObject, classId);
     JS_SetOpaque(jsObject, this);
   };
@@ -121,7 +126,6 @@ class Instance {
 
   inline HostClass* prototype() const { return m_hostClass; }
   inline ExecutionContext* context() const { return m_context; }
-  inline std::string name() const { return m_name; }
 
  private:
   static void proxyGCMark(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func) {
@@ -137,7 +141,6 @@ class Instance {
   ExecutionContext* m_context{nullptr};
   JSContext* m_ctx{nullptr};
   HostClass* m_hostClass{nullptr};
-  std::string m_name;
   int64_t m_contextId{-1};
 
   friend HostClass;
@@ -51,6 +51,7 @@ class ExoticHostObject {
     def.class_name = m_name.c_str();
     def.finalizer = proxyFinalize;
     def.exotic = m_exoticMethods;
+    def.gc_mark = proxyGCMark;
     JS_NewClass(context->runtime(), ExecutionContext::kHostExoticObjectClassId, &def);
     jsObject = JS_NewObjectClass(m_ctx, ExecutionContext::kHostExoticObjectClassId);
     JS_SetOpaque(jsObject, this);
@@ -72,6 +73,8 @@ class ExoticHostObject {
 
  protected:
   virtual ~ExoticHostObject() = default;
+  // Tell GC the JSValues kept by subclass.
+  virtual void trace(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func){};
   std::string m_name;
   ExecutionContext* m_context;
   int32_t m_contextId;
@@ -81,6 +84,10 @@ class ExoticHostObject {
     auto hostObject = static_cast<ExoticHostObject*>(JS_GetOpaque(val, ExecutionContext::kHostExoticObjectClassId));
     delete hostObject;
   };
+  static void proxyGCMark(JSRuntime* rt, JSValueConst val, JS_MarkFunc* mark_func) {
+    auto hostObject = static_cast<ExoticHostObject*>(JS_GetOpaque(val, ExecutionContext::kHostExoticObjectClassId));
+    hostObject->trace(rt, val, mark_func);
+  };
 };
 
 }  // namespace kraken::binding::qjs
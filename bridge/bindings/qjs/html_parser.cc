@@ -28,25 +28,19 @@ void HTMLParser::traverseHTML(NodeInstance* root, GumboNode* node) {
     auto* child = (GumboNode*)children->data[i];
 
     if (child->type == GUMBO_NODE_ELEMENT) {
-      std::string tagName;
+      ElementInstance* newElementInstance;
       if (child->v.element.tag != GUMBO_TAG_UNKNOWN) {
-        tagName = gumbo_normalized_tagname(child->v.element.tag);
+        newElementInstance = Document::createElementByGumboTag(context, child->v.element.tag);
       } else {
         GumboStringPiece piece = child->v.element.original_tag;
         gumbo_tag_from_original_text(&piece);
-        tagName = std::string(piece.data, piece.length);
+        newElementInstance = Document::createElementByTagName(context, std::string(piece.data, piece.length));
       }
 
-      auto* Document = Document::instance(context);
-      JSValue constructor = Document->getElementConstructor(context, tagName);
-
-      JSValue tagNameValue = JS_NewString(ctx, tagName.c_str());
-      JSValue argv[] = {tagNameValue};
-      JSValue newElementValue = JS_CallConstructor(ctx, constructor, 1, argv);
-      JS_FreeValue(ctx, tagNameValue);
-      auto* newElementInstance = static_cast<ElementInstance*>(JS_GetOpaque(newElementValue, Element::classId()));
-      root->internalAppendChild(newElementInstance);
+      // Attributes are set before insertion, like elements created from script, so observers of the tree only
+      // see the childList record and attribute records keep going through internalSetAttribute.
       parseProperty(newElementInstance, &child->v.element);
+      root->internalAppendChild(newElementInstance);
 
       // eval javascript when <script>//code...</script>.
       if (child->v.element.children.length > 0) {
@@ -58,7 +52,7 @@ void HTMLParser::traverseHTML(NodeInstance* root, GumboNode* node) {
         }
       }
 
-      JS_FreeValue(ctx, newElementValue);
+      JS_FreeValue(ctx, newElementInstance->jsObject);
     } else if (child->type == GUMBO_NODE_TEXT) {
       JSValue textContentValue = JS_NewString(ctx, child->v.text.text);
       JSValue argv[] = {textContentValue};
@@ -115,7 +109,7 @@ void HTMLParser::parseProperty(ElementInstance* element, GumboElement* gumboElem
       }
       arrStyles.push_back(strStyles.substr(prev_pos, pos - prev_pos));
 
-      auto* style = element->style();
+      auto* style = element->ensureStyle();
 
       for (auto& s : arrStyles) {
         std::string::size_type position = s.find(':');
@@ -134,20 +128,9 @@ void HTMLParser::parseProperty(ElementInstance* element, GumboElement* gumboElem
 
     } else {
       std::string strName = attribute->name;
-      std::string strValue = attribute->value;
-
-      JSValue key = JS_NewString(ctx, strName.c_str());
-      JSValue value = JS_NewString(ctx, strValue.c_str());
-
-      JSValue setAttributeFunc = JS_GetPropertyStr(ctx, element->jsObject, "setAttribute");
-      JSValue arguments[] = {key, value};
-
-      JSValue returnValue = JS_Call(ctx, setAttributeFunc, element->jsObject, 2, arguments);
-      context->drainPendingPromiseJobs();
+      JSValue value = JS_NewString(ctx, attribute->value);
+      JSValue returnValue = element->internalSetAttribute(strName, value);
       context->handleException(&returnValue);
-
-      JS_FreeValue(ctx, setAttributeFunc);
-      JS_FreeValue(ctx, key);
       JS_FreeValue(ctx, value);
     }
   }
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "html_serializer.h"
+#include <cstring>
+#include "dom/elements/template_element.h"
+#include "qjs_patch.h"
+
+namespace kraken::binding::qjs {
+
+// Children of these elements are serialized as it is, without escaping.
+static bool isRawTextElement(const std::string& tagName) {
+  return tagName == "script" || tagName == "style" || tagName == "xmp" || tagName == "iframe" || tagName == "noembed" || tagName == "noframes" || tagName == "plaintext";
+}
+
+JSValue HTMLSerializer::innerHTML(ElementInstance* element) {
+  HTMLSerializer serializer(element->context()->ctx());
+  serializer.serializeChildren(element);
+  return serializer.toQuickJS();
+}
+
+JSValue HTMLSerializer::outerHTML(ElementInstance* element) {
+  HTMLSerializer serializer(element->context()->ctx());
+  serializer.serializeElement(element);
+  return serializer.toQuickJS();
+}
+
+JSValue HTMLSerializer::textContent(NodeInstance* node) {
+  HTMLSerializer serializer(node->context()->ctx());
+  serializer.collectTextContent(node);
+  return serializer.toQuickJS();
+}
+
+void HTMLSerializer::serializeElement(ElementInstance* element) {
+  const std::string& tagName = element->m_tagName;
+
+  appendASCII("<");
+  appendUTF8(tagName, false, false);
+
+  for (auto& attribute : element->attributes()->m_attributes) {
+    appendASCII(" ");
+    appendUTF8(attribute.first, false, false);
+    appendASCII("=\"");
+    appendString(attribute.second, true);
+    appendASCII("\"");
+  }
+
+  StyleDeclarationInstance* style = element->style();
+  if (style != nullptr && !style->properties.empty()) {
+    appendASCII(" style=\"");
+    for (auto& property : style->properties) {
+      appendUTF8(property.first, true, true);
+      appendASCII(": ");
+      appendUTF8(property.second, true, true);
+      appendASCII(";");
+    }
+    appendASCII("\"");
+  }
+
+  appendASCII(">");
+  serializeChildren(element);
+  appendASCII("</");
+  appendUTF8(tagName, false, false);
+  appendASCII(">");
+}
+
+void HTMLSerializer::serializeChildren(ElementInstance* element) {
+  // If Element is TemplateElement, the innerHTML content is the content of documentFragment.
+  NodeInstance* parent = element;
+  if (element->hasNodeFlag(NodeInstance::NodeFlag::IsTemplateElement)) {
+    parent = static_cast<TemplateElementInstance*>(element)->content();
+  }
+
+  // Resolved at the first text child, most elements only contain elements.
+  int escape = -1;
+  parent->forEachChild([this, element, &escape](NodeInstance* node) {
+    if (node->nodeType == NodeType::ELEMENT_NODE) {
+      serializeElement(static_cast<ElementInstance*>(node));
+    } else if (node->nodeType == NodeType::TEXT_NODE) {
+      if (escape == -1) {
+        escape = !isRawTextElement(element->m_tagName);
+      }
+      appendUTF8(static_cast<TextNodeInstance*>(node)->m_data, escape, false);
+    }
+  });
+}
+
+void HTMLSerializer::collectTextContent(NodeInstance* node) {
+  if (node->nodeType == NodeType::TEXT_NODE) {
+    appendUTF8(static_cast<TextNodeInstance*>(node)->m_data, false, false);
+  } else if (node->nodeType == NodeType::ELEMENT_NODE) {
+    node->forEachChild([this](NodeInstance* child) { collectTextContent(child); });
+  }
+}
+
+static inline bool shouldEscape(uint32_t c, bool inAttribute) {
+  return c == '&' || c == 0xA0 || (inAttribute ? c == '"' : (c == '<' || c == '>'));
+}
+
+void HTMLSerializer::appendASCII(const char* string) {
+  m_buffer.insert(m_buffer.end(), string, string + strlen(string));
+}
+
+void HTMLSerializer::appendEscaped(char16_t c, bool inAttribute) {
+  switch (c) {
+    case '&':
+      appendASCII("&amp;");
+      break;
+    case 0xA0:
+      appendASCII("&nbsp;");
+      break;
+    case '"':
+      appendASCII("&quot;");
+      break;
+    case '<':
+      appendASCII("&lt;");
+      break;
+    case '>':
+      appendASCII("&gt;");
+      break;
+    default:
+      m_buffer.push_back(c);
+      break;
+  }
+}
+
+void HTMLSerializer::appendUTF8(const std::string& string, bool escape, bool inAttribute) {
+  auto* p = reinterpret_cast<const uint8_t*>(string.data());
+  const uint8_t* end = p + string.size();
+
+  while (p < end) {
+    // Copy runs of ASCII characters which need no escaping at once.
+    const uint8_t* run = p;
+    while (p < end && *p < 0x80 && !(escape && shouldEscape(*p, inAttribute))) {
+      p++;
+    }
+    m_buffer.insert(m_buffer.end(), run, p);
+    if (p == end)
+      break;
+    if (*p < 0x80) {
+      appendEscaped(*p++, inAttribute);
+      continue;
+    }
+
+    uint32_t c = *p++;
+    int continuationBytes = 0;
+    if (c >= 0xF8) {
+      c = 0xFFFD;
+    } else if (c >= 0xF0) {
+      c &= 0x07;
+      continuationBytes = 3;
+    } else if (c >= 0xE0) {
+      c &= 0x0F;
+      continuationBytes = 2;
+    } else if (c >= 0xC0) {
+      c &= 0x1F;
+      continuationBytes = 1;
+    } else {
+      // Stray continuation byte.
+      c = 0xFFFD;
+    }
+
+    for (; continuationBytes > 0; continuationBytes--) {
+      if (p == end || (*p & 0xC0) != 0x80) {
+        c = 0xFFFD;
+        break;
+      }
+      c = (c << 6) | (*p++ & 0x3F);
+    }
+
+    if (c >= 0x10000) {
+      c -= 0x10000;
+      m_buffer.push_back(static_cast<char16_t>(0xD800 + (c >> 10)));
+      m_buffer.push_back(static_cast<char16_t>(0xDC00 + (c & 0x3FF)));
+    } else if (escape && shouldEscape(c, inAttribute)) {
+      appendEscaped(static_cast<char16_t>(c), inAttribute);
+    } else {
+      m_buffer.push_back(static_cast<char16_t>(c));
+    }
+  }
+}
+
+template <typename CharType>
+void HTMLSerializer::appendEscapedCodeUnits(const CharType* p, const CharType* end, bool inAttribute) {
+  while (p < end) {
+    const CharType* run = p;
+    while (p < end && !shouldEscape(*p, inAttribute)) {
+      p++;
+    }
+    m_buffer.insert(m_buffer.end(), run, p);
+    if (p == end)
+      break;
+    appendEscaped(*p++, inAttribute);
+  }
+}
+
+void HTMLSerializer::appendString(JSValue string, bool inAttribute) {
+  // Attribute values are converted to strings when they are set, serializing never calls into scripts while
+  // children are visited in place.
+  if (!JS_IsString(string))
+    return;
+
+  JSString* p = JS_VALUE_GET_STRING(string);
+  if (p->is_wide_char) {
+    appendEscapedCodeUnits(p->u.str16, p->u.str16 + p->len, inAttribute);
+  } else {
+    appendEscapedCodeUnits(p->u.str8, p->u.str8 + p->len, inAttribute);
+  }
+}
+
+JSValue HTMLSerializer::toQuickJS() {
+  return JS_NewUnicodeString(JS_GetRuntime(m_ctx), m_ctx, reinterpret_cast<const uint16_t*>(m_buffer.data()), m_buffer.size());
+}
+
+}  // namespace kraken::binding::qjs
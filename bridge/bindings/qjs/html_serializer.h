@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_HTML_SERIALIZER_H
+#define KRAKENBRIDGE_HTML_SERIALIZER_H
+
+#include <string>
+#include <vector>
+#include "bindings/qjs/dom/element.h"
+#include "bindings/qjs/dom/text_node.h"
+
+namespace kraken::binding::qjs {
+
+// Serialize a DOM subtree in one walk into a single growable UTF-16 buffer, which becomes one JSString at the end.
+class HTMLSerializer {
+ public:
+  static JSValue innerHTML(ElementInstance* element);
+  static JSValue outerHTML(ElementInstance* element);
+  static JSValue textContent(NodeInstance* node);
+
+ private:
+  explicit HTMLSerializer(JSContext* ctx) : m_ctx(ctx){};
+
+  void serializeElement(ElementInstance* element);
+  void serializeChildren(ElementInstance* element);
+  void collectTextContent(NodeInstance* node);
+
+  void appendASCII(const char* string);
+  void appendUTF8(const std::string& string, bool escape, bool inAttribute);
+  void appendString(JSValue string, bool inAttribute);
+  void appendEscaped(char16_t c, bool inAttribute);
+  template <typename CharType>
+  void appendEscapedCodeUnits(const CharType* p, const CharType* end, bool inAttribute);
+
+  JSValue toQuickJS();
+
+  JSContext* m_ctx;
+  std::vector<char16_t> m_buffer;
+};
+
+}  // namespace kraken::binding::qjs
+
+#endif  // KRAKENBRIDGE_HTML_SERIALIZER_H
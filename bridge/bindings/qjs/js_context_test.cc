@@ -3,6 +3,7 @@
  * Author: Kraken Team.
  */
 
+#include "bindings/qjs/dom/element.h"
 #include "gtest/gtest.h"
 #include "kraken_test_env.h"
 #include "page.h"
@@ -258,6 +259,110 @@ TEST(Context, unrejectPromiseErrorWithMultipleContext) {
   EXPECT_EQ(errorCalledCount, 4);
 }
 
+static bool globalFlag(ExecutionContext* context, const char* name) {
+  JSValue value = JS_GetPropertyStr(context->ctx(), context->global(), name);
+  bool flag = JS_ToBool(context->ctx(), value);
+  JS_FreeValue(context->ctx(), value);
+  return flag;
+}
+
+TEST(Context, drainPendingJobsOfOwnContext) {
+  auto bridge = TEST_init();
+  auto bridge2 = TEST_allocateNewPage();
+  auto* context = bridge->getContext();
+  auto* context2 = bridge2->getContext();
+
+  // Queue promise reactions in both pages without a checkpoint.
+  const char* code = "var reacted = false; Promise.resolve().then(() => { reacted = true; });";
+  JS_FreeValue(context->ctx(), JS_Eval(context->ctx(), code, strlen(code), "vm://", JS_EVAL_TYPE_GLOBAL));
+  JS_FreeValue(context2->ctx(), JS_Eval(context2->ctx(), code, strlen(code), "vm://", JS_EVAL_TYPE_GLOBAL));
+
+  context->drainPendingPromiseJobs();
+  EXPECT_EQ(globalFlag(context, "reacted"), true);
+  EXPECT_EQ(globalFlag(context2, "reacted"), false);
+
+  context2->drainPendingPromiseJobs();
+  EXPECT_EQ(globalFlag(context2, "reacted"), true);
+
+  // Jobs run in queue order, jobs queued while draining run after the ones already pending.
+  const char* orderCode =
+      "var order = [];"
+      "Promise.resolve().then(() => { order.push(1); Promise.resolve().then(() => order.push(3)); });"
+      "Promise.resolve().then(() => order.push(2));";
+  JS_FreeValue(context->ctx(), JS_Eval(context->ctx(), orderCode, strlen(orderCode), "vm://", JS_EVAL_TYPE_GLOBAL));
+  JS_FreeValue(context2->ctx(), JS_Eval(context2->ctx(), code, strlen(code), "vm://", JS_EVAL_TYPE_GLOBAL));
+  context->drainPendingPromiseJobs();
+  JSValue order = JS_Eval(context->ctx(), "order.join()", 12, "vm://", JS_EVAL_TYPE_GLOBAL);
+  const char* orderString = JS_ToCString(context->ctx(), order);
+  EXPECT_STREQ(orderString, "1,2,3");
+  JS_FreeCString(context->ctx(), orderString);
+  JS_FreeValue(context->ctx(), order);
+  EXPECT_EQ(globalFlag(context2, "reacted"), false);
+  context2->drainPendingPromiseJobs();
+
+  // Jobs of a disposed page are dropped with it, other pages never run them.
+  JS_FreeValue(context2->ctx(), JS_Eval(context2->ctx(), code, strlen(code), "vm://", JS_EVAL_TYPE_GLOBAL));
+  bridge2.reset();
+  context->drainPendingPromiseJobs();
+}
+
+TEST(Context, freezeHoldsWorkUntilResume) {
+  bool static errorCalled = false;
+  static std::vector<std::string> logs;
+  auto bridge = TEST_init([](int32_t contextId, const char* errmsg) {
+    KRAKEN_LOG(VERBOSE) << errmsg;
+    errorCalled = true;
+  });
+  auto* context = bridge->getContext();
+  int32_t contextId = context->getContextId();
+
+  kraken::KrakenPage::consoleMessageHandler = [](void* ctx, const std::string& message, int logLevel) { logs.emplace_back(message); };
+
+  std::string code = R"(
+let logs = [];
+document.addEventListener('freeze', () => logs.push('freeze'));
+document.addEventListener('resume', () => logs.push('resume'));
+__kraken_module_listener__((moduleName, event, extra) => logs.push(moduleName + ':' + extra));
+var target = document.createElement('div');
+target.addEventListener('click', (event) => logs.push('click' + event.getCoalescedEvents().length));
+target.addEventListener('keydown', () => logs.push('keydown'));
+setTimeout(() => logs.push('timeout'));
+requestAnimationFrame(() => logs.push('frame'));
+)";
+  bridge->evaluateScript(code.c_str(), code.size(), "vm://", 0);
+
+  freezePage(contextId);
+  JSValue target = JS_GetPropertyStr(context->ctx(), context->global(), "target");
+  auto* targetInstance = static_cast<EventTargetInstance*>(JS_GetOpaque(target, Element::classId()));
+  TEST_dispatchEvent(contextId, targetInstance, "click");
+  TEST_dispatchEvent(contextId, targetInstance, "click");
+  // Events replay in the order they arrived, only repeats of the last one are coalesced.
+  TEST_dispatchEvent(contextId, targetInstance, "keydown");
+  TEST_dispatchEvent(contextId, targetInstance, "click");
+  JS_FreeValue(context->ctx(), target);
+  std::unique_ptr<NativeString> moduleName = stringToNativeString("Connection");
+  std::unique_ptr<NativeString> extra = stringToNativeString("1");
+  bridge->invokeModuleEvent(moduleName.get(), nullptr, nullptr, extra.get());
+  extra = stringToNativeString("2");
+  bridge->invokeModuleEvent(moduleName.get(), nullptr, nullptr, extra.get());
+  TEST_runLoop(context);
+
+  // Dart reads no UI commands of a frozen page.
+  EXPECT_EQ(getUICommandItemSize(contextId), 0);
+  std::string check = "console.log(logs.join(' '));";
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  resumePage(contextId);
+  EXPECT_GT(getUICommandItemSize(contextId), 0);
+  TEST_runLoop(context);
+  bridge->evaluateScript(check.c_str(), check.size(), "vm://", 0);
+
+  EXPECT_EQ(errorCalled, false);
+  EXPECT_EQ(logs.size(), 2);
+  EXPECT_STREQ(logs[0].c_str(), "freeze");
+  EXPECT_STREQ(logs[1].c_str(), "freeze resume click1 keydown click0 Connection:2 timeout frame");
+}
+
 TEST(Context, accessGetUICommandItemsAfterDisposed) {
   int32_t contextId;
   {
@@ -50,6 +50,7 @@ void handleInvokeModuleTransientCallback(void* callbackContext, int32_t contextI
     return;
   }
 
+  EventLoopScheduler::TaskScope scope(context, TaskLane::normal);
   JSValue callback = moduleContext->callback;
   JSValue returnValue;
   if (errmsg != nullptr) {
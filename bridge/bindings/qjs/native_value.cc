@@ -126,7 +126,7 @@ NativeValue jsValueToNativeValue(JSContext* ctx, JSValue& value) {
     auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(ctx));
     if (JS_IsInstanceOf(ctx, value, ImageElement::instance(context)->jsObject)) {
       auto* imageElementInstance = static_cast<ImageElementInstance*>(JS_GetOpaque(value, Element::classId()));
-      return Native_NewPtr(JSPointerType::NativeEventTarget, imageElementInstance->nativeEventTarget);
+      return Native_NewPtr(JSPointerType::NativeEventTarget, &imageElementInstance->nativeEventTarget);
     }
 
     return Native_NewJSON(context, value);
@@ -105,8 +105,9 @@ struct JSRuntime {
   struct list_head string_list; /* list of JSString.link */
 #endif
   /* stack limitation */
-  const uint8_t* stack_top;
-  size_t stack_size; /* in bytes */
+  uintptr_t stack_size; /* in bytes, 0 if no limit */
+  uintptr_t stack_top;
+  uintptr_t stack_limit; /* lower stack limit */
 
   JSValue current_exception;
   /* true if inside an out of memory error, to avoid recursing */
@@ -152,6 +153,14 @@ typedef struct JSRegExp {
 
 typedef struct JSString JSString;
 
+typedef struct JSJobEntry {
+  struct list_head link;
+  JSContext* ctx;
+  JSJobFunc* job_func;
+  int argc;
+  JSValue argv[0];
+} JSJobEntry;
+
 struct JSObject {
   union {
     JSGCObjectHeader header;
@@ -330,3 +339,64 @@ JSValue JS_GetProxyTarget(JSValue value) {
   JSObject* p = JS_VALUE_GET_OBJ(value);
   return p->u.proxy_data->target;
 }
+
+bool JS_GetFastArray(JSValue array, JSValue** values, uint32_t* count) {
+  if (JS_VALUE_GET_TAG(array) != JS_TAG_OBJECT)
+    return false;
+  JSObject* p = JS_VALUE_GET_OBJ(array);
+  if (p->class_id != JS_CLASS_ARRAY || !p->fast_array)
+    return false;
+  *values = p->u.array.u.values;
+  *count = p->u.array.count;
+  return true;
+}
+
+// Pages share one runtime, jobs queued by other contexts are left in place for their own checkpoints.
+// Jobs of ctx are moved to the jobs list in one pass, keeping their order.
+static void takeContextPendingJobs(JSContext* ctx, struct list_head* jobs) {
+  JSRuntime* rt = JS_GetRuntime(ctx);
+  struct list_head *el, *el1;
+  list_for_each_safe(el, el1, &rt->job_list) {
+    auto* e = list_entry(el, JSJobEntry, link);
+    if (e->ctx == ctx) {
+      list_del(&e->link);
+      list_add_tail(&e->link, jobs);
+    }
+  }
+}
+
+void JS_ExecuteContextPendingJobs(JSContext* ctx, void (*onException)(JSContext* ctx, void* opaque), void* opaque) {
+  struct list_head jobs;
+  init_list_head(&jobs);
+  takeContextPendingJobs(ctx, &jobs);
+
+  while (!list_empty(&jobs)) {
+    auto* e = list_entry(jobs.next, JSJobEntry, link);
+    list_del(&e->link);
+    JSValue res = e->job_func(e->ctx, e->argc, (JSValueConst*)e->argv);
+    for (int i = 0; i < e->argc; i++)
+      JS_FreeValue(ctx, e->argv[i]);
+    js_free(ctx, e);
+    if (JS_IsException(res))
+      onException(ctx, opaque);
+    JS_FreeValue(ctx, res);
+
+    // Jobs queued by the taken ones are appended to the runtime list, they run after all the taken jobs.
+    if (list_empty(&jobs))
+      takeContextPendingJobs(ctx, &jobs);
+  }
+}
+
+void JS_FreeContextPendingJobs(JSContext* ctx) {
+  struct list_head jobs;
+  init_list_head(&jobs);
+  takeContextPendingJobs(ctx, &jobs);
+
+  struct list_head *el, *el1;
+  list_for_each_safe(el, el1, &jobs) {
+    auto* e = list_entry(el, JSJobEntry, link);
+    for (int i = 0; i < e->argc; i++)
+      JS_FreeValue(ctx, e->argv[i]);
+    js_free(ctx, e);
+  }
+}
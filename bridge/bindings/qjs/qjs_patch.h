@@ -105,6 +105,12 @@ JSClassID JSValueGetClassId(JSValue);
 bool JS_IsProxy(JSValue value);
 bool JS_HasClassId(JSRuntime* runtime, JSClassID classId);
 JSValue JS_GetProxyTarget(JSValue value);
+// Borrow the element storage of a fast array, return false if the array is not a fast array.
+bool JS_GetFastArray(JSValue array, JSValue** values, uint32_t* count);
+// Execute the pending jobs queued by ctx until none is left, onException is called for each job which threw.
+void JS_ExecuteContextPendingJobs(JSContext* ctx, void (*onException)(JSContext* ctx, void* opaque), void* opaque);
+// Drop the pending jobs of a context being disposed.
+void JS_FreeContextPendingJobs(JSContext* ctx);
 
 #ifdef __cplusplus
 }
@@ -85,3 +85,25 @@ TEST(JS_NewUnicodeString, fromChieseCode) {
   JS_FreeContext(ctx);
   JS_FreeRuntime(runtime);
 }
+
+TEST(JS_GetFastArray, borrowValues) {
+  JSRuntime* runtime = JS_NewRuntime();
+  JSContext* ctx = JS_NewContext(runtime);
+  JSValue array = JS_NewArray(ctx);
+  JS_SetPropertyUint32(ctx, array, 0, JS_NewInt32(ctx, 1));
+  JS_SetPropertyUint32(ctx, array, 1, JS_NewInt32(ctx, 2));
+
+  JSValue* values;
+  uint32_t count;
+  EXPECT_EQ(JS_GetFastArray(array, &values, &count), true);
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(JS_VALUE_GET_INT(values[1]), 2);
+
+  JSValue object = JS_NewObject(ctx);
+  EXPECT_EQ(JS_GetFastArray(object, &values, &count), false);
+
+  JS_FreeValue(ctx, object);
+  JS_FreeValue(ctx, array);
+  JS_FreeContext(ctx);
+  JS_FreeRuntime(runtime);
+}
@@ -45,6 +45,7 @@ void registerDartMethods(uint64_t* methodBytes, int32_t length) {
   methodPointer->flushUICommand = reinterpret_cast<FlushUICommand>(methodBytes[i++]);
   methodPointer->initWindow = reinterpret_cast<InitWindow>(methodBytes[i++]);
   methodPointer->initDocument = reinterpret_cast<InitDocument>(methodBytes[i++]);
+  methodPointer->requestIdlePeriod = reinterpret_cast<RequestIdlePeriod>(methodBytes[i++]);
 
 #if ENABLE_PROFILE
   methodPointer->getPerformanceEntries = reinterpret_cast<GetPerformanceEntries>(methodBytes[i++]);
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include "event_target_id_allocator.h"
+#include <cassert>
+
+namespace foundation {
+
+int32_t EventTargetIdAllocator::allocate() {
+  int32_t index;
+  if (m_freeIndexes.size() > kMinimumFreeSlots) {
+    index = m_freeIndexes.front();
+    m_freeIndexes.pop_front();
+  } else {
+    index = static_cast<int32_t>(m_slots.size());
+    assert(index <= kIndexMask && "Too many live event targets.");
+    m_slots.push_back(Slot{0, false});
+  }
+
+  Slot& slot = m_slots[index];
+  slot.live = true;
+  return (static_cast<int32_t>(slot.generation) << kIndexBits) | index;
+}
+
+void EventTargetIdAllocator::free(int32_t id) {
+  assert(isLive(id) && "Event target id is not allocated or already freed.");
+  int32_t index = indexOf(id);
+  Slot& slot = m_slots[index];
+  slot.live = false;
+  slot.generation = (slot.generation + 1) & kGenerationMask;
+  m_freeIndexes.push_back(index);
+}
+
+bool EventTargetIdAllocator::isLive(int32_t id) const {
+  if (id < 0)
+    return false;
+  size_t index = indexOf(id);
+  return index < m_slots.size() && m_slots[index].live && m_slots[index].generation == generationOf(id);
+}
+
+}  // namespace foundation
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#ifndef KRAKENBRIDGE_FOUNDATION_EVENT_TARGET_ID_ALLOCATOR_H_
+#define KRAKENBRIDGE_FOUNDATION_EVENT_TARGET_ID_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace foundation {
+
+// Allocate dense ids for event targets of a context, so that dart can look up targets from a flat list indexed by id.
+// The low bits of an id is the index of a slot, slots of disposed targets are reused. The high bits is the generation
+// of the slot, which is increased on every reuse, so a stale id never equals the id of the target reusing its slot.
+class EventTargetIdAllocator {
+ public:
+  static constexpr int32_t kIndexBits = 22;
+  static constexpr int32_t kIndexMask = (1 << kIndexBits) - 1;
+  // Ids are always positive, negative ids are reserved for window and document.
+  static constexpr int32_t kGenerationMask = (1 << (31 - kIndexBits)) - 1;
+  // Freed slots are reused in FIFO order once there are enough of them, to delay generation wrapping of hot slots.
+  static constexpr size_t kMinimumFreeSlots = 1024;
+
+  static inline int32_t indexOf(int32_t id) { return id & kIndexMask; }
+  static inline int32_t generationOf(int32_t id) { return (id >> kIndexBits) & kGenerationMask; }
+
+  int32_t allocate();
+  void free(int32_t id);
+  bool isLive(int32_t id) const;
+  // Count of slots ever allocated, which is the length of the flat list in dart.
+  inline size_t slotCount() const { return m_slots.size(); }
+
+ private:
+  struct Slot {
+    uint16_t generation;
+    bool live;
+  };
+  std::vector<Slot> m_slots;
+  std::deque<int32_t> m_freeIndexes;
+};
+
+}  // namespace foundation
+
+#endif  // KRAKENBRIDGE_FOUNDATION_EVENT_TARGET_ID_ALLOCATOR_H_
@@ -19,6 +19,7 @@ struct NativeScreen;
 using AsyncCallback = void (*)(void* callbackContext, int32_t contextId, const char* errmsg);
 using AsyncRAFCallback = void (*)(void* callbackContext, int32_t contextId, double result, const char* errmsg);
 using AsyncModuleCallback = void (*)(void* callbackContext, int32_t contextId, const char* errmsg, NativeString* json);
+using AsyncIdlePeriodCallback = void (*)(void* callbackContext, int32_t contextId, double timeRemaining, const char* errmsg);
 using AsyncBlobCallback = void (*)(void* callbackContext, int32_t contextId, const char* error, uint8_t* bytes, int32_t length);
 typedef NativeString* (*InvokeModule)(void* callbackContext, int32_t contextId, NativeString* moduleName, NativeString* method, NativeString* params, AsyncModuleCallback callback);
 typedef void (*RequestBatchUpdate)(int32_t contextId);
@@ -36,6 +37,7 @@ typedef void (*OnJSError)(int32_t contextId, const char*);
 typedef void (*FlushUICommand)();
 typedef void (*InitWindow)(int32_t contextId, void* nativePtr);
 typedef void (*InitDocument)(int32_t contextId, void* nativePtr);
+typedef void (*RequestIdlePeriod)(void* callbackContext, int32_t contextId, AsyncIdlePeriodCallback callback);
 
 using MatchImageSnapshotCallback = void (*)(void* callbackContext, int32_t contextId, int8_t, const char* errmsg);
 using MatchImageSnapshot = void (*)(void* callbackContext, int32_t contextId, uint8_t* bytes, int32_t length, NativeString* name, MatchImageSnapshotCallback callback);
@@ -84,6 +86,7 @@ struct DartMethodPointer {
 #endif
   InitWindow initWindow{nullptr};
   InitDocument initDocument{nullptr};
+  RequestIdlePeriod requestIdlePeriod{nullptr};
 };
 
 void registerDartMethods(uint64_t* methodBytes, int32_t length);
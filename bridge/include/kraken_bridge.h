@@ -50,6 +50,17 @@ struct NativeScreen {
   double height;
 };
 
+// Sizes of an element observed by ResizeObservers, reported by dart after layout.
+struct NativeResizeObservation {
+  int32_t targetId;
+  double contentX;
+  double contentY;
+  double contentWidth;
+  double contentHeight;
+  double borderBoxWidth;
+  double borderBoxHeight;
+};
+
 enum UICommand {
   createElement,
   createTextNode,
@@ -64,6 +75,13 @@ enum UICommand {
   cloneNode,
   removeEvent,
   createDocumentFragment,
+  insertAdjacentNodes,
+  cloneNodeTree,
+  resetElement,
+  observeIntersection,
+  unobserveIntersection,
+  observeResize,
+  unobserveResize,
 };
 
 struct KRAKEN_EXPORT UICommandItem {
@@ -107,6 +125,18 @@ void evaluateQuickjsByteCode(int32_t contextId, uint8_t* bytes, int32_t byteLen)
 KRAKEN_EXPORT_C
 void parseHTML(int32_t contextId, const char* code, int32_t length);
 KRAKEN_EXPORT_C
+void setElementRecyclingCapacity(int32_t contextId, int32_t capacity);
+KRAKEN_EXPORT_C
+void setScriptTimeBudget(int32_t contextId, int32_t budget);
+KRAKEN_EXPORT_C
+int32_t getInterruptedScriptCount(int32_t contextId);
+KRAKEN_EXPORT_C
+void dispatchResizeObservations(int32_t contextId, NativeResizeObservation* observations, int32_t length);
+KRAKEN_EXPORT_C
+void freezePage(int32_t contextId);
+KRAKEN_EXPORT_C
+void resumePage(int32_t contextId);
+KRAKEN_EXPORT_C
 void reloadJsContext(int32_t contextId);
 KRAKEN_EXPORT_C
 void invokeModuleEvent(int32_t contextId, NativeString* module, const char* eventType, void* event, NativeString* extra);
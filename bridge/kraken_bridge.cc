@@ -162,6 +162,42 @@ void parseHTML(int32_t contextId, const char* code, int32_t length) {
   context->parseHTML(code, length);
 }
 
+void setElementRecyclingCapacity(int32_t contextId, int32_t capacity) {
+  assert(checkPage(contextId) && "setElementRecyclingCapacity: contextId is not valid");
+  auto context = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  context->setElementRecyclingCapacity(capacity > 0 ? capacity : 0);
+}
+
+void setScriptTimeBudget(int32_t contextId, int32_t budget) {
+  assert(checkPage(contextId) && "setScriptTimeBudget: contextId is not valid");
+  auto context = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  context->setScriptTimeBudget(budget > 0 ? budget : 0);
+}
+
+int32_t getInterruptedScriptCount(int32_t contextId) {
+  assert(checkPage(contextId) && "getInterruptedScriptCount: contextId is not valid");
+  auto context = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  return context->interruptedScriptCount();
+}
+
+void dispatchResizeObservations(int32_t contextId, NativeResizeObservation* observations, int32_t length) {
+  assert(checkPage(contextId) && "dispatchResizeObservations: contextId is not valid");
+  auto context = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  context->dispatchResizeObservations(observations, length);
+}
+
+void freezePage(int32_t contextId) {
+  assert(checkPage(contextId) && "freezePage: contextId is not valid");
+  auto context = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  context->freeze();
+}
+
+void resumePage(int32_t contextId) {
+  assert(checkPage(contextId) && "resumePage: contextId is not valid");
+  auto context = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  context->resume();
+}
+
 void reloadJsContext(int32_t contextId) {
   assert(checkPage(contextId) && "reloadJSContext: contextId is not valid");
   auto bridgePtr = getPage(contextId);
@@ -211,6 +247,14 @@ void dispatchUITask(int32_t contextId, void* context, void* callback) {
 }
 
 void flushUITask(int32_t contextId) {
+  auto* page = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  if (page == nullptr || !page->getContext()->isValid()) {
+    foundation::UITaskQueue::instance(contextId)->flushTask();
+    return;
+  }
+
+  // Tasks of plugins may call into JS, they share one turn of the page.
+  kraken::binding::qjs::EventLoopScheduler::TaskScope scope(page->getContext(), kraken::binding::qjs::TaskLane::normal);
   foundation::UITaskQueue::instance(contextId)->flushTask();
 }
 
@@ -224,14 +268,15 @@ void flushUICommandCallback() {
 
 UICommandItem* getUICommandItems(int32_t contextId) {
   auto* page = static_cast<kraken::KrakenPage*>(getPage(contextId));
-  if (page == nullptr)
+  // Commands of frozen pages are kept until they resume.
+  if (page == nullptr || page->getContext()->isFrozen())
     return nullptr;
   return page->getContext()->uiCommandBuffer()->data();
 }
 
 int64_t getUICommandItemSize(int32_t contextId) {
   auto* page = static_cast<kraken::KrakenPage*>(getPage(contextId));
-  if (page == nullptr)
+  if (page == nullptr || page->getContext()->isFrozen())
     return 0;
   return page->getContext()->uiCommandBuffer()->size();
 }
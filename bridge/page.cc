@@ -14,6 +14,8 @@
 #include "bindings/qjs/bom/console.h"
 #include "bindings/qjs/bom/performance.h"
 #include "bindings/qjs/bom/screen.h"
+#include "bindings/qjs/bom/idle_callback.h"
+#include "bindings/qjs/bom/scheduler.h"
 #include "bindings/qjs/bom/timer.h"
 #include "bindings/qjs/bom/window.h"
 #include "bindings/qjs/dom/comment_node.h"
@@ -39,6 +41,9 @@
 #include "bindings/qjs/dom/events/.gen/mouse_event.h"
 #include "bindings/qjs/dom/events/.gen/popstate_event.h"
 #include "bindings/qjs/dom/events/touch_event.h"
+#include "bindings/qjs/dom/intersection_observer.h"
+#include "bindings/qjs/dom/mutation_observer.h"
+#include "bindings/qjs/dom/resize_observer.h"
 #include "bindings/qjs/dom/style_declaration.h"
 #include "bindings/qjs/dom/text_node.h"
 #include "bindings/qjs/module_manager.h"
@@ -67,6 +72,8 @@ KrakenPage::KrakenPage(int32_t contextId, const JSExceptionHandler& handler) : c
 
   bindConsole(m_context);
   bindTimer(m_context);
+  bindIdleCallback(m_context);
+  bindScheduler(m_context);
   bindScreen(m_context);
   bindModuleManager(m_context);
   bindEventTarget(m_context);
@@ -87,6 +94,9 @@ KrakenPage::KrakenPage(int32_t contextId, const JSExceptionHandler& handler) : c
   bindScriptElement(m_context);
   bindTemplateElement(m_context);
   bindCSSStyleDeclaration(m_context);
+  bindMutationObserver(m_context);
+  bindIntersectionObserver(m_context);
+  bindResizeObserver(m_context);
   bindCloseEvent(m_context);
   bindGestureEvent(m_context);
   bindInputEvent(m_context);
@@ -125,10 +135,53 @@ bool KrakenPage::parseHTML(const char* code, size_t length) {
   return true;
 }
 
+void KrakenPage::setElementRecyclingCapacity(uint32_t capacity) {
+  if (!m_context->isValid())
+    return;
+  Document::instance(m_context)->setElementRecyclingCapacity(capacity);
+}
+
+void KrakenPage::setScriptTimeBudget(uint32_t budget) {
+  if (!m_context->isValid())
+    return;
+  m_context->scheduler()->setScriptBudget(budget);
+}
+
+uint32_t KrakenPage::interruptedScriptCount() const {
+  return m_context->scheduler()->interruptedScriptCount();
+}
+
+void KrakenPage::dispatchResizeObservations(NativeResizeObservation* observations, int32_t length) {
+  if (!m_context->isValid())
+    return;
+  EventLoopScheduler::TaskScope scope(m_context, TaskLane::animation);
+  ResizeObserverInstance::deliverObservations(m_context, observations, length);
+}
+
+void KrakenPage::freeze() {
+  if (!m_context->isValid())
+    return;
+  m_context->freeze();
+}
+
+void KrakenPage::resume() {
+  if (!m_context->isValid())
+    return;
+  m_context->resume();
+}
+
 void KrakenPage::invokeModuleEvent(NativeString* moduleName, const char* eventType, void* rawEvent, NativeString* extra) {
   if (!m_context->isValid())
     return;
 
+  if (UNLIKELY(m_context->isFrozen())) {
+    auto* nativeEvent = rawEvent == nullptr ? nullptr : reinterpret_cast<NativeEvent*>(static_cast<RawEvent*>(rawEvent)->bytes);
+    m_context->frozenTasks()->enqueueModuleEvent(moduleName, eventType, nativeEvent, extra);
+    return;
+  }
+
+  EventLoopScheduler::TaskScope scope(m_context, TaskLane::normal);
+
   JSValue eventObject = JS_NULL;
   if (rawEvent != nullptr) {
     std::string type = std::string(eventType);
@@ -171,6 +224,7 @@ void KrakenPage::invokeModuleEvent(NativeString* moduleName, const char* eventTy
 void KrakenPage::evaluateScript(const NativeString* script, const char* url, int startLine) {
   if (!m_context->isValid())
     return;
+  EventLoopScheduler::ScriptScope scriptScope(m_context);
 
 #if ENABLE_PROFILE
   auto nativePerformance = Performance::instance(m_context)->m_nativePerformance;
@@ -185,12 +239,14 @@ void KrakenPage::evaluateScript(const NativeString* script, const char* url, int
 void KrakenPage::evaluateScript(const uint16_t* script, size_t length, const char* url, int startLine) {
   if (!m_context->isValid())
     return;
+  EventLoopScheduler::ScriptScope scriptScope(m_context);
   m_context->evaluateJavaScript(script, length, url, startLine);
 }
 
 void KrakenPage::evaluateScript(const char* script, size_t length, const char* url, int startLine) {
   if (!m_context->isValid())
     return;
+  EventLoopScheduler::ScriptScope scriptScope(m_context);
   m_context->evaluateJavaScript(script, length, url, startLine);
 }
 
@@ -203,6 +259,7 @@ uint8_t* KrakenPage::dumpByteCode(const char* script, size_t length, const char*
 void KrakenPage::evaluateByteCode(uint8_t* bytes, size_t byteLength) {
   if (!m_context->isValid())
     return;
+  EventLoopScheduler::ScriptScope scriptScope(m_context);
   m_context->evaluateByteCode(bytes, byteLength);
 }
 
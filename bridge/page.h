@@ -39,6 +39,16 @@ class KrakenPage final {
   void evaluateScript(const NativeString* script, const char* url, int startLine);
   void evaluateScript(const uint16_t* script, size_t length, const char* url, int startLine);
   bool parseHTML(const char* code, size_t length);
+  // Reuse finalized generic elements of this page, keep at most capacity elements for each tag, 0 to disable.
+  void setElementRecyclingCapacity(uint32_t capacity);
+  void dispatchResizeObservations(NativeResizeObservation* observations, int32_t length);
+  // Interrupt scripts which run longer than budget milliseconds in one entry into JS, 0 to disable.
+  void setScriptTimeBudget(uint32_t budget);
+  uint32_t interruptedScriptCount() const;
+  // Hidden pages are frozen, their timers and animation frames are held and the events from dart are queued until
+  // they resume.
+  void freeze();
+  void resume();
   void evaluateScript(const char* script, size_t length, const char* url, int startLine);
   uint8_t* dumpByteCode(const char* script, size_t length, const char* url, size_t* byteLength);
   void evaluateByteCode(uint8_t* bytes, size_t byteLength);
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include <benchmark/benchmark.h>
+#include "kraken_test_env.h"
+#include "page.h"
+
+static auto cloneBridge = TEST_init();
+
+static void setupTemplate(kraken::binding::qjs::ExecutionContext* context) {
+  std::string setup =
+      "var template = document.createElement('template');"
+      "for (var i = 0; i < 20; i ++) {"
+      "  var row = document.createElement('div');"
+      "  row.setAttribute('class', 'row');"
+      "  row.style.height = '20px';"
+      "  var label = document.createElement('span');"
+      "  label.appendChild(document.createTextNode('row ' + i));"
+      "  row.appendChild(label);"
+      "  template.content.appendChild(row);"
+      "}"
+      "var tree = document.createElement('div');"
+      "tree.appendChild(template.content.cloneNode(true));";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+}
+
+static void CloneElementTree(benchmark::State& state) {
+  auto* context = cloneBridge->getContext();
+  setupTemplate(context);
+  std::string code = "tree.cloneNode(true);";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+    context->uiCommandBuffer()->clear();
+  }
+}
+
+static void CloneTemplateContent(benchmark::State& state) {
+  auto* context = cloneBridge->getContext();
+  setupTemplate(context);
+  std::string code = "template.content.cloneNode(true);";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+    context->uiCommandBuffer()->clear();
+  }
+}
+
+BENCHMARK(CloneElementTree)->Threads(1);
+BENCHMARK(CloneTemplateContent)->Threads(1);
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include <benchmark/benchmark.h>
+#include "bindings/qjs/dom/element.h"
+#include "kraken_test_env.h"
+#include "page.h"
+
+static auto bridge = TEST_init();
+
+// A touchmove bubbles from a leaf of a deep tree, most ancestors listen to other events only.
+static void DispatchTouchMoveInDeepTree(benchmark::State& state) {
+  auto* context = bridge->getContext();
+  std::string setup =
+      "var leaf = document.body;"
+      "for (var i = 0; i < 32; i ++) {"
+      "  var div = document.createElement('div');"
+      "  if (i % 4 == 0) div.addEventListener('click', function() {});"
+      "  leaf.appendChild(div);"
+      "  leaf = div;"
+      "}"
+      "var moves = 0;"
+      "document.body.addEventListener('touchmove', function() { moves ++; });"
+      "var touchMove = new CustomEvent('touchmove', { bubbles: true });";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+  std::string code = "for (var i = 0; i < 100; i ++) leaf.dispatchEvent(touchMove);";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+  }
+}
+
+// Touch events from dart over a deep tree which only listens to clicks.
+static void DispatchNativeTouchMoveWithoutListeners(benchmark::State& state) {
+  using namespace kraken::binding::qjs;
+  auto* context = bridge->getContext();
+  std::string setup =
+      "var quietLeaf = document.body;"
+      "for (var i = 0; i < 32; i ++) {"
+      "  var div = document.createElement('div');"
+      "  div.addEventListener('click', function() {});"
+      "  quietLeaf.appendChild(div);"
+      "  quietLeaf = div;"
+      "}";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+  JSValue leafValue = JS_GetPropertyStr(context->ctx(), context->global(), "quietLeaf");
+  auto* leaf = static_cast<EventTargetInstance*>(JS_GetOpaque(leafValue, Element::classId()));
+  for (auto _ : state) {
+    TEST_dispatchEvent(context->getContextId(), leaf, "touchmove");
+  }
+  JS_FreeValue(context->ctx(), leafValue);
+}
+
+BENCHMARK(DispatchTouchMoveInDeepTree)->Threads(1);
+BENCHMARK(DispatchNativeTouchMoveWithoutListeners)->Threads(1);
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include <benchmark/benchmark.h>
+#include "kraken_test_env.h"
+#include "page.h"
+
+static auto propertyBridge = TEST_init();
+
+static void EventTargetExpandoProperty(benchmark::State& state) {
+  auto* context = propertyBridge->getContext();
+  std::string setup = "var el = document.createElement('div');";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+  std::string code = "for (var i = 0; i < 1000; i ++) { el.foo = i; el.foo; }";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+  }
+}
+
+static void EventTargetPrototypeProperty(benchmark::State& state) {
+  auto* context = propertyBridge->getContext();
+  std::string setup = "var el = document.createElement('div');";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+  std::string code = "for (var i = 0; i < 1000; i ++) { el.nodeType; el.parentNode; }";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+  }
+}
+
+static void EventTargetEventHandlerProperty(benchmark::State& state) {
+  auto* context = propertyBridge->getContext();
+  std::string setup = "var el = document.createElement('div'); function onClick() {}";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+  std::string code = "for (var i = 0; i < 1000; i ++) { el.onclick = onClick; el.onclick; }";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+  }
+}
+
+BENCHMARK(EventTargetExpandoProperty)->Threads(1);
+BENCHMARK(EventTargetPrototypeProperty)->Threads(1);
+BENCHMARK(EventTargetEventHandlerProperty)->Threads(1);
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include <benchmark/benchmark.h>
+#include "bindings/qjs/dom/document.h"
+#include "kraken_test_env.h"
+#include "page.h"
+
+static auto churnBridge = TEST_init();
+static auto recyclingBridge = TEST_init();
+
+// Rows of an infinite-scroll list are created when scrolled into view and removed when scrolled out.
+static void churnRows(kraken::binding::qjs::ExecutionContext* context, benchmark::State& state) {
+  std::string setup = "var list = document.createElement('div'); document.body.appendChild(list);";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+  std::string code =
+      "for (var i = 0; i < 50; i ++) {"
+      "  var row = document.createElement('div');"
+      "  row.setAttribute('class', 'row');"
+      "  var label = document.createElement('span');"
+      "  row.appendChild(label);"
+      "  list.appendChild(row);"
+      "}"
+      "while (list.firstChild) list.removeChild(list.firstChild);"
+      "row = label = null;";
+  int64_t commands = 0;
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+    commands += context->uiCommandBuffer()->size();
+    context->uiCommandBuffer()->clear();
+  }
+  // Dart side work is not measured here, report the UI commands sent to dart instead.
+  state.counters["UICommands"] = benchmark::Counter(commands, benchmark::Counter::kAvgIterations);
+}
+
+static void CreateAndRemoveRows(benchmark::State& state) {
+  churnRows(churnBridge->getContext(), state);
+}
+
+static void CreateAndRemoveRowsWithRecycling(benchmark::State& state) {
+  auto* context = recyclingBridge->getContext();
+  kraken::binding::qjs::Document::instance(context)->setElementRecyclingCapacity(1024);
+  churnRows(context, state);
+}
+
+BENCHMARK(CreateAndRemoveRows)->Threads(1);
+BENCHMARK(CreateAndRemoveRowsWithRecycling)->Threads(1);
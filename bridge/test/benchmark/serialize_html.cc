@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2021 Alibaba Inc. All rights reserved.
+ * Author: Kraken Team.
+ */
+
+#include <benchmark/benchmark.h>
+#include "kraken_test_env.h"
+#include "page.h"
+
+static auto serializeBridge = TEST_init();
+
+static void setupTree(kraken::binding::qjs::ExecutionContext* context) {
+  std::string setup =
+      "var tree = document.createElement('div');"
+      "for (var i = 0; i < 500; i ++) {"
+      "  var item = document.createElement('div');"
+      "  item.setAttribute('class', 'item');"
+      "  item.setAttribute('data-index', String(i));"
+      "  item.style.width = '100px';"
+      "  var label = document.createElement('span');"
+      "  label.appendChild(document.createTextNode('item ' + i + ' & more'));"
+      "  item.appendChild(label);"
+      "  tree.appendChild(item);"
+      "}";
+  context->evaluateJavaScript(setup.c_str(), setup.size(), "internal://", 0);
+}
+
+static void SerializeInnerHTML(benchmark::State& state) {
+  auto* context = serializeBridge->getContext();
+  setupTree(context);
+  std::string code = "tree.innerHTML;";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+  }
+}
+
+static void SerializeTextContent(benchmark::State& state) {
+  auto* context = serializeBridge->getContext();
+  setupTree(context);
+  std::string code = "tree.textContent;";
+  for (auto _ : state) {
+    context->evaluateJavaScript(code.c_str(), code.size(), "internal://", 0);
+  }
+}
+
+BENCHMARK(SerializeInnerHTML)->Threads(1);
+BENCHMARK(SerializeTextContent)->Threads(1);
@@ -30,7 +30,8 @@ static int64_t get_time_ms(void) {
 typedef struct {
   struct list_head link;
   int64_t timeout;
-  DOMTimer* timer;
+  void* callbackContext;
+  int32_t timerId;
   int32_t contextId;
   bool isInterval;
   AsyncCallback func;
@@ -38,19 +39,26 @@ typedef struct {
 
 typedef struct {
   struct list_head link;
-  FrameCallback* callback;
+  void* callbackContext;
   int32_t contextId;
   AsyncRAFCallback handler;
   int32_t callbackId;
 } JSFrameCallback;
 
+typedef struct {
+  void* callbackContext;
+  int32_t contextId;
+  AsyncIdlePeriodCallback handler;
+} JSIdlePeriod;
+
 typedef struct JSThreadState {
   std::unordered_map<int32_t, JSOSTimer*> os_timers; /* list of timer.link */
   std::unordered_map<int32_t, JSFrameCallback*> os_frameCallbacks;
+  std::vector<JSIdlePeriod> os_idlePeriods;
 } JSThreadState;
 
 static void unlink_timer(JSThreadState* ts, JSOSTimer* th) {
-  ts->os_timers.erase(th->timer->timerId());
+  ts->os_timers.erase(th->timerId);
 }
 
 static void unlink_callback(JSThreadState* ts, JSFrameCallback* th) {
@@ -73,50 +81,43 @@ void TEST_reloadApp(int32_t contextId) {}
 
 int32_t timerId = 0;
 
-int32_t TEST_setTimeout(DOMTimer* timer, int32_t contextId, AsyncCallback callback, int32_t timeout) {
-  JSRuntime* rt = JS_GetRuntime(timer->ctx());
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(timer->ctx()));
-  JSThreadState* ts = static_cast<JSThreadState*>(JS_GetRuntimeOpaque(rt));
+static int32_t installTimer(void* callbackContext, int32_t contextId, AsyncCallback callback, int32_t timeout, bool isInterval) {
+  // The callbackContext is not always a DOMTimer, native timers share one wakeup of the page.
+  auto* page = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  auto* context = page->getContext();
+  JSThreadState* ts = static_cast<JSThreadState*>(JS_GetRuntimeOpaque(context->runtime()));
   JSOSTimer* th = static_cast<JSOSTimer*>(js_mallocz(context->ctx(), sizeof(*th)));
   th->timeout = get_time_ms() + timeout;
   th->func = callback;
-  th->timer = timer;
+  th->callbackContext = callbackContext;
   th->contextId = contextId;
-  th->isInterval = false;
+  th->isInterval = isInterval;
   int32_t id = timerId++;
+  th->timerId = id;
 
   ts->os_timers[id] = th;
 
   return id;
 }
 
-int32_t TEST_setInterval(DOMTimer* timer, int32_t contextId, AsyncCallback callback, int32_t timeout) {
-  JSRuntime* rt = JS_GetRuntime(timer->ctx());
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(timer->ctx()));
-  JSThreadState* ts = static_cast<JSThreadState*>(JS_GetRuntimeOpaque(rt));
-  JSOSTimer* th = static_cast<JSOSTimer*>(js_mallocz(context->ctx(), sizeof(*th)));
-  th->timeout = get_time_ms() + timeout;
-  th->func = callback;
-  th->timer = timer;
-  th->contextId = contextId;
-  th->isInterval = true;
-  int32_t id = timerId++;
-
-  ts->os_timers[id] = th;
+int32_t TEST_setTimeout(void* callbackContext, int32_t contextId, AsyncCallback callback, int32_t timeout) {
+  return installTimer(callbackContext, contextId, callback, timeout, false);
+}
 
-  return id;
+int32_t TEST_setInterval(void* callbackContext, int32_t contextId, AsyncCallback callback, int32_t timeout) {
+  return installTimer(callbackContext, contextId, callback, timeout, true);
 }
 
 int32_t callbackId = 0;
 
-uint32_t TEST_requestAnimationFrame(FrameCallback* frameCallback, int32_t contextId, AsyncRAFCallback handler) {
-  JSRuntime* rt = JS_GetRuntime(frameCallback->ctx());
-  auto* context = static_cast<ExecutionContext*>(JS_GetContextOpaque(frameCallback->ctx()));
-  JSThreadState* ts = static_cast<JSThreadState*>(JS_GetRuntimeOpaque(rt));
+int32_t TEST_requestAnimationFrame(void* callbackContext, int32_t contextId, AsyncRAFCallback handler) {
+  auto* page = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  auto* context = page->getContext();
+  JSThreadState* ts = static_cast<JSThreadState*>(JS_GetRuntimeOpaque(context->runtime()));
   JSFrameCallback* th = static_cast<JSFrameCallback*>(js_mallocz(context->ctx(), sizeof(*th)));
   th->handler = handler;
-  th->callback = frameCallback;
-  th->contextId = context->getContextId();
+  th->callbackContext = callbackContext;
+  th->contextId = contextId;
   int32_t id = callbackId++;
 
   th->callbackId = id;
@@ -140,6 +141,16 @@ void TEST_clearTimeout(int32_t contextId, int32_t timerId) {
   ts->os_timers.erase(timerId);
 }
 
+// Idle periods start after a frame of 60fps, which leaves this much time to idle callbacks.
+static const double kIdlePeriodBudget = 16;
+
+void TEST_requestIdlePeriod(void* callbackContext, int32_t contextId, AsyncIdlePeriodCallback handler) {
+  auto* page = static_cast<kraken::KrakenPage*>(getPage(contextId));
+  auto* context = page->getContext();
+  JSThreadState* ts = static_cast<JSThreadState*>(JS_GetRuntimeOpaque(context->runtime()));
+  ts->os_idlePeriods.push_back({callbackContext, contextId, handler});
+}
+
 NativeScreen* TEST_getScreen(int32_t contextId) {
   return nullptr;
 };
@@ -207,7 +218,7 @@ static bool jsPool(ExecutionContext* context) {
   int64_t cur_time, delay;
   struct list_head* el;
 
-  if (ts->os_timers.empty() && ts->os_frameCallbacks.empty())
+  if (ts->os_timers.empty() && ts->os_frameCallbacks.empty() && ts->os_idlePeriods.empty())
     return true; /* no more events */
 
   if (!ts->os_timers.empty()) {
@@ -221,11 +232,11 @@ static bool jsPool(ExecutionContext* context) {
         func = th->func;
 
         if (th->isInterval) {
-          func(th->timer, th->contextId, nullptr);
+          func(th->callbackContext, th->contextId, nullptr);
         } else {
           th->func = nullptr;
-          func(th->timer, th->contextId, nullptr);
           unlink_timer(ts, th);
+          func(th->callbackContext, th->contextId, nullptr);
         }
 
         return false;
@@ -238,12 +249,22 @@ static bool jsPool(ExecutionContext* context) {
       JSFrameCallback* th = entry.second;
       AsyncRAFCallback handler = th->handler;
       th->handler = nullptr;
-      handler(th->callback, th->contextId, 0, nullptr);
       unlink_callback(ts, th);
+      handler(th->callbackContext, th->contextId, 0, nullptr);
       return false;
     }
   }
 
+  if (!ts->os_idlePeriods.empty()) {
+    JSIdlePeriod period = ts->os_idlePeriods.front();
+    ts->os_idlePeriods.erase(ts->os_idlePeriods.begin());
+    // Idle periods come after the frame which flushed UI commands.
+    auto* page = static_cast<kraken::KrakenPage*>(getPage(period.contextId));
+    page->getContext()->uiCommandBuffer()->clear();
+    period.handler(period.callbackContext, period.contextId, kIdlePeriodBudget, nullptr);
+    return false;
+  }
+
   return false;
 }
 
@@ -256,7 +277,7 @@ void TEST_runLoop(ExecutionContext* context) {
 }
 
 void TEST_dispatchEvent(int32_t contextId, EventTargetInstance* eventTarget, const std::string type) {
-  NativeEventTarget* nativeEventTarget = new NativeEventTarget(eventTarget);
+  NativeEventTarget* nativeEventTarget = &eventTarget->nativeEventTarget;
   auto nativeEventType = stringToNativeString(type);
   NativeString* rawEventType = nativeEventType.release();
 
@@ -307,6 +328,7 @@ void TEST_mockDartMethods(OnJSError onJSError) {
       reinterpret_cast<uint64_t>(TEST_flushUICommand),
       reinterpret_cast<uint64_t>(TEST_initWindow),
       reinterpret_cast<uint64_t>(TEST_initDocument),
+      reinterpret_cast<uint64_t>(TEST_requestIdlePeriod),
   };
 
 #if ENABLE_PROFILE
@@ -18,6 +18,8 @@ list(APPEND KRAKEN_UNIT_TEST_SOURCE
   ./test/kraken_test_env.h
   ./bindings/qjs/js_context_test.cc
   ./bindings/qjs/bom/timer_test.cc
+  ./bindings/qjs/bom/idle_callback_test.cc
+  ./bindings/qjs/bom/scheduler_test.cc
   ./bindings/qjs/bom/console_test.cc
   ./bindings/qjs/qjs_patch_test.cc
   ./bindings/qjs/host_object_test.cc
@@ -31,6 +33,9 @@ list(APPEND KRAKEN_UNIT_TEST_SOURCE
   ./bindings/qjs/dom/text_node_test.cc
   ./bindings/qjs/bom/window_test.cc
   ./bindings/qjs/dom/custom_event_test.cc
+  ./bindings/qjs/dom/mutation_observer_test.cc
+  ./bindings/qjs/dom/intersection_observer_test.cc
+  ./bindings/qjs/dom/resize_observer_test.cc
   ./bindings/qjs/module_manager_test.cc
 )
 
@@ -80,6 +85,11 @@ add_executable(kraken_benchmark
   ./test/kraken_test_env.cc
   ./test/kraken_test_env.h
   ./test/benchmark/create_element.cc
+  ./test/benchmark/event_target_property.cc
+  ./test/benchmark/serialize_html.cc
+  ./test/benchmark/clone_node.cc
+  ./test/benchmark/recycle_element.cc
+  ./test/benchmark/dispatch_event.cc
 )
 target_include_directories(kraken_benchmark PUBLIC
   ./third_party/googletest/googletest/include
@@ -154,6 +154,10 @@ typedef NativeRAFAsyncCallback = Void Function(
     Pointer<Void> callbackContext, Int32 contextId, Double data, Pointer<Utf8> errmsg);
 typedef DartRAFAsyncCallback = void Function(
     Pointer<Void>, int contextId, double data, Pointer<Utf8> errmsg);
+typedef NativeIdlePeriodAsyncCallback = Void Function(
+    Pointer<Void> callbackContext, Int32 contextId, Double timeRemaining, Pointer<Utf8> errmsg);
+typedef DartIdlePeriodAsyncCallback = void Function(
+    Pointer<Void>, int contextId, double timeRemaining, Pointer<Utf8> errmsg);
 
 // Register requestBatchUpdate
 typedef NativeRequestBatchUpdate = Void Function(Int32 contextId);
@@ -285,6 +289,37 @@ void _cancelAnimationFrame(int contextId, int timerId) {
 final Pointer<NativeFunction<NativeCancelAnimationFrame>> _nativeCancelAnimationFrame =
     Pointer.fromFunction(_cancelAnimationFrame);
 
+// Register requestIdlePeriod
+typedef NativeRequestIdlePeriod = Void Function(
+    Pointer<Void> callbackContext, Int32 contextId, Pointer<NativeFunction<NativeIdlePeriodAsyncCallback>>);
+
+void _requestIdlePeriod(Pointer<Void> callbackContext, int contextId,
+    Pointer<NativeFunction<NativeIdlePeriodAsyncCallback>> callback) {
+  KrakenController controller = KrakenController.getControllerOfJSContextId(contextId)!;
+  controller.module.requestIdlePeriod((double timeRemaining) {
+    void _runCallback() {
+      DartIdlePeriodAsyncCallback func = callback.asFunction();
+      try {
+        func(callbackContext, contextId, timeRemaining, nullptr);
+      } catch (e, stack) {
+        Pointer<Utf8> nativeErrorMessage = ('Error: $e\n$stack').toNativeUtf8();
+        func(callbackContext, contextId, timeRemaining, nativeErrorMessage);
+        malloc.free(nativeErrorMessage);
+      }
+    }
+
+    // Pause if kraken page paused.
+    if (controller.paused) {
+      controller.pushPendingCallbacks(_runCallback);
+    } else {
+      _runCallback();
+    }
+  });
+}
+
+final Pointer<NativeFunction<NativeRequestIdlePeriod>> _nativeRequestIdlePeriod =
+    Pointer.fromFunction(_requestIdlePeriod);
+
 // Register devicePixelRatio
 typedef NativeDevicePixelRatio = Double Function();
 
@@ -416,6 +451,7 @@ final List<int> _dartNativeMethods = [
   _nativeFlushUICommand.address,
   _nativeInitWindow.address,
   _nativeInitDocument.address,
+  _nativeRequestIdlePeriod.address,
   _nativeGetEntries.address,
   _nativeOnJsError.address,
 ];
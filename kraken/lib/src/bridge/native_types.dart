@@ -271,6 +271,29 @@ class NativeBoundingClientRect extends Struct {
   external double left;
 }
 
+class NativeResizeObservation extends Struct {
+  @Int32()
+  external int targetId;
+
+  @Double()
+  external double contentX;
+
+  @Double()
+  external double contentY;
+
+  @Double()
+  external double contentWidth;
+
+  @Double()
+  external double contentHeight;
+
+  @Double()
+  external double borderBoxWidth;
+
+  @Double()
+  external double borderBoxHeight;
+}
+
 
 typedef NativeDispatchEvent = Void Function(
     Int32 contextId,
@@ -7,6 +7,7 @@ import 'dart:async';
 import 'dart:ffi';
 import 'dart:io';
 import 'dart:typed_data';
+import 'dart:ui' show Rect, Size;
 
 import 'package:ffi/ffi.dart';
 import 'package:flutter/foundation.dart';
@@ -207,6 +208,81 @@ void parseHTML(int contextId, String code) {
   malloc.free(nativeCode);
 }
 
+// Register setElementRecyclingCapacity
+typedef NativeSetElementRecyclingCapacity = Void Function(
+    Int32 contextId, Int32 capacity);
+typedef DartSetElementRecyclingCapacity = void Function(
+    int contextId, int capacity);
+
+final DartSetElementRecyclingCapacity _setElementRecyclingCapacity =
+    KrakenDynamicLibrary.ref
+        .lookup<NativeFunction<NativeSetElementRecyclingCapacity>>(
+            'setElementRecyclingCapacity')
+        .asFunction();
+
+// Reuse detached elements of the page instead of disposing them, keep at most
+// capacity elements for each tag name, 0 to disable.
+void setElementRecyclingCapacity(int contextId, int capacity) {
+  if (KrakenController.getControllerOfJSContextId(contextId) == null) {
+    return;
+  }
+  _setElementRecyclingCapacity(contextId, capacity);
+}
+
+// Register setScriptTimeBudget
+typedef NativeSetScriptTimeBudget = Void Function(Int32 contextId, Int32 budget);
+typedef DartSetScriptTimeBudget = void Function(int contextId, int budget);
+
+final DartSetScriptTimeBudget _setScriptTimeBudget = KrakenDynamicLibrary.ref
+    .lookup<NativeFunction<NativeSetScriptTimeBudget>>('setScriptTimeBudget')
+    .asFunction();
+
+// Interrupt scripts of the page which run longer than budget milliseconds
+// without returning to dart, 0 to disable.
+void setScriptTimeBudget(int contextId, int budget) {
+  if (KrakenController.getControllerOfJSContextId(contextId) == null) {
+    return;
+  }
+  _setScriptTimeBudget(contextId, budget);
+}
+
+// Register dispatchResizeObservations
+typedef NativeDispatchResizeObservations = Void Function(
+    Int32 contextId, Pointer<NativeResizeObservation> observations, Int32 length);
+typedef DartDispatchResizeObservations = void Function(
+    int contextId, Pointer<NativeResizeObservation> observations, int length);
+
+final DartDispatchResizeObservations _dispatchResizeObservations =
+    KrakenDynamicLibrary.ref
+        .lookup<NativeFunction<NativeDispatchResizeObservations>>(
+            'dispatchResizeObservations')
+        .asFunction();
+
+// Report the sizes of elements observed by ResizeObservers which changed in
+// this frame, all observers of the page are called once from native.
+void dispatchResizeObservations(int contextId, List<int> targetIds,
+    List<Rect> contentRects, List<Size> borderBoxSizes) {
+  if (KrakenController.getControllerOfJSContextId(contextId) == null) {
+    return;
+  }
+  int length = targetIds.length;
+  Pointer<NativeResizeObservation> observations =
+      malloc.allocate<NativeResizeObservation>(
+          sizeOf<NativeResizeObservation>() * length);
+  for (int i = 0; i < length; i++) {
+    NativeResizeObservation observation = observations[i];
+    observation.targetId = targetIds[i];
+    observation.contentX = contentRects[i].left;
+    observation.contentY = contentRects[i].top;
+    observation.contentWidth = contentRects[i].width;
+    observation.contentHeight = contentRects[i].height;
+    observation.borderBoxWidth = borderBoxSizes[i].width;
+    observation.borderBoxHeight = borderBoxSizes[i].height;
+  }
+  _dispatchResizeObservations(contextId, observations, length);
+  malloc.free(observations);
+}
+
 // Register initJsEngine
 typedef NativeInitJSPagePool = Void Function(Int32 poolSize);
 typedef DartInitJSPagePool = void Function(int poolSize);
@@ -230,6 +306,30 @@ void disposePage(int contextId) {
   _disposePage(contextId);
 }
 
+typedef NativeFreezePage = Void Function(Int32 contextId);
+typedef DartFreezePage = void Function(int contextId);
+
+final DartFreezePage _freezePage = KrakenDynamicLibrary.ref
+    .lookup<NativeFunction<NativeFreezePage>>('freezePage')
+    .asFunction();
+
+// Hold the timers and animation frames of a hidden page, events sent to it
+// are queued until it resumes.
+void freezePage(int contextId) {
+  _freezePage(contextId);
+}
+
+typedef NativeResumePage = Void Function(Int32 contextId);
+typedef DartResumePage = void Function(int contextId);
+
+final DartResumePage _resumePage = KrakenDynamicLibrary.ref
+    .lookup<NativeFunction<NativeResumePage>>('resumePage')
+    .asFunction();
+
+void resumePage(int contextId) {
+  _resumePage(contextId);
+}
+
 typedef NativeAllocateNewPage = Int32 Function(Int32);
 typedef DartAllocateNewPage = int Function(int);
 
@@ -330,6 +430,13 @@ enum UICommandType {
   cloneNode,
   removeEvent,
   createDocumentFragment,
+  insertAdjacentNodes,
+  cloneNodeTree,
+  resetElement,
+  observeIntersection,
+  unobserveIntersection,
+  observeResize,
+  unobserveResize,
 }
 
 class UICommandItem extends Struct {
@@ -528,17 +635,40 @@ void flushUICommand() {
           case UICommandType.disposeEventTarget:
             controller.view.disposeEventTarget(id);
             break;
+          case UICommandType.resetElement:
+            controller.view.resetElement(id);
+            break;
           case UICommandType.addEvent:
-            controller.view.addEvent(id, command.args[0]);
+            // The second argument is '1' when all the listeners in JS are passive.
+            controller.view.addEvent(id, command.args[0], passive: command.args.length > 1 && command.args[1] == '1');
             break;
           case UICommandType.removeEvent:
             controller.view.removeEvent(id, command.args[0]);
             break;
+          case UICommandType.observeIntersection:
+            List<double> thresholds = command.args[0].split(',').map(double.parse).toList();
+            controller.view.observeIntersection(id, thresholds, command.args[1]);
+            break;
+          case UICommandType.unobserveIntersection:
+            controller.view.unobserveIntersection(id);
+            break;
+          case UICommandType.observeResize:
+            controller.view.observeResize(id);
+            break;
+          case UICommandType.unobserveResize:
+            controller.view.unobserveResize(id);
+            break;
           case UICommandType.insertAdjacentNode:
             int childId = int.parse(command.args[0]);
             String position = command.args[1];
             controller.view.insertAdjacentNode(id, position, childId);
             break;
+          case UICommandType.insertAdjacentNodes:
+            List<int> childIds =
+                command.args[0].split(',').map(int.parse).toList();
+            String position = command.args[1];
+            controller.view.insertAdjacentNodes(id, position, childIds);
+            break;
           case UICommandType.removeNode:
             controller.view.removeNode(id);
             break;
@@ -546,6 +676,19 @@ void flushUICommand() {
             int newId = int.parse(command.args[0]);
             controller.view.cloneNode(id, newId);
             break;
+          case UICommandType.cloneNodeTree:
+            List<int> originalIds = [];
+            List<int> newIds = [];
+            List<int> parentIds = [];
+            for (String entry in command.args[0].split(',')) {
+              List<String> ids = entry.split(':');
+              originalIds.add(int.parse(ids[0]));
+              newIds.add(int.parse(ids[1]));
+              // The root of the new tree has no parent.
+              parentIds.add(ids.length > 2 ? int.parse(ids[2]) : -1);
+            }
+            controller.view.cloneNodeTree(originalIds, newIds, parentIds);
+            break;
           case UICommandType.setStyle:
             String key = command.args[0];
             String value = command.args[1];
@@ -103,6 +103,9 @@ class Element extends Node
   /// The inline style is a map of style property name to style property value.
   final Map<String, dynamic> inlineStyle = {};
 
+  // The rootMargin of IntersectionObservers observing this element.
+  String? _intersectionRootMargin;
+
   /// The Element.classList is a read-only property that returns a collection of the class attributes of the element.
   final List<String> _classList = [];
   List<String> get classList {
@@ -666,6 +669,30 @@ class Element extends Node
     super.dispose();
   }
 
+  /// Restore the state of a newly created element, the bridge resets elements
+  /// which are kept for reuse instead of disposing them.
+  void reset() {
+    Element? _parentElement = parentElement;
+    if (_parentElement != null) {
+      _parentElement.removeChild(this);
+    }
+    for (Node child in List<Node>.from(childNodes)) {
+      removeChild(child);
+    }
+    for (String eventType in List<String>.from(eventHandlers.keys)) {
+      removeEvent(eventType);
+    }
+    unobserveIntersection();
+    for (String property in List<String>.from(inlineStyle.keys)) {
+      _removeInlineStyleProperty(property);
+    }
+    style.flushPendingProperties();
+    if (_classList.isNotEmpty) {
+      className = EMPTY_STRING;
+    }
+    properties.clear();
+  }
+
   // Used for force update layout.
   void flushLayout() {
     if (isRendererAttached) {
@@ -1503,9 +1530,10 @@ class Element extends Node
     // Must bind event responder on render box model whatever there is no event listener.
     RenderBoxModel? _renderBoxModel = renderBoxModel;
     if (_renderBoxModel != null) {
+      _renderBoxModel.intersectionRootMargin = _intersectionRootMargin;
       // Make sure pointer responder bind.
       addEventResponder(_renderBoxModel);
-      if (_hasIntersectionObserverEvent(eventHandlers)) {
+      if (_hasIntersectionObserverEvent(eventHandlers) || intersectionObserverThresholds != null) {
         _renderBoxModel.addIntersectionChangeListener(handleIntersectionChange);
         // Mark the compositing state for this render object as dirty
         // cause it will create new layer.
@@ -1521,6 +1549,7 @@ class Element extends Node
   }
 
   void removeEvent(String eventType) {
+    setEventPassive(eventType, true);
     if (!eventHandlers.containsKey(eventType)) return; // Only listen once.
     removeEventListener(eventType, dispatchEvent);
 
@@ -1532,7 +1561,30 @@ class Element extends Node
       }
 
       // Remove listener when no intersection related event
-      if (_isIntersectionObserverEvent(eventType) && !_hasIntersectionObserverEvent(eventHandlers)) {
+      if (_isIntersectionObserverEvent(eventType) && !_hasIntersectionObserverEvent(eventHandlers) && intersectionObserverThresholds == null) {
+        selfRenderBoxModel.removeIntersectionChangeListener(handleIntersectionChange);
+      }
+    }
+  }
+
+  // IntersectionObservers in JS observing this element, with thresholds and rootMargin of all of them.
+  void observeIntersection(List<double> thresholds, String rootMargin) {
+    intersectionObserverThresholds = thresholds;
+    _intersectionRootMargin = rootMargin;
+    resetIntersectionThresholdState();
+    renderBoxModel?.intersectionRootMargin = rootMargin;
+    _ensureEventResponderBound();
+  }
+
+  void unobserveIntersection() {
+    if (intersectionObserverThresholds == null) return;
+    intersectionObserverThresholds = null;
+    _intersectionRootMargin = null;
+
+    RenderBoxModel? selfRenderBoxModel = renderBoxModel;
+    if (selfRenderBoxModel != null) {
+      selfRenderBoxModel.intersectionRootMargin = null;
+      if (!_hasIntersectionObserverEvent(eventHandlers)) {
         selfRenderBoxModel.removeIntersectionChangeListener(handleIntersectionChange);
       }
     }
@@ -16,6 +16,32 @@ enum AppearEventType {
 mixin ElementEventMixin on ElementBase {
   AppearEventType prevAppearState = AppearEventType.none;
 
+  // Sorted thresholds of the IntersectionObservers in JS observing this element, null when not observed.
+  List<double>? intersectionObserverThresholds;
+  int _intersectionThresholdIndex = -1;
+  bool _wasIntersecting = false;
+
+  // IntersectionObservers only need to know when a threshold is crossed, other changes are not sent to JS
+  // unless there are intersectionchange listeners.
+  bool _shouldDispatchIntersectionChange(double intersectionRatio) {
+    List<double>? thresholds = intersectionObserverThresholds;
+    if (thresholds == null || eventHandlers.containsKey(EVENT_INTERSECTION_CHANGE)) return true;
+
+    int thresholdIndex = thresholds.indexWhere((threshold) => threshold > intersectionRatio);
+    if (thresholdIndex == -1) thresholdIndex = thresholds.length;
+    bool isIntersecting = intersectionRatio > 0;
+    if (thresholdIndex == _intersectionThresholdIndex && isIntersecting == _wasIntersecting) return false;
+
+    _intersectionThresholdIndex = thresholdIndex;
+    _wasIntersecting = isIntersecting;
+    return true;
+  }
+
+  void resetIntersectionThresholdState() {
+    _intersectionThresholdIndex = -1;
+    _wasIntersecting = false;
+  }
+
   void addEventResponder(RenderPointerListenerMixin renderBox) {
     renderBox.onClick = handleMouseEvent;
     renderBox.onDoubleClick = dispatchEvent;
@@ -78,7 +104,9 @@ mixin ElementEventMixin on ElementBase {
   }
 
   void handleIntersectionChange(IntersectionObserverEntry entry) {
-    dispatchEvent(IntersectionChangeEvent(entry.intersectionRatio));
+    if (_shouldDispatchIntersectionChange(entry.intersectionRatio)) {
+      dispatchEvent(IntersectionChangeEvent(entry.intersectionRatio));
+    }
     if (entry.intersectionRatio > 0) {
       handleAppear();
     } else {
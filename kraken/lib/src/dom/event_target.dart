@@ -109,6 +109,9 @@ abstract class EventTarget {
   @protected
   Map<String, List<EventHandler>> eventHandlers = {};
 
+  // Event types listened in JS by listeners which may call preventDefault().
+  final Set<String> _nonPassiveEventTypes = {};
+
   EventTarget(EventTargetContext? context) {
     if (context != null) {
       contextId = context.contextId;
@@ -143,6 +146,20 @@ abstract class EventTarget {
     }
   }
 
+  // Bridge sends whether all the JS listeners of eventType are registered with {passive: true}.
+  void setEventPassive(String eventType, bool passive) {
+    if (passive) {
+      _nonPassiveEventTypes.remove(eventType);
+    } else {
+      _nonPassiveEventTypes.add(eventType);
+    }
+  }
+
+  // Default actions such as scrolling need not wait for JS when there are only passive listeners.
+  bool hasNonPassiveEventListener(String eventType) {
+    return _nonPassiveEventTypes.contains(eventType);
+  }
+
   Map<String, List<EventHandler>> getEventHandlers() {
     return eventHandlers;
   }
@@ -158,6 +175,7 @@ abstract class EventTarget {
 
     _disposed = true;
     eventHandlers.clear();
+    _nonPassiveEventTypes.clear();
 
     if (pointer != null) {
       _nativeMap.remove(pointer!.address);
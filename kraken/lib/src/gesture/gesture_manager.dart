@@ -3,6 +3,8 @@
  * Author: Kraken Team.
  */
 
+import 'dart:async';
+
 import 'package:flutter/gestures.dart';
 import 'package:flutter/rendering.dart';
 import 'package:kraken/dom.dart';
@@ -161,7 +163,12 @@ class GestureManager {
 
       if (touchType == EVENT_TOUCH_MOVE) {
         _throttler.throttle(() {
-          currentTarget.dispatchEvent!(e);
+          if (_hasNonPassiveEventListener(currentTarget.getEventTarget!(), touchType)) {
+            currentTarget.dispatchEvent!(e);
+          } else {
+            // Passive listeners never cancel scrolling, let gestures handle the pointer before running JS.
+            scheduleMicrotask(() => currentTarget.dispatchEvent!(e));
+          }
         });
       } else {
         currentTarget.dispatchEvent!(e);
@@ -308,4 +315,14 @@ class GestureManager {
       );
     }
   }
+
+  // Look for listeners which may call preventDefault() along the propagation path in JS.
+  bool _hasNonPassiveEventListener(EventTarget target, String eventType) {
+    EventTarget? current = target;
+    while (current != null) {
+      if (current.hasNonPassiveEventListener(eventType)) return true;
+      current = current is Node ? current.parentNode : null;
+    }
+    return target is Node && target.ownerDocument.controller.view.window.hasNonPassiveEventListener(eventType);
+  }
 }
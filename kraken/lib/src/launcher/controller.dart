@@ -31,6 +31,10 @@ import 'bundle.dart';
 const int WINDOW_ID = -1;
 const int DOCUMENT_ID = -2;
 
+// Ids of other event targets are allocated densely by the bridge, the low bits
+// is the index of a slot and the high bits is the generation of the slot.
+const int _EVENT_TARGET_INDEX_MASK = (1 << 22) - 1;
+
 // Error handler when load bundle failed.
 typedef LoadHandler = void Function(KrakenController controller);
 typedef LoadErrorHandler = void Function(FlutterError error, StackTrace stack);
@@ -263,21 +267,25 @@ class KrakenViewController
     _disposed = true;
   }
 
-  Map<int, EventTarget> _eventTargets = <int, EventTarget>{};
+  // Event targets are indexed by the slot of their id, [_eventTargetIds] keeps
+  // the full id of each slot to tell a stale id from the id reusing its slot.
+  List<EventTarget?> _eventTargets = <EventTarget?>[];
+  List<int> _eventTargetIds = <int>[];
+  // Window and document have reserved negative ids.
+  Map<int, EventTarget> _reservedEventTargets = <int, EventTarget>{};
 
   T? getEventTargetById<T>(int targetId) {
     return _getEventTargetById(targetId);
   }
 
   int? getTargetIdByEventTarget(EventTarget eventTarget) {
-    if (_eventTargets.containsValue(eventTarget)) {
-      for (var entry in _eventTargets.entries) {
-        if (entry.value == eventTarget) {
-          return entry.key;
-        }
+    for (var entry in _reservedEventTargets.entries) {
+      if (entry.value == eventTarget) {
+        return entry.key;
       }
     }
-    return null;
+    int index = _eventTargets.indexOf(eventTarget);
+    return index == -1 ? null : _eventTargetIds[index];
   }
 
   // Save all WidgetElement to manager life cycle.
@@ -298,7 +306,15 @@ class KrakenViewController
   }
 
   T? _getEventTargetById<T>(int targetId) {
-    EventTarget? target = _eventTargets[targetId];
+    EventTarget? target;
+    if (targetId < 0) {
+      target = _reservedEventTargets[targetId];
+    } else {
+      int index = targetId & _EVENT_TARGET_INDEX_MASK;
+      if (index < _eventTargets.length && _eventTargetIds[index] == targetId) {
+        target = _eventTargets[index];
+      }
+    }
     if (target is T)
       return target as T;
     else
@@ -306,26 +322,48 @@ class KrakenViewController
   }
 
   bool _existsTarget(int id) {
-    return _eventTargets.containsKey(id);
+    return _getEventTargetById<EventTarget>(id) != null;
   }
 
   void _removeTarget(int targetId) {
-    if (_eventTargets.containsKey(targetId)) {
-      EventTarget? target = _eventTargets.remove(targetId);
-
-      if (target is WidgetElement) {
-        _removeWidgetElement(target);
+    EventTarget? target;
+    if (targetId < 0) {
+      target = _reservedEventTargets.remove(targetId);
+    } else {
+      int index = targetId & _EVENT_TARGET_INDEX_MASK;
+      if (index < _eventTargets.length && _eventTargetIds[index] == targetId) {
+        target = _eventTargets[index];
+        _eventTargets[index] = null;
+        _eventTargetIds[index] = -1;
       }
     }
+
+    if (target is WidgetElement) {
+      _removeWidgetElement(target);
+    }
   }
 
   void _setEventTarget(int targetId, EventTarget target) {
-    _eventTargets[targetId] = target;
+    if (targetId < 0) {
+      _reservedEventTargets[targetId] = target;
+      return;
+    }
+
+    int index = targetId & _EVENT_TARGET_INDEX_MASK;
+    if (index >= _eventTargets.length) {
+      int growth = index + 1 - _eventTargets.length;
+      _eventTargets.addAll(List<EventTarget?>.filled(growth, null));
+      _eventTargetIds.addAll(List<int>.filled(growth, -1));
+    }
+    _eventTargets[index] = target;
+    _eventTargetIds[index] = targetId;
   }
 
   void _clearTargets() {
     // Set current eventTargets to a new object, clean old targets by gc.
-    _eventTargets = <int, EventTarget>{};
+    _eventTargets = <EventTarget?>[];
+    _eventTargetIds = <int>[];
+    _reservedEventTargets = <int, EventTarget>{};
     _widgetElements.clear();
   }
 
@@ -427,13 +465,14 @@ class KrakenViewController
     }
   }
 
-  void addEvent(int targetId, String eventType) {
+  void addEvent(int targetId, String eventType, { bool passive = false }) {
     if (kProfileMode) {
       PerformanceTiming.instance()
           .mark(PERF_ADD_EVENT_START, uniqueId: targetId);
     }
     if (!_existsTarget(targetId)) return;
     EventTarget target = _getEventTargetById<EventTarget>(targetId)!;
+    target.setEventPassive(eventType, passive);
 
     if (target is Element) {
       target.addEvent(eventType);
@@ -464,6 +503,90 @@ class KrakenViewController
     }
   }
 
+  void observeIntersection(int targetId, List<double> thresholds, String rootMargin) {
+    Element? target = _getEventTargetById<Element>(targetId);
+    if (target == null) return;
+
+    target.observeIntersection(thresholds, rootMargin);
+  }
+
+  void unobserveIntersection(int targetId) {
+    Element? target = _getEventTargetById<Element>(targetId);
+    if (target == null) return;
+
+    target.unobserveIntersection();
+  }
+
+  // Elements observed by ResizeObservers in JS by targetId, with the sizes
+  // last reported to native.
+  final Map<int, Element> _resizeObservedElements = <int, Element>{};
+  final Map<int, Size> _reportedContentSizes = <int, Size>{};
+  final Map<int, Size> _reportedBorderBoxSizes = <int, Size>{};
+  bool _resizeObservationScheduled = false;
+
+  void observeResize(int targetId) {
+    Element? target = _getEventTargetById<Element>(targetId);
+    if (target == null) return;
+
+    _resizeObservedElements[targetId] = target;
+    // New observations in JS start from a zero size, report the current size again on the next frame.
+    _reportedContentSizes.remove(targetId);
+    _reportedBorderBoxSizes.remove(targetId);
+    _scheduleResizeObservation();
+    SchedulerBinding.instance!.scheduleFrame();
+  }
+
+  void unobserveResize(int targetId) {
+    _resizeObservedElements.remove(targetId);
+    _reportedContentSizes.remove(targetId);
+    _reportedBorderBoxSizes.remove(targetId);
+  }
+
+  void _scheduleResizeObservation() {
+    if (_resizeObservationScheduled) return;
+    _resizeObservationScheduled = true;
+    // Sizes are read after layout, a frame without any change reports nothing.
+    SchedulerBinding.instance!.addPostFrameCallback(_reportResizeObservations);
+  }
+
+  void _reportResizeObservations(Duration timeStamp) {
+    _resizeObservationScheduled = false;
+    if (_disposed || _resizeObservedElements.isEmpty) return;
+
+    List<int> targetIds = [];
+    List<Rect> contentRects = [];
+    List<Size> borderBoxSizes = [];
+    _resizeObservedElements.forEach((int targetId, Element target) {
+      Rect contentRect = Rect.zero;
+      Size borderBoxSize = Size.zero;
+      RenderBoxModel? renderBoxModel = target.renderBoxModel;
+      if (renderBoxModel != null && renderBoxModel.hasSize && target.isConnected) {
+        CSSRenderStyle renderStyle = target.renderStyle;
+        borderBoxSize = renderBoxModel.size;
+        contentRect = Rect.fromLTWH(
+          renderStyle.paddingLeft.computedValue,
+          renderStyle.paddingTop.computedValue,
+          renderStyle.deflatePaddingBorderWidth(borderBoxSize.width),
+          renderStyle.deflatePaddingBorderHeight(borderBoxSize.height),
+        );
+      }
+      if (_reportedContentSizes[targetId] == contentRect.size && _reportedBorderBoxSizes[targetId] == borderBoxSize) return;
+      _reportedContentSizes[targetId] = contentRect.size;
+      _reportedBorderBoxSizes[targetId] = borderBoxSize;
+      targetIds.add(targetId);
+      contentRects.add(contentRect);
+      borderBoxSizes.add(borderBoxSize);
+    });
+
+    if (targetIds.isNotEmpty) {
+      dispatchResizeObservations(_contextId, targetIds, contentRects, borderBoxSizes);
+    }
+    // Keep watching the frames to come while any element is observed.
+    if (_resizeObservedElements.isNotEmpty) {
+      _scheduleResizeObservation();
+    }
+  }
+
   void cloneNode(int originalId, int newId) {
     EventTarget originalTarget = _getEventTargetById(originalId)!;
     EventTarget newTarget = _getEventTargetById(newId)!;
@@ -482,6 +605,22 @@ class KrakenViewController
     }
   }
 
+  /// Copy nodes of a cloned subtree from their originals in tree order and
+  /// append each new node to its new parent, the root has no parent (-1).
+  void cloneNodeTree(
+      List<int> originalIds, List<int> newIds, List<int> parentIds) {
+    for (int i = 0; i < newIds.length; i++) {
+      cloneNode(originalIds[i], newIds[i]);
+      if (parentIds[i] != -1) {
+        assert(_existsTarget(parentIds[i]), 'parentId: ${parentIds[i]}');
+        Node parentNode = _getEventTargetById<Node>(parentIds[i])!;
+        parentNode.appendChild(_getEventTargetById<Node>(newIds[i])!);
+      }
+    }
+
+    _debugDOMTreeChanged();
+  }
+
   void removeNode(int targetId) {
     if (kProfileMode) {
       PerformanceTiming.instance()
@@ -554,6 +693,63 @@ class KrakenViewController
     }
   }
 
+  /// Insert all nodes of [newTargetIds] in order at [position] of the target,
+  /// which is how the children of a DocumentFragment are moved at once.
+  void insertAdjacentNodes(
+      int targetId, String position, List<int> newTargetIds) {
+    if (kProfileMode) {
+      PerformanceTiming.instance()
+          .mark(PERF_INSERT_ADJACENT_NODE_START, uniqueId: targetId);
+    }
+
+    assert(_existsTarget(targetId),
+        'targetId: $targetId position: $position newTargetIds: $newTargetIds');
+
+    Node target = _getEventTargetById<Node>(targetId)!;
+    Node? targetParentNode = target.parentNode;
+
+    // Resolve the insertion point once, each node is then inserted before it.
+    Node parentNode;
+    Node? referenceNode;
+    switch (position) {
+      case 'beforebegin':
+        parentNode = targetParentNode!;
+        referenceNode = target;
+        break;
+      case 'afterbegin':
+        parentNode = target;
+        referenceNode = target.childNodes.isEmpty ? null : target.firstChild;
+        break;
+      case 'afterend':
+        parentNode = targetParentNode!;
+        referenceNode = target.nextSibling;
+        break;
+      case 'beforeend':
+      default:
+        parentNode = target;
+        referenceNode = null;
+        break;
+    }
+
+    for (int newTargetId in newTargetIds) {
+      assert(_existsTarget(newTargetId),
+          'newTargetId: $newTargetId position: $position');
+      Node newNode = _getEventTargetById<Node>(newTargetId)!;
+      if (referenceNode == null) {
+        parentNode.appendChild(newNode);
+      } else {
+        parentNode.insertBefore(newNode, referenceNode);
+      }
+    }
+
+    _debugDOMTreeChanged();
+
+    if (kProfileMode) {
+      PerformanceTiming.instance()
+          .mark(PERF_INSERT_ADJACENT_NODE_END, uniqueId: targetId);
+    }
+  }
+
   void setProperty(int targetId, String key, dynamic value) {
     if (kProfileMode) {
       PerformanceTiming.instance()
@@ -689,12 +885,22 @@ class KrakenViewController
     }
   }
 
+  /// The bridge reuses this element for a new one of the same tag name.
+  void resetElement(int targetId) {
+    Element? target = _getEventTargetById<Element>(targetId);
+    if (target == null) return;
+
+    unobserveResize(targetId);
+    target.reset();
+  }
+
   // Call from JS Bridge before JS side eventTarget object been Garbage collected.
   void disposeEventTarget(int targetId) {
     Node? target = _getEventTargetById<Node>(targetId);
     if (target == null) return;
 
     _removeTarget(targetId);
+    unobserveResize(targetId);
     target.dispose();
   }
 
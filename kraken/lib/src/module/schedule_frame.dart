@@ -3,12 +3,21 @@
  * Author: Kraken Team.
  */
 
+import 'dart:async';
+import 'dart:developer' show Timeline;
+import 'dart:math' as math;
 
 import 'package:flutter/scheduler.dart';
 
 typedef DoubleCallback = void Function(double);
 typedef VoidCallback = void Function();
 
+// Budget of a frame at 60fps, idle periods take what the frame left of it.
+const double _frameBudget = 1000 / 60;
+// Idle periods are limited to 50ms when no frame is pending, to keep the page responsive to new input.
+// https://w3c.github.io/requestidlecallback/#why50
+const double _maxIdlePeriod = 50;
+
 mixin ScheduleFrameMixin {
   int _id = 1;
   final Map<int, bool> _animationFrameCallbackMap = {};
@@ -33,11 +42,42 @@ mixin ScheduleFrameMixin {
     }
   }
 
+  bool _isIdlePeriodScheduled = false;
+  final List<DoubleCallback> _idlePeriodCallbacks = [];
+
+  // Idle periods start after the frame is drawn, the UI commands of JS are flushed by then.
+  // The callback receives how many milliseconds are left to idle.
+  void requestIdlePeriod(DoubleCallback callback) {
+    _idlePeriodCallbacks.add(callback);
+    if (_isIdlePeriodScheduled) return;
+    _isIdlePeriodScheduled = true;
+
+    SchedulerBinding scheduler = SchedulerBinding.instance!;
+    if (scheduler.hasScheduledFrame || scheduler.schedulerPhase != SchedulerPhase.idle) {
+      scheduler.addPostFrameCallback((Duration timeStamp) {
+        double elapsed = (Timeline.now - scheduler.currentSystemFrameTimeStamp.inMicroseconds) / 1000;
+        _startIdlePeriod(math.max(_frameBudget - elapsed, 0));
+      });
+    } else {
+      Timer.run(() => _startIdlePeriod(_maxIdlePeriod));
+    }
+  }
+
+  void _startIdlePeriod(double timeRemaining) {
+    _isIdlePeriodScheduled = false;
+    List<DoubleCallback> callbacks = List.of(_idlePeriodCallbacks);
+    _idlePeriodCallbacks.clear();
+    for (DoubleCallback callback in callbacks) {
+      callback(timeRemaining);
+    }
+  }
+
   void requestBatchUpdate() {
     SchedulerBinding.instance!.scheduleFrame();
   }
 
   void disposeScheduleFrame() {
     _animationFrameCallbackMap.clear();
+    _idlePeriodCallbacks.clear();
   }
 }
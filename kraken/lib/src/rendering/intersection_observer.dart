@@ -33,6 +33,15 @@ mixin RenderIntersectionObserverMixin on RenderBox {
   /// A list of event handlers
   List<IntersectionChangeCallback>? _listeners;
 
+  /// Margin added around the root bounds, as four lengths in px or % of the viewport in
+  /// `top right bottom left` order. Set by IntersectionObservers in JS.
+  String? _intersectionRootMargin;
+  set intersectionRootMargin(String? value) {
+    if (value == _intersectionRootMargin) return;
+    _intersectionRootMargin = value;
+    _intersectionObserverLayer.layer?.rootMargin = value;
+  }
+
   void disposeIntersectionObserverLayer() {
     _intersectionObserverLayer.layer = null;
   }
@@ -89,6 +98,7 @@ mixin RenderIntersectionObserverMixin on RenderBox {
       _intersectionObserverLayer.layer = IntersectionObserverLayer(
           elementSize: size,
           paintOffset: offset,
+          rootMargin: _intersectionRootMargin,
           onIntersectionChange: _onIntersectionChange!
       );
     } else {
@@ -104,6 +114,7 @@ class IntersectionObserverLayer extends ContainerLayer {
   IntersectionObserverLayer(
       {required Size elementSize,
       required Offset paintOffset,
+      this.rootMargin,
       required this.onIntersectionChange})
       : // TODO: This is zero for box element. For sliver element, this offset points to the start of the element which may be outside the viewport.
         _elementOffset = Offset.zero,
@@ -144,6 +155,9 @@ class IntersectionObserverLayer extends ContainerLayer {
 
   final IntersectionChangeCallback onIntersectionChange;
 
+  /// Margin added around the root bounds, see [RenderIntersectionObserverMixin.intersectionRootMargin].
+  String? rootMargin;
+
   /// Keeps track of the last known visibility state of a element.
   ///
   /// This is used to suppress extraneous callbacks when visibility hasn't
@@ -284,7 +298,27 @@ class IntersectionObserverLayer extends ContainerLayer {
       parentLayer = parentLayer.parent;
     }
 
-    return clipRect;
+    return _applyRootMargin(clipRect);
+  }
+
+  Rect _applyRootMargin(Rect rootBounds) {
+    String? margin = rootMargin;
+    if (margin == null) return rootBounds;
+
+    Size viewportSize = RendererBinding.instance!.renderView.size;
+    List<String> sides = margin.split(' ');
+    double resolve(String length, double percentBase) {
+      if (length.endsWith('%')) {
+        return double.parse(length.substring(0, length.length - 1)) * percentBase / 100;
+      }
+      return double.parse(length.substring(0, length.length - 2));
+    }
+    return Rect.fromLTRB(
+      rootBounds.left - resolve(sides[3], viewportSize.width),
+      rootBounds.top - resolve(sides[0], viewportSize.height),
+      rootBounds.right + resolve(sides[1], viewportSize.width),
+      rootBounds.bottom + resolve(sides[2], viewportSize.height),
+    );
   }
 
   /// Invokes the visibility callback if [IntersectionObserverEntry] hasn't meaningfully